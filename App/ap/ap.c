@@ -19,6 +19,9 @@ static void apply_mode_button_mask(mode_sw_t m, bool calib_active);
 
 void ap_init(void)
 {
+	// micros() 기준 카운터: I2C 타임아웃이 이걸 쓰므로 주변장치 init보다 먼저
+	HAL_TIM_Base_Start_IT(&htim2);
+
 	i2c_init();
 	uart_init();
 
@@ -37,6 +40,7 @@ void ap_init(void)
 
 	card_prog_init();
 	card_action_init();
+	lp_keep_restore();                  // Standby 전 프로그램 (버튼/카드)
 
 
 	step_init_all();
@@ -44,13 +48,35 @@ void ap_init(void)
 //	s_current_op = OP_STOP;
 //    step_drive(s_current_op);
 
-	HAL_TIM_Base_Start_IT(&htim2);
 	HAL_TIM_Base_Start_IT(&htim4);
 	HAL_TIM_Base_Start_IT(&htim6);
 
+	kv_init();                          // 색 reference/튜닝 값 인덱스
 	load_color_reference_table();
 	calculate_color_brightness_offset();
+
+	// BLACK/WHITE reference 로드 후에 (라인 위치 정규화)
+	const lt_config_t lt_cfg =
+	{
+		.Kp = LT_DEFAULT_KP, .Ki = LT_DEFAULT_KI, .Kd = LT_DEFAULT_KD,
+		.base_ticks = LT_DEFAULT_BASE_TICKS, .fast_ticks = LT_DEFAULT_FAST_TICKS,
+		.min_ticks = LT_DEFAULT_MIN_TICKS,
+		.max_ticks = LT_DEFAULT_MAX_TICKS, .interval_ms = LT_DEFAULT_INTERVAL_MS,
+	};
+	line_tracing_init(&lt_cfg);
+
 	debug_print_color_reference_table();
+	debug_print_color_stats();
+	debug_print_color_drift();
+	debug_print_color_ccm();
+	debug_print_color_bus_stats();
+
+#if (_USE_COLOR_SELFTEST == 1)
+	color_cls_selftest(2000);
+#endif
+#if (_USE_COLOR_BENCH == 1)
+	color_bench_main();
+#endif
 }
 
 
@@ -59,6 +85,7 @@ void ap_main(void)
 {
 	mode_sw_t cur_mode = mode_sw_get();
 	bool prev_calib_active = color_calib_is_active();
+	uint32_t card_frame_seq = 0;
 
 	apply_mode_button_mask(cur_mode, prev_calib_active);
 
@@ -73,6 +100,8 @@ void ap_main(void)
             uart_printf("[MODE] %s\r\n", mode_sw_name(cur_mode));
             // ★ 여기서만 한 번
 			card_prog_set_mode(cur_mode);
+			if (cur_mode != MODE_LINE_TRACING)
+				line_tracing_enable(false);
         }
 
         // --- 캘리 상태 변화 처리 ---
@@ -90,27 +119,63 @@ void ap_main(void)
         {
             if (btn_pop_long_press(BTN_FORWARD, 3000))   // 3000ms
             {
+                line_tracing_enable(false);
                 color_calib_enter();
                 apply_mode_button_mask(cur_mode, true);  // 캘리 중 버튼 제한(선택)
-                flash_erase_color_table(BH1749_ADDR_LEFT);
-				flash_erase_color_table(BH1749_ADDR_RIGHT);
                 // 현재 타깃 안내
                 int idx = color_calib_index();
                 int tot = color_calib_total();
                 color_t tgt = color_calib_current_target();
                 uart_printf("[CAL] enter %d/%d, target=%d\r\n", idx + 1, tot, (int)tgt);
             }
+
+            // 3초 길게 DELETE → PID 자동 튜닝 (라인 위에 올려두고)
+            if (btn_pop_long_press(BTN_DELETE, 3000))
+            {
+                line_tracing_autotune();
+            }
+
+            // 3초 길게 RESUME → 다음 캘리 프로필 (매트 교체). 주행 중엔 팝하지 않음 → 떼면 정지
+            if (!line_tracing_enabled() && btn_pop_long_press(BTN_RESUME, 3000))
+            {
+                color_calib_next_profile();
+            }
         }
 
         // --- 카드 모드에 센서 피드 (양쪽 동일일 때만 큐잉) ---
 		if (cur_mode == MODE_CARD && !now_calib_active)
 		{
-			uint8_t left  = classify_color_side(BH1749_ADDR_LEFT);
-			uint8_t right = classify_color_side(BH1749_ADDR_RIGHT);
-			card_prog_on_dual_equal(left, right);   // 동일 색만 enqueue/반복 처리
+			color_result_t left  = classify_color_side_ex(BH1749_ADDR_LEFT);
+			color_result_t right = classify_color_side_ex(BH1749_ADDR_RIGHT);
+			// 한쪽 센서 고장이면 남은 쪽 결과로 양쪽을 채움 (둘 다 고장이면 UNKNOWN → 카드 인식 안 됨)
+			if (!color_health_usable(BH1749_ADDR_LEFT))  left  = right;
+			if (!color_health_usable(BH1749_ADDR_RIGHT)) right = left;
+
+			// 투표는 새 변환에서만 (루프가 변환보다 훨씬 빨라 같은 프레임이 여러 표가 되지 않게)
+			// 둘 다 고장이면 새 프레임이 없으므로 매번 "없음" 표 → 제시 중 카드 제거
+			uint8_t  ref_dev = color_health_usable(BH1749_ADDR_LEFT) ? BH1749_ADDR_LEFT : BH1749_ADDR_RIGHT;
+			uint32_t seq     = color_frame_seq(ref_dev);
+			if (seq != card_frame_seq || !color_health_usable(ref_dev))
+			{
+				card_frame_seq = seq;
+				card_prog_on_samples(left.cls, left.conf, right.cls, right.conf);   // 투표 필터 → 제시 이벤트만 enqueue/반복 처리
+			}
 //			card_prog_service();
 		}
 
+        // --- 캘리 샘플 수집 (FORWARD 클릭 후 CALIB_SAMPLES개) ---
+        color_calib_process();
+
+        // --- 센서 상태 감시 (VALID/I2C 에러율) ---
+        color_health_service();
+
+        // --- LED 스트로브 + 주변광 차감 (켜져 있을 때만) ---
+        color_strobe_service();
+
+        // --- reference 드리프트 반영/지연 저장 (적응 모드일 때만 동작) ---
+        if (!now_calib_active)
+            color_drift_service();
+
         btn_id_t pressed;
         // [PATCH] 루프 기본값: 항상 STOP
 		if(btn_pop_any_press(&pressed))
@@ -156,6 +221,21 @@ void ap_main(void)
 							break;
 					}
 				}
+				else if (cur_mode == MODE_LINE_TRACING)
+				{
+					// GO = 출발, RESUME = 정지, DELETE = 제어 주기 통계 출력/초기화
+					switch (pressed)
+					{
+						case BTN_GO:     line_tracing_enable(true);  break;
+						case BTN_RESUME: line_tracing_enable(false); break;
+						case BTN_DELETE:
+							line_tracing_print_stats();
+							line_tracing_reset_stats();
+							break;
+						default:
+							break;
+					}
+				}
 				else if (cur_mode == MODE_CARD)
 				{
 					// ★ 카드 큐: 실행 제어만 버튼으로 받는다
@@ -180,6 +260,12 @@ void ap_main(void)
 		    btn_prog_service(cur_mode, false);
 		}
 
+		if (!color_calib_is_active() && cur_mode == MODE_LINE_TRACING)
+		{
+			// 타이머가 릴리스한 제어 주기에만 실행 (200 Hz)
+			line_tracing_service();
+		}
+
 		if (!color_calib_is_active() && cur_mode == MODE_CARD)
 		{
 			// 버튼 모드가 아니거나 캘리 중이면 내부에서 STOP+PAUSE 처리됨
@@ -212,6 +298,10 @@ void ap_main(void)
 
 static void apply_mode_button_mask(mode_sw_t m, bool calib_active)
 {
+	// 라인트레이싱은 DELETE/RESUME/FORWARD에 3초 길게 누름 기능이 같이 있어 짧은 누름은 뗄 때 처리
+	// (눌림 엣지에 처리하면 길게 누르기 전에 정지/통계 초기화가 먼저 실행됨)
+	btn_release_mask_set((m == MODE_LINE_TRACING && !calib_active) ? BTN_MASK_LINE : 0u);
+
 	// 캘리브레이션 중에는 FORWARD만 쓰고 싶다면 여기에서 별도 마스크로 잠글 수도 있음
 	if (calib_active)
 	{
@@ -235,3 +325,9 @@ static void apply_mode_button_mask(mode_sw_t m, bool calib_active)
 			break;
 	}
 }
+
+// lp_stby 훅 오버라이드: Standby 진입 직전 (TIM6 ISR 문맥 → 레지스터 쓰기만)
+void lp_stby_prepare_before(void)
+{
+	lp_keep_save();
+}
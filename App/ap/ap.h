@@ -19,17 +19,27 @@
 #include "rgb.h"
 #include "btn.h"
 #include "color.h"
+#include "color_cls.h"
+#include "color_stats.h"
+#include "color_drift.h"
+#include "color_ccm.h"
+#include "color_strobe.h"
+#include "color_health.h"
+#include "color_bench.h"
 #include "calib.h"
 #include "flash.h"
+#include "flash_kv.h"
 #include "mode_sw.h"
 #include "btn_prog.h"
 #include "btn_action.h"
 #include "card_prog.h"
 #include "card_action.h"
+#include "line_tracing.h"
 #include "rgb_actions.h"
 
 
 #include "lp_stby.h"
+#include "lp_keep.h"
 #include "stepper.h"
 
 
@@ -12,6 +12,7 @@
 #include "stepper.h"
 #include "lp_stby.h"
 #include "mode_sw.h"
+#include "line_tracing.h"
 
 
 
@@ -35,4 +36,5 @@ void ap_tim6_callback(void)//1ms timer
 	btn_update_1ms();
 	lp_stby_on_1ms();
 	mode_sw_update_1ms();
+	line_tracing_tick_1ms();
 }
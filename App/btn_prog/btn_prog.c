@@ -43,6 +43,18 @@ static inline void drive_if_changed(StepOperation op)
     }
 }
 
+static uint32_t op_steps(StepOperation op)
+{
+    switch (op)
+    {
+        case OP_FORWARD:    return BTN_PROG_STEPS_FORWARD;
+        case OP_REVERSE:    return BTN_PROG_STEPS_BACKWARD;
+        case OP_TURN_LEFT:  return BTN_PROG_STEPS_TURN_LEFT;
+        case OP_TURN_RIGHT: return BTN_PROG_STEPS_TURN_RIGHT;
+        default:            return 0;
+    }
+}
+
 static bool enqueue(StepOperation op, uint32_t steps)
 {
     if (s_len >= BTN_PROG_MAX_LEN)
@@ -262,3 +274,33 @@ uint8_t btn_prog_get_index(void)
 {
     return s_idx;
 }
+
+uint8_t btn_prog_export(uint8_t *ops, uint8_t max)
+{
+    uint8_t n = (s_len < max) ? s_len : max;
+
+    for (uint8_t i = 0; i < n; i++)
+        ops[i] = (uint8_t)s_buf[i].op;
+    return n;
+}
+
+bool btn_prog_import(const uint8_t *ops, uint8_t len)
+{
+    if (len > BTN_PROG_MAX_LEN)
+        return false;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (op_steps((StepOperation)ops[i]) == 0)
+            return false;
+    }
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        s_buf[i].op           = (StepOperation)ops[i];
+        s_buf[i].target_steps = op_steps((StepOperation)ops[i]);
+    }
+    s_len   = len;
+    s_idx   = 0;
+    s_state = BTN_PROG_IDLE;
+    return true;
+}
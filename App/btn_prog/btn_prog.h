@@ -53,6 +53,10 @@ btn_prog_state_t btn_prog_get_state(void);
 uint8_t          btn_prog_get_len(void);
 uint8_t          btn_prog_get_index(void); // 0..len-1 (RUNNING일 때만 의미)
 
+// 대기 모드 유지용 저장/복원: 동작 코드(StepOperation)만, 스텝 수는 동작으로 정해짐
+uint8_t          btn_prog_export(uint8_t *ops, uint8_t max);
+bool             btn_prog_import(const uint8_t *ops, uint8_t len);   // 모르는 코드가 있으면 false (버퍼 그대로)
+
 
 
 #endif /* BTN_PROG_BTN_PROG_H_ */
@@ -8,13 +8,28 @@
 
 #include "calib.h"
 #include "color.h"
+#include "color_cal.h"
+#include "color_lut.h"
+#include "color_stats.h"
+#include "color_ccm.h"
+#include "color_ae.h"
 #include "uart.h"
 
+#include <math.h>
+
 
 /* 내부 상태 */
 static calib_state_t s_calib = CALIB_IDLE;
 static int           s_calib_idx = 0;
 
+/* 현재 색의 샘플 누적 [0]=LEFT, [1]=RIGHT */
+static color_stats_acc_t s_acc[2];
+static uint32_t          s_ir_sum[2];
+static uint32_t          s_sample_ms;       // 마지막 확인 시각
+static uint32_t          s_frame_ms;        // 마지막으로 샘플을 넣은 시각
+static uint32_t          s_frame_seq[2];    // 마지막으로 넣은 변환 (color_frame_seq)
+static uint32_t          s_read_fail;
+
 static const color_t s_calib_order[] =
 {
     COLOR_RED, COLOR_ORANGE, COLOR_YELLOW, COLOR_GREEN,
@@ -29,6 +44,7 @@ void calib_enter(void)
 {
     s_calib     = CALIB_ACTIVE;
     s_calib_idx = 0;
+    color_stats_reset();
     uart_printf("[CAL] enter (total %d colors)\r\n", CALIB_COUNT);
 }
 
@@ -40,7 +56,7 @@ void calib_exit(void)
 
 void calib_prompt_current(void)
 {
-    if (s_calib != CALIB_ACTIVE)
+    if (s_calib == CALIB_IDLE)
         return;
 
     uart_printf("[CAL] show color %d/%d: %d\r\n",
@@ -52,48 +68,143 @@ void calib_on_forward_click(void)
     if (s_calib != CALIB_ACTIVE)
         return;
 
-//    color_t target = s_calib_order[s_calib_idx];
+    // 샘플 수집 시작 → 실제 읽기는 calib_process()에서
+    color_stats_acc_reset(&s_acc[0]);
+    color_stats_acc_reset(&s_acc[1]);
+    s_ir_sum[0]  = s_ir_sum[1] = 0;
+    s_read_fail  = 0;
+    s_sample_ms  = millis() - CALIB_POLL_MS;
+    s_frame_ms   = millis();
+    s_calib      = CALIB_SAMPLING;
 
-    // 한 단계 진행을 외부 태스크에 위임
-//    ap_task_color_calibration();
+    // 클릭 전에 끝난 변환은 쓰지 않는다
+    s_frame_seq[0] = color_frame_seq(BH1749_ADDR_LEFT);
+    s_frame_seq[1] = color_frame_seq(BH1749_ADDR_RIGHT);
 
-    bh1749_color_data_t left  = bh1749_read_rgbir(BH1749_ADDR_LEFT);
-	bh1749_color_data_t right = bh1749_read_rgbir(BH1749_ADDR_RIGHT);
+    uart_printf("[CAL] sampling [%s] x%d ...\r\n", color_to_string(s_calib_idx), CALIB_SAMPLES);
+}
+
+static void calib_store_current(void)
+{
+    const uint8_t addr[2] = { BH1749_ADDR_LEFT, BH1749_ADDR_RIGHT };
 
 	uart_printf("---------------------------------------------------------------\r\n");
 
 	uart_printf("color set: [%s]\r\n", color_to_string(s_calib_idx));
 
-	uart_printf("[LEFT]  R:%u G:%u B:%u C:%u\r\n",
-				left.red, left.green, left.blue, left.ir);
-
-	uart_printf("[RIGHT] R:%u G:%u B:%u C:%u\r\n",
-				right.red, right.green, right.blue, right.ir);
-
-	save_color_reference(BH1749_ADDR_LEFT,  s_calib_idx, left.red, left.green, left.blue);
-	save_color_reference(BH1749_ADDR_RIGHT, s_calib_idx, right.red, right.green, right.blue);
+    for (int s = 0; s < 2; s++)
+    {
+        const color_stats_acc_t *a = &s_acc[s];
+        uint16_t r  = (uint16_t)(a->mean[0] + 0.5);
+        uint16_t g  = (uint16_t)(a->mean[1] + 0.5);
+        uint16_t b  = (uint16_t)(a->mean[2] + 0.5);
+        uint16_t ir = (uint16_t)(s_ir_sum[s] / a->n);
+        // 샘플 RMS 편차 (평균까지 RGB 거리), 클래스 통계로 함께 저장
+        double   var = (a->m2[0] + a->m2[1] + a->m2[2]) / a->n;
+        uint16_t sd  = (uint16_t)fmin(sqrt(var) + 0.5, 65535.0);
+
+        uart_printf("[%s] R:%u G:%u B:%u C:%u (n=%lu)\r\n", s == 0 ? "LEFT " : "RIGHT",
+                    r, g, b, ir, (unsigned long)a->n);
+
+        // 평균 → reference(다른 분류 모드용), 평균/공분산 → 마할라노비스 통계
+        save_color_reference(addr[s], s_calib_idx, r, g, b, ir, a->n, sd);
+        if (!color_stats_fit(addr[s], (color_t)s_calib_idx, a))
+            uart_printf("[CAL] %s stats fit failed\r\n", s == 0 ? "LEFT" : "RIGHT");
+    }
 
 	s_calib_idx++;
 
     if (s_calib_idx >= CALIB_COUNT)
     {
         calib_exit();
+        // blob 먼저: 실패하면 통계 페이지도 건드리지 않아 이전 캘리 한 벌이 그대로 남는다
+        if (color_reference_commit())
+            color_stats_commit();
+        else
+            uart_printf("[CAL] reference save failed (previous calibration kept)\r\n");
         load_color_reference_table();
+#if (_USE_COLOR_LUT == 1)
+        // reference가 바뀌면 LUT 해시 불일치로 해제됨 → 다시 생성
+        color_lut_refresh();
+#endif
         debug_print_color_reference_table();
+        debug_print_color_cal();
+        debug_print_color_stats();
+        debug_print_color_ccm();
     }
     else
     {
+        s_calib = CALIB_ACTIVE;
         calib_prompt_current();
     }
 
     uart_printf("---------------------------------------------------------------\r\n");
 }
 
+void calib_process(void)
+{
+    if (s_calib != CALIB_SAMPLING)
+        return;
+
+    if (millis() - s_sample_ms < CALIB_POLL_MS)
+        return;
+    s_sample_ms = millis();
+
+    bh1749_color_data_t left, right;
+    i2c_status_t st_l = bh1749_read(BH1749_ADDR_LEFT,  &left);
+    i2c_status_t st_r = bh1749_read(BH1749_ADDR_RIGHT, &right);
+
+    if (st_l != I2C_OK || st_r != I2C_OK)
+    {
+        // 버스 에러 값은 누적하지 않는다. 계속 실패하면 같은 색으로 다시 클릭
+        if (++s_read_fail >= CALIB_READ_FAIL_MAX)
+        {
+            uart_printf("[CAL] sensor read failed (L:%s R:%s), retry\r\n",
+                        i2c_status_str(st_l), i2c_status_str(st_r));
+            s_calib = CALIB_ACTIVE;
+            calib_prompt_current();
+        }
+        return;
+    }
+    s_read_fail = 0;
+
+    // 양쪽 모두 새 변환일 때만 (긴 노출/스트로브에서 같은 프레임 중복 → 공분산 과소 추정 방지)
+    uint32_t seq_l = color_frame_seq(BH1749_ADDR_LEFT);
+    uint32_t seq_r = color_frame_seq(BH1749_ADDR_RIGHT);
+    if (seq_l == s_frame_seq[0] || seq_r == s_frame_seq[1])
+    {
+        if (millis() - s_frame_ms >= CALIB_FRAME_TIMEOUT_MS)
+        {
+            uart_printf("[CAL] no new conversion for %lu ms, retry\r\n", (unsigned long)CALIB_FRAME_TIMEOUT_MS);
+            s_calib = CALIB_ACTIVE;
+            calib_prompt_current();
+        }
+        return;
+    }
+    s_frame_seq[0] = seq_l;
+    s_frame_seq[1] = seq_r;
+    s_frame_ms     = millis();
+
+#if (_USE_COLOR_AE == 1)
+    // 노출 전환 중엔 bh1749_read가 직전 정규화 값을 돌려준다 → 새 값이 아님
+    if (color_ae_settling(BH1749_ADDR_LEFT) || color_ae_settling(BH1749_ADDR_RIGHT))
+        return;
+#endif
+
+    color_stats_acc_add(&s_acc[0], left.red,  left.green,  left.blue);
+    color_stats_acc_add(&s_acc[1], right.red, right.green, right.blue);
+    s_ir_sum[0] += left.ir;
+    s_ir_sum[1] += right.ir;
+
+    if (s_acc[0].n >= CALIB_SAMPLES)
+        calib_store_current();
+}
+
 /* --- 보조 getter ------------------------------------------------------- */
 
 bool calib_is_active(void)
 {
-    return (s_calib == CALIB_ACTIVE);
+    return (s_calib != CALIB_IDLE);
 }
 
 int calib_total(void)
@@ -108,12 +219,27 @@ int calib_index(void)
 
 color_t calib_current_target(void)
 {
-    if (s_calib != CALIB_ACTIVE)
+    if (s_calib == CALIB_IDLE)
         return (color_t)(-1);
     return s_calib_order[s_calib_idx];
 }
 
 /* --- 선택: 1ms 주기 필요 시 ------------------------------------------- */
+bool calib_next_profile(void)
+{
+    uint8_t next = (uint8_t)((color_cal_active() + 1u) % COLOR_CAL_PROFILES);
+
+    if (calib_is_active() || !color_reference_use_profile(next))
+    {
+        uart_printf("[CAL] profile switch failed\r\n");
+        return false;
+    }
+
+    debug_print_color_cal();
+    debug_print_color_reference_table();
+    return true;
+}
+
 void calib_update_1ms(void)
 {
     // 타임아웃/가이드 LED 등이 필요하면 여기 구현
@@ -152,6 +278,16 @@ void color_calib_update_1ms(void)
     calib_update_1ms();
 }
 
+void color_calib_process(void)
+{
+    calib_process();
+}
+
+bool color_calib_next_profile(void)
+{
+    return calib_next_profile();
+}
+
 int color_calib_total(void)
 {
     return calib_total();
@@ -13,10 +13,20 @@
 #include "rgb.h"
 
 
+// 색마다 모으는 샘플 수 = 양쪽 모두 새로 끝난 변환 수 (같은 변환을 두 번 넣지 않음)
+#ifndef CALIB_SAMPLES
+#define CALIB_SAMPLES           24
+#endif
+#define CALIB_POLL_MS           5U      // 새 변환 확인 간격
+#define CALIB_FRAME_TIMEOUT_MS  1000U   // 이 동안 새 변환이 없으면 해당 색 재시도 (240ms 노출 ×4)
+#define CALIB_READ_FAIL_MAX     10U     // 한 색에서 연속 실패 시 해당 색 재시도
+
+
 typedef enum
 {
     CALIB_IDLE = 0,
-    CALIB_ACTIVE
+    CALIB_ACTIVE,       // 다음 색 클릭 대기
+    CALIB_SAMPLING      // 샘플 수집 중 (카드를 천천히 밀어도 됨)
 } calib_state_t;
 
 void color_calib_init(void);
@@ -24,12 +34,17 @@ void color_calib_enter(void);     // 진입 (LINE_TRACING + FORWARD 3s long)
 void color_calib_exit(void);      // 강제 종료(옵션)
 bool color_calib_is_active(void);
 
-// 짧은 클릭으로 한 단계 진행(색 샘플링 & 저장)
+// 짧은 클릭으로 한 단계 진행(색 샘플링 시작)
 void color_calib_on_forward_click(void);
+// 메인 루프에서 매번 호출: 샘플링 중이면 새 변환마다 누적, N개가 모이면 저장/다음 색
+void color_calib_process(void);
 
 // 필요 시 1ms 주기 업데이트(타임아웃/가이드 LED 등)
 void color_calib_update_1ms(void);
 
+// 다음 캘리 프로필로 전환 (매트 교체, LINE_TRACING + RESUME 3s long). 비어 있으면 기본값 → 캘리 후 그 프로필에 저장
+bool color_calib_next_profile(void);
+
 // 진행률/현재 타깃 색 질의 (UI/로깅 목적)
 int  color_calib_total(void);
 int  color_calib_index(void);
@@ -0,0 +1,162 @@
+/*
+ * card_detect.c
+ *
+ *  카드 인식용 시간 투표 필터
+ */
+
+#include "card_detect.h"
+
+
+#define VOTE_NONE   ((uint8_t)COLOR_COUNT)
+
+typedef struct
+{
+    uint8_t cls;        // color_t, VOTE_NONE = 없음
+    uint8_t w;          // 가중치(좌+우 신뢰도)
+} vote_t;
+
+static vote_t   s_win[CARD_DET_WIN];
+static uint8_t  s_head = 0;
+static uint8_t  s_fill = 0;
+static uint16_t s_score[COLOR_COUNT + 1];
+static uint16_t s_total = 0;
+
+static color_t  s_cur  = COLOR_COUNT;       // 제시 중인 카드
+static color_t  s_cand = COLOR_COUNT;       // 제시 후보
+static uint8_t  s_cand_run = 0;             // 후보 유지 변환 수
+static uint8_t  s_exit_run = 0;             // 제거 조건 유지 변환 수
+static uint8_t  s_fast_cls = VOTE_NONE;     // 연속 고신뢰 표의 색
+static uint8_t  s_fast_run = 0;
+
+
+static inline uint8_t share_pct(uint8_t cls)
+{
+    return (s_total == 0) ? 0 : (uint8_t)((s_score[cls] * 100u) / s_total);
+}
+
+void card_detect_reset(void)
+{
+    memset(s_win,   0, sizeof(s_win));
+    memset(s_score, 0, sizeof(s_score));
+    s_head  = 0;
+    s_fill  = 0;
+    s_total = 0;
+
+    s_cur  = COLOR_COUNT;
+    s_cand = COLOR_COUNT;
+    s_cand_run = 0;
+    s_exit_run = 0;
+    s_fast_cls = VOTE_NONE;
+    s_fast_run = 0;
+}
+
+card_evt_t card_detect_push(uint8_t left, uint8_t left_conf,
+                            uint8_t right, uint8_t right_conf,
+                            color_t *out_color)
+{
+    vote_t v = { VOTE_NONE, CARD_DET_NONE_WEIGHT };
+
+    if (left < COLOR_COUNT && left == right &&
+        left_conf >= CARD_DET_MIN_CONF && right_conf >= CARD_DET_MIN_CONF)
+    {
+        v.cls = left;
+        v.w   = (uint8_t)(left_conf + right_conf);
+    }
+
+    // 고신뢰 표가 같은 색으로 FAST_N 변환 연속이면 바로 제시 (한 프레임 오분류로는 안 됨).
+    // 창을 이 표로 채워 직후 제거 판정이 나지 않게 한다
+    bool fast = (v.cls != VOTE_NONE &&
+                 left_conf >= CARD_DET_FAST_CONF && right_conf >= CARD_DET_FAST_CONF);
+    if (!fast)
+        s_fast_run = 0;
+    else if (v.cls == s_fast_cls && s_fast_run != 0)
+        s_fast_run = (uint8_t)((s_fast_run < 0xFFu) ? s_fast_run + 1u : 0xFFu);
+    else
+        s_fast_run = 1;
+    s_fast_cls = v.cls;
+
+    if (s_cur == COLOR_COUNT && fast && s_fast_run >= CARD_DET_FAST_N)
+    {
+        memset(s_score, 0, sizeof(s_score));
+        for (uint8_t i = 0; i < CARD_DET_WIN; i++)
+            s_win[i] = v;
+        s_head  = 0;
+        s_fill  = CARD_DET_WIN;
+        s_score[v.cls] = (uint16_t)(v.w * CARD_DET_WIN);
+        s_total        = s_score[v.cls];
+
+        s_cur  = (color_t)v.cls;
+        s_cand = COLOR_COUNT;
+        s_exit_run = 0;
+        if (out_color) *out_color = s_cur;
+        return CARD_EVT_PRESENTED;
+    }
+
+    // 창 갱신 (가장 오래된 표 제거 → 새 표 추가)
+    if (s_fill == CARD_DET_WIN)
+    {
+        const vote_t *old = &s_win[s_head];
+        s_score[old->cls] -= old->w;
+        s_total           -= old->w;
+    }
+    else
+    {
+        s_fill++;
+    }
+    s_win[s_head] = v;
+    s_head = (uint8_t)((s_head + 1u) % CARD_DET_WIN);
+    s_score[v.cls] += v.w;
+    s_total        += v.w;
+
+    if (s_fill < CARD_DET_WIN)
+        return CARD_EVT_NONE;
+
+    if (s_cur == COLOR_COUNT)
+    {
+        uint8_t leader = 0;
+        for (uint8_t c = 1; c < COLOR_COUNT; c++)
+        {
+            if (s_score[c] > s_score[leader])
+                leader = c;
+        }
+
+        if (share_pct(leader) < CARD_DET_ENTER_PCT)
+        {
+            s_cand = COLOR_COUNT;
+            return CARD_EVT_NONE;
+        }
+
+        if (s_cand != (color_t)leader)
+        {
+            s_cand     = (color_t)leader;
+            s_cand_run = 0;
+        }
+        if (++s_cand_run < CARD_DET_DWELL)
+            return CARD_EVT_NONE;
+
+        s_cur  = s_cand;
+        s_cand = COLOR_COUNT;
+        s_exit_run = 0;
+        if (out_color) *out_color = s_cur;
+        return CARD_EVT_PRESENTED;
+    }
+
+    if (share_pct(s_cur) >= CARD_DET_EXIT_PCT)
+    {
+        s_exit_run = 0;
+        return CARD_EVT_NONE;
+    }
+
+    if (++s_exit_run < CARD_DET_DWELL)
+        return CARD_EVT_NONE;
+
+    if (out_color) *out_color = s_cur;
+    s_cur = COLOR_COUNT;
+    s_exit_run = 0;
+    return CARD_EVT_REMOVED;
+}
+
+color_t card_detect_current(void)
+{
+    return s_cur;
+}
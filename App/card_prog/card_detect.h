@@ -0,0 +1,51 @@
+/*
+ * card_detect.h
+ *
+ *  카드 인식용 시간 투표 필터
+ *
+ *  좌/우 분류 결과를 최근 N개 변환 창에 신뢰도 가중으로 쌓고,
+ *  - 한 색의 점유율이 ENTER 이상으로 DWELL 변환 동안 유지되면 "제시(PRESENTED)"
+ *  - 현재 카드 점유율이 EXIT 미만으로 DWELL 변환 동안 유지되면 "제거(REMOVED)"
+ *  를 한 번씩만 내보낸다. 밀어 넣는 중간의 순간 오분류(RED→ORANGE→YELLOW)는
+ *  점유율을 못 넘겨 무시되고, 같은 카드는 제거 전까지 중복 이벤트가 없다.
+ */
+
+#ifndef CARD_PROG_CARD_DETECT_H_
+#define CARD_PROG_CARD_DETECT_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+// ===== 파라미터 튜닝 (단위: 센서 변환, 35ms 기준) =====
+#define CARD_DET_WIN              6U      // 투표 창(변환 수, ≈ 210ms)
+#define CARD_DET_MIN_CONF         3U      // 한쪽 신뢰도가 이보다 낮으면 "없음" 표
+#define CARD_DET_NONE_WEIGHT      12U     // "없음"(좌/우 불일치·저신뢰·버스에러) 표 가중치
+#define CARD_DET_ENTER_PCT        65U     // 제시 판정 점유율(%)
+#define CARD_DET_EXIT_PCT         30U     // 제거 판정 점유율(%) → 히스테리시스
+#define CARD_DET_DWELL            2U      // 판정 조건 최소 유지 (연속 변환 수)
+#define CARD_DET_FAST_CONF        12U     // 좌/우 모두 이 이상인 변환이
+#define CARD_DET_FAST_N           2U      // 같은 색으로 연속 이만큼이면 창/체류 없이 바로 제시
+
+
+typedef enum
+{
+    CARD_EVT_NONE = 0,
+    CARD_EVT_PRESENTED,
+    CARD_EVT_REMOVED
+} card_evt_t;
+
+
+void        card_detect_reset(void);
+
+// 새 변환 1개의 결과 투입 (같은 프레임을 여러 번 넣지 말 것 → color_frame_seq()로 거른다)
+// cls = COLOR_UNKNOWN이면 거부/읽기 실패 → "없음" 표. 이벤트가 생기면 *out_color에 해당 색
+card_evt_t  card_detect_push(uint8_t left, uint8_t left_conf,
+                             uint8_t right, uint8_t right_conf,
+                             color_t *out_color);
+
+color_t     card_detect_current(void);      // 제시 중인 카드, 없으면 COLOR_COUNT
+
+
+#endif /* CARD_PROG_CARD_DETECT_H_ */
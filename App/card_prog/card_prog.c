@@ -6,6 +6,7 @@
  */
 
 #include "card_prog.h"
+#include "card_detect.h"
 #include "uart.h"
 
 
@@ -91,6 +92,18 @@ static inline uint32_t color_to_steps(color_t c)
     }
 }
 
+static inline uint32_t op_to_steps(card_prog_op_t op)
+{
+    switch (op)
+    {
+        case CPOP_FORWARD:     return CARD_PROG_STEPS_FORWARD;
+        case CPOP_REVERSE:     return CARD_PROG_STEPS_BACKWARD;
+        case CPOP_TURN_RIGHT:  return CARD_PROG_STEPS_TURN_RIGHT;
+        case CPOP_TURN_LEFT:   return CARD_PROG_STEPS_TURN_LEFT;
+        default:               return 0;
+    }
+}
+
 static inline StepOperation op_to_drv(card_prog_op_t op)
 {
     switch (op)
@@ -128,6 +141,7 @@ void card_prog_init(void)
     s_mode  = MODE_INVALID;
     s_cur_drv = OP_STOP;
     s_last_eq_color = 0xFF;
+    card_detect_reset();
 
     seq_clear();
 
@@ -147,6 +161,7 @@ void card_prog_set_mode(mode_sw_t m)
         card_prog_stop();
         s_state = CARD_PROG_IDLE;
         s_last_eq_color = 0xFF;  // 모드 이탈 시 엣지 상태 리셋
+        card_detect_reset();
     }
     else
     {
@@ -205,24 +220,9 @@ void card_prog_on_button(btn_id_t id)
     }
 }
 
-// 좌/우 동일 색 입력 → enqueue(or repeat)
-void card_prog_on_dual_equal(uint8_t left, uint8_t right)
+// 제시된 카드 1장 → enqueue(or repeat)
+static void enqueue_card(color_t col)
 {
-    if (s_mode != MODE_CARD) return;
-    if (left >= COLOR_COUNT || right >= COLOR_COUNT) return;
-    if (left != right) return;          // 좌/우 동일하지 않으면 무시
-
-    uint8_t c = left;
-
-    // ★ 같은 동일색이 계속 유지되는 동안은 무시
-    if (c == s_last_eq_color)
-        return;
-
-    // ★ 여기서부터가 "새로운 동일색" 엣지
-    s_last_eq_color = c;
-
-    color_t col = (color_t)c;
-
     // 반복 카드: PINK(+1), PURPLE(+2), LIGHT_GREEN(+3)
     uint8_t rep = 0;
     if (col == COLOR_PINK)             rep = 1;
@@ -256,6 +256,44 @@ void card_prog_on_dual_equal(uint8_t left, uint8_t right)
         uart_printf("[CARD-PROG] buffer full (%u)\r\n", CARD_PROG_MAX_LEN);
 }
 
+// 좌/우 동일 색 입력 → enqueue(or repeat)
+void card_prog_on_dual_equal(uint8_t left, uint8_t right)
+{
+    if (s_mode != MODE_CARD) return;
+    if (left >= COLOR_COUNT || right >= COLOR_COUNT) return;
+    if (left != right) return;          // 좌/우 동일하지 않으면 무시
+
+    uint8_t c = left;
+
+    // ★ 같은 동일색이 계속 유지되는 동안은 무시
+    if (c == s_last_eq_color)
+        return;
+
+    // ★ 여기서부터가 "새로운 동일색" 엣지
+    s_last_eq_color = c;
+
+    enqueue_card((color_t)c);
+}
+
+// 좌/우 분류 + 신뢰도 → 투표 필터 → "제시" 이벤트에서만 enqueue
+void card_prog_on_samples(uint8_t left, uint8_t left_conf, uint8_t right, uint8_t right_conf)
+{
+    if (s_mode != MODE_CARD) return;
+
+    color_t    col;
+    card_evt_t evt = card_detect_push(left, left_conf, right, right_conf, &col);
+
+    if (evt == CARD_EVT_PRESENTED)
+    {
+        uart_printf("[CARD-DET] presented %s\r\n", color_to_string(col));
+        enqueue_card(col);
+    }
+    else if (evt == CARD_EVT_REMOVED)
+    {
+        uart_printf("[CARD-DET] removed %s\r\n", color_to_string(col));
+    }
+}
+
 void card_prog_service(void)
 {
     if (s_mode != MODE_CARD)
@@ -353,3 +391,28 @@ uint8_t card_prog_get_index(void)
 {
     return s_idx;
 }
+
+uint8_t card_prog_export(uint8_t *ops, uint8_t max)
+{
+    uint8_t n = (s_len < max) ? s_len : max;
+
+    for (uint8_t i = 0; i < n; i++)
+        ops[i] = (uint8_t)s_buf[i].op;
+    return n;
+}
+
+bool card_prog_import(const uint8_t *ops, uint8_t len)
+{
+    if (len > CARD_PROG_MAX_LEN)
+        return false;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (op_to_steps((card_prog_op_t)ops[i]) == 0)
+            return false;
+    }
+
+    seq_clear();
+    for (uint8_t i = 0; i < len; i++)
+        seq_push((card_prog_op_t)ops[i], op_to_steps((card_prog_op_t)ops[i]));
+    return true;
+}
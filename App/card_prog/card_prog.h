@@ -47,8 +47,11 @@ typedef enum
 void                card_prog_init(void);
 void                card_prog_set_mode(mode_sw_t m);       // MODE_CARD일 때만 활성
 
-// 입력(좌/우 동일 색만)
+// 입력(좌/우 동일 색만, 단일 샘플 엣지 검출)
 void                card_prog_on_dual_equal(uint8_t left, uint8_t right);
+// 입력(좌/우 분류 + 신뢰도 매 샘플) → 투표 필터(card_detect) 거쳐 enqueue
+void                card_prog_on_samples(uint8_t left, uint8_t left_conf,
+                                         uint8_t right, uint8_t right_conf);
 
 // 버튼 제어 (GO/RESUME/DELETE만 사용)
 void                card_prog_on_button(btn_id_t id);
@@ -64,5 +67,9 @@ void                card_prog_clear(void);                 // 버퍼 삭제(+STO
 void                card_prog_stop(void);                  // 즉시 STOP(보존)
 void                card_prog_start(void);                 // GO와 동일
 
+// 대기 모드 유지용 저장/복원: 동작 코드(card_prog_op_t)만, 스텝 수는 동작으로 정해짐
+uint8_t             card_prog_export(uint8_t *ops, uint8_t max);
+bool                card_prog_import(const uint8_t *ops, uint8_t len);  // 모르는 코드가 있으면 false
+
 
 #endif /* CARD_PROG_CARD_PROG_H_ */
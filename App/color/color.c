@@ -7,12 +7,46 @@
 
 
 #include "color.h"
+#include "color_cls.h"
+#include "color_lut.h"
+#include "color_stats.h"
+#include "color_ae.h"
+#include "color_drift.h"
+#include "color_ccm.h"
+#include "color_strobe.h"
+#include "color_health.h"
 #include "flash.h"
+#include "flash_kv.h"
+#include "color_cal.h"
 #include "uart.h"
 #include "i2c.h"
 
-reference_entry_t color_reference_tbl_left[COLOR_COUNT];
-reference_entry_t color_reference_tbl_right[COLOR_COUNT];
+#include <float.h>
+
+// reference 테이블 + 분류용 SoA 모델 (테이블 변경 시 재구성). [0] = LEFT, [1] = RIGHT
+static struct
+{
+    reference_entry_t  ref[2][COLOR_COUNT];
+    color_soa_t        model[2];
+    color_chroma_soa_t chroma[2];
+} s_cal;
+
+static color_cal_profile_t s_prof;      // 플래시 프로필 작업 버퍼
+
+// 새 변환 감지: 데이터 레지스터는 변환이 끝날 때만 바뀜 (실제 센서는 매 변환 ±1 카운트 잡음)
+static struct
+{
+    bh1749_color_data_t last;
+    uint32_t            seq;
+    uint32_t            drift_seq;      // 드리프트 추적에 마지막으로 넣은 변환
+} s_frame[2];
+
+static inline uint8_t cal_side(uint8_t sensor_side)
+{
+    return (sensor_side == BH1749_ADDR_LEFT) ? 0 : 1;
+}
+
+static color_cls_mode_t   s_cls_mode = COLOR_CLS_MODE_DEFAULT;
 
 uint8_t  offset_side;
 uint16_t offset_black;
@@ -36,24 +70,21 @@ uint8_t bh1749_read_u8(uint8_t dev_addr, uint8_t reg)
 
 uint16_t bh1749_read_u16(uint8_t dev_addr, uint8_t lsb_reg)
 {
-    uint8_t lsb = i2c_read(dev_addr, lsb_reg);
-    uint8_t msb = i2c_read(dev_addr, lsb_reg + 1);
-    return (uint16_t)((msb << 8) | lsb);
+    // LSB/MSB를 한 트랜잭션으로 (따로 읽으면 그 사이 값이 갱신될 수 있음)
+    uint8_t d[2];
+    if (i2c_read_regs(dev_addr, lsb_reg, d, 2) != I2C_OK)
+        return 0;
+    return (uint16_t)((d[1] << 8) | d[0]);
 }
 
-void bh1749_init(uint8_t dev_addr, uint8_t rgb_gain, uint8_t ir_gain, uint8_t meas_mode)
+bool bh1749_init(uint8_t dev_addr, uint8_t rgb_gain, uint8_t ir_gain, uint8_t meas_mode)
 {
     // 1) Software Reset
     bh1749_write_reg(dev_addr, BH1749_REG_SYSTEM_CONTROL, BH1749_SW_RESET);
     delay_ms(50);
 
-    // 2) MODE_CONTROL1: [IR_GAIN][RGB_GAIN][MEAS_MODE]
-    // 비트 배치는 데이터시트 정의에 따름. 기본값: x1/x1, 120ms
-    uint8_t mode1 =
-        ((ir_gain  & 0x03u) << 6) |
-        ((rgb_gain & 0x03u) << 4) |
-        (meas_mode & 0x07u);
-    bh1749_write_reg(dev_addr, BH1749_REG_MODE_CTRL1, mode1);
+    // 2) MODE_CONTROL1: [IR_GAIN 6:5][RGB_GAIN 4:3][MEAS_MODE 2:0]
+    bh1749_write_reg(dev_addr, BH1749_REG_MODE_CTRL1, BH1749_MODE1(rgb_gain, ir_gain, meas_mode));
 
 
     // 3) MODE_CONTROL2: RGB_EN=1 (측정 시작)
@@ -66,63 +97,246 @@ void bh1749_init(uint8_t dev_addr, uint8_t rgb_gain, uint8_t ir_gain, uint8_t me
         uint8_t v = bh1749_read_u8(dev_addr, BH1749_REG_MODE_CTRL2);
         if (v & BH1749_VALID)
         {
-            break;
+            return true;
         }
         delay_ms(5);
     }
+    return false;
 }
 
 /* --------- High-level Color --------- */
 
 void color_init(void)
 {
-    // 기본: x1/x1, 120ms
-    bh1749_init(BH1749_ADDR_LEFT,  BH1749_GAIN_X1,  BH1749_GAIN_X1,  BH1749_MEAS_35MS);
-    bh1749_init(BH1749_ADDR_RIGHT, BH1749_GAIN_X1,  BH1749_GAIN_X1,  BH1749_MEAS_35MS);
+    // 기본: x1/x1, 35ms (AE 사용 시 이후 표면 밝기에 따라 전환)
+    bool valid_l = bh1749_init(BH1749_ADDR_LEFT,  BH1749_GAIN_X1,  BH1749_GAIN_X1,  BH1749_MEAS_35MS);
+    bool valid_r = bh1749_init(BH1749_ADDR_RIGHT, BH1749_GAIN_X1,  BH1749_GAIN_X1,  BH1749_MEAS_35MS);
+
+    color_health_boot(BH1749_ADDR_LEFT,  valid_l);
+    color_health_boot(BH1749_ADDR_RIGHT, valid_r);
+
+#if (_USE_COLOR_AE == 1)
+    color_ae_init(BH1749_ADDR_LEFT);
+    color_ae_init(BH1749_ADDR_RIGHT);
+#endif
+}
+
+i2c_status_t bh1749_read_raw(uint8_t dev_addr, bh1749_color_data_t *out)
+{
+    // 0x50..0x59 (R, G, B, reserved, IR) 10바이트 버스트: 8회 개별 읽기 대비 버스 시간 1/4
+    uint8_t d[BH1749_REG_IR_LSB + 2 - BH1749_REG_RED_LSB];
+
+    i2c_status_t st = i2c_read_regs(dev_addr, BH1749_REG_RED_LSB, d, sizeof(d));
+
+    out->red   = (uint16_t)((d[1] << 8) | d[0]);
+    out->green = (uint16_t)((d[3] << 8) | d[2]);
+    out->blue  = (uint16_t)((d[5] << 8) | d[4]);
+    out->ir    = (uint16_t)((d[9] << 8) | d[8]);
+
+    color_health_observe(dev_addr, st, out);
+
+    if (st == I2C_OK)
+    {
+        uint8_t i = cal_side(dev_addr);
+        if (memcmp(&s_frame[i].last, out, sizeof(*out)) != 0)
+        {
+            s_frame[i].last = *out;
+            s_frame[i].seq++;
+        }
+    }
+    return st;
+}
+
+uint32_t color_frame_seq(uint8_t dev_addr)
+{
+#if (_USE_COLOR_STROBE == 1)
+    if (color_strobe_enabled())
+        return color_strobe_seq();                  // 스트로브: 완료된 ON/OFF 쌍 단위
+#endif
+    return s_frame[cal_side(dev_addr)].seq;
+}
+
+i2c_status_t bh1749_read(uint8_t dev_addr, bh1749_color_data_t *out)
+{
+#if (_USE_COLOR_STROBE == 1)
+    // 스트로브 중엔 변환 타이밍을 상태머신이 쥐고 있음 → 최신 차분 프레임
+    if (color_strobe_enabled())
+        return color_strobe_read(dev_addr, out);
+#endif
+
+#if (_USE_COLOR_AE == 1)
+    bh1749_color_data_t raw;
+    i2c_status_t st = bh1749_read_raw(dev_addr, &raw);
+    if (st != I2C_OK)
+    {
+        *out = raw;     // 0
+        return st;
+    }
+
+    // 노출 전환 직후엔 직전 정규화 값 유지 (새 설정 측정 완료 전)
+    color_ae_update(dev_addr, &raw, out);
+    return I2C_OK;
+#else
+    return bh1749_read_raw(dev_addr, out);
+#endif
 }
 
 bh1749_color_data_t bh1749_read_rgbir(uint8_t dev_addr)
 {
     bh1749_color_data_t c;
 
-    c.red   = bh1749_read_u16(dev_addr, BH1749_REG_RED_LSB);
-    c.green = bh1749_read_u16(dev_addr, BH1749_REG_GREEN_LSB);
-    c.blue  = bh1749_read_u16(dev_addr, BH1749_REG_BLUE_LSB);
-    c.ir    = bh1749_read_u16(dev_addr, BH1749_REG_IR_LSB);
+    (void)bh1749_read(dev_addr, &c);
 
     return c;
 }
 
-void save_color_reference(uint8_t sensor_side, color_t color, uint16_t r, uint16_t g, uint16_t b)
+void color_rebuild_models(uint8_t sensor_side)
+{
+    uint8_t i = cal_side(sensor_side);
+
+    color_cls_build(&s_cal.model[i], s_cal.ref[i], COLOR_COUNT);
+    color_chroma_build(&s_cal.chroma[i], s_cal.ref[i], COLOR_COUNT);
+
+#if (_USE_COLOR_LUT == 1)
+    // 테이블이 바뀌었으면 해시 불일치로 LUT 해제 → 재생성 전까지 최근접 탐색
+    color_lut_attach(sensor_side);
+#endif
+}
+
+void color_adapt_reference(uint8_t sensor_side, color_t color, rgb_raw_t raw)
 {
-    rgb_raw_t raw = { .red_raw = r, .green_raw = g, .blue_raw = b };
-    uint64_t  offset = calculate_brightness(r, g, b);
+    if (color >= COLOR_COUNT)
+        return;
+
+    reference_entry_t *e = &s_cal.ref[cal_side(sensor_side)][color];
 
-    reference_entry_t entry = { .raw = raw, .color = color, .offset = offset };
+    e->raw    = raw;
+    e->color  = color;
+    e->offset = calculate_brightness(raw.red_raw, raw.green_raw, raw.blue_raw);
+}
 
-    if (sensor_side == BH1749_ADDR_LEFT)
+void save_color_reference(uint8_t sensor_side, color_t color, uint16_t r, uint16_t g, uint16_t b, uint16_t ir,
+                          uint32_t n, uint16_t spread)
+{
+    reference_entry_t *e = &s_cal.ref[cal_side(sensor_side)][color];
+
+    e->raw    = (rgb_raw_t){ .red_raw = r, .green_raw = g, .blue_raw = b, .ir_raw = ir };
+    e->offset = calculate_brightness(r, g, b);
+    e->color  = (uint8_t)color;
+    e->n      = (uint8_t)((n > 255u) ? 255u : n);
+    e->spread = spread;
+    color_rebuild_models(sensor_side);
+
+    // Flash 저장은 캘리가 끝났을 때 한 번에 (color_reference_commit)
+}
+
+bool color_reference_commit(void)
+{
+    uint8_t idx = color_cal_active();
+
+    // 이름은 기존 프로필 것 유지, 처음이면 "matN"
+    if (!color_cal_load(idx, &s_prof))
     {
-        color_reference_tbl_left[color] = entry;
+        memset(&s_prof, 0, sizeof(s_prof));
+        snprintf(s_prof.name, sizeof(s_prof.name), "mat%u", (unsigned)idx);
     }
-    else
+
+    for (int i = 0; i < 2; i++)
     {
-        color_reference_tbl_right[color] = entry;
+        for (int c = 0; c < COLOR_COUNT; c++)
+        {
+            const reference_entry_t *e = &s_cal.ref[i][c];
+            color_cal_ref_t         *o = &s_prof.ref[i][c];
+
+            o->r      = e->raw.red_raw;
+            o->g      = e->raw.green_raw;
+            o->b      = e->raw.blue_raw;
+            o->ir     = e->raw.ir_raw;
+            o->cls    = e->color;
+            o->n      = e->n;
+            o->spread = e->spread;
+        }
     }
+    return color_cal_save(idx, &s_prof);
+}
 
-    // Flash 저장 (플랫폼 함수)
-    flash_write_color_reference(sensor_side, color, entry);
+bool color_reference_use_profile(uint8_t idx)
+{
+    if (!color_cal_select(idx))
+        return false;
+
+    load_color_reference_table();
+    calculate_color_brightness_offset();
+#if (_USE_COLOR_LUT == 1)
+    // LUT는 쪽마다 하나 → 새 프로필 reference로 다시 생성 (안 하면 최근접 탐색으로만 동작)
+    color_lut_refresh();
+#endif
+    return true;
 }
 
 color_t classify_color(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
 {
-    (void)ir; // 현재 분류엔 IR 미사용. 원하면 가중치에 포함 가능.
+    return classify_color_ex(left_right, r, g, b, ir).cls;
+}
+
+color_result_t classify_color_ex(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
+{
+    color_result_t res;
+    uint8_t        sensor = left_right;
+
+#if (_USE_COLOR_CCM == 1)
+    // RIGHT 샘플 → LEFT 공간, 이후 LEFT 모델/LUT 하나로 분류
+    left_right = color_ccm_apply(left_right, &r, &g, &b, &ir);
+#endif
+
+#if (_USE_COLOR_LUT == 1)
+    res.margin = 0;
+    if (!color_lut_lookup(left_right, r, g, b, ir, &res.cls, &res.conf))
+#endif
+        res = color_cls_search(left_right, color_side_cls_mode(left_right), r, g, b, ir);
+
+    // 드리프트 EWMA는 변환당 한 번 (카드 모드처럼 같은 프레임을 여러 번 분류해도 적응 속도 일정)
+    uint32_t seq = color_frame_seq(sensor);
+    if (seq != s_frame[cal_side(sensor)].drift_seq)
+    {
+        s_frame[cal_side(sensor)].drift_seq = seq;
+        color_drift_observe(left_right, &res, r, g, b, ir);
+    }
+    return res;
+}
+
+color_cls_mode_t color_side_cls_mode(uint8_t left_right)
+{
+    // 다중 샘플 통계가 없는(구버전 캘리) 쪽은 색도 모드로
+    if (s_cls_mode == COLOR_CLS_MAHAL && !color_stats_ready(left_right))
+        return COLOR_CLS_CHROMA;
+
+    return s_cls_mode;
+}
+
+void color_set_cls_mode(color_cls_mode_t mode)
+{
+    if (mode >= COLOR_CLS_MODE_COUNT)
+        return;
+
+    s_cls_mode = mode;
+#if (_USE_COLOR_LUT == 1)
+    color_lut_attach(BH1749_ADDR_LEFT);
+    color_lut_attach(BH1749_ADDR_RIGHT);
+#endif
+}
+
+color_cls_mode_t color_get_cls_mode(void)
+{
+    return s_cls_mode;
+}
 
-    float   min_dist   = 1e9f;
+color_t classify_color_float(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b)
+{
+    float   min_dist   = FLT_MAX;     // AE 스케일/포화 값은 거리가 1e9를 넘는다
     color_t best_match = COLOR_GRAY;
 
-    const reference_entry_t* table = (left_right == BH1749_ADDR_LEFT)
-                                     ? color_reference_tbl_left
-                                     : color_reference_tbl_right;
+    const reference_entry_t* table = s_cal.ref[cal_side(left_right)];
 
     for (int i = 0; i < COLOR_COUNT; i++)
     {
@@ -142,14 +356,39 @@ color_t classify_color(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b, u
     return best_match;
 }
 
+const color_soa_t* color_side_model(uint8_t left_right)
+{
+    return &s_cal.model[cal_side(left_right)];
+}
+
+const color_chroma_soa_t* color_side_chroma(uint8_t left_right)
+{
+    return &s_cal.chroma[cal_side(left_right)];
+}
+
+const reference_entry_t* color_side_table(uint8_t left_right)
+{
+    return s_cal.ref[cal_side(left_right)];
+}
+
 uint8_t classify_color_side(uint8_t color_side)
+{
+    return (uint8_t)classify_color_side_ex(color_side).cls;
+}
+
+color_result_t classify_color_side_ex(uint8_t color_side)
 {
     uint8_t addr = color_side;
 
-    bh1749_color_data_t c = bh1749_read_rgbir(addr);
-    color_t detected = classify_color(addr, c.red, c.green, c.blue, c.ir);
+    bh1749_color_data_t c;
+    if (!color_health_usable(addr) || bh1749_read(addr, &c) != I2C_OK)
+    {
+        // 0으로 채워진 값(또는 고장 센서 값)을 분류하면 BLACK 등 엉뚱한 색이 나온다 → 무효 처리
+        color_result_t err = { COLOR_UNKNOWN, 0, 0 };
+        return err;
+    }
 
-    return (uint8_t)detected;
+    return classify_color_ex(addr, c.red, c.green, c.blue, c.ir);
 }
 
 const char* color_to_string(color_t color)
@@ -178,13 +417,75 @@ const char* color_to_string(color_t color)
     return color_names[color];
 }
 
+static void set_entry(reference_entry_t *e, color_t color, rgb_raw_t raw, uint8_t n, uint16_t spread)
+{
+    e->raw    = raw;
+    e->offset = calculate_brightness(raw.red_raw, raw.green_raw, raw.blue_raw);
+    e->color  = (uint8_t)color;
+    e->n      = n;
+    e->spread = spread;
+}
+
+// 프로필 레코드 → RAM (파생 값은 다시 계산). 빈 칸이 있으면 false
+static bool load_profile_side(const color_cal_profile_t *p, uint8_t i)
+{
+    for (int c = 0; c < COLOR_COUNT; c++)
+    {
+        const color_cal_ref_t *o = &p->ref[i][c];
+        if (o->cls != (uint8_t)c)
+            return false;
+
+        rgb_raw_t raw = { .red_raw = o->r, .green_raw = o->g, .blue_raw = o->b, .ir_raw = o->ir };
+        set_entry(&s_cal.ref[i][c], (color_t)c, raw, o->n, o->spread);
+    }
+    return true;
+}
+
+// 프로필 이전 형식: KV reference (AE 정규화 스케일로 캘리된 값).
+// 그보다 오래된 고정 페이지(0x0807F000)는 스케일이 섞여 있어(AE 이전 = 원시 카운트) 옮기지 않는다
+static bool load_legacy_entry(uint8_t sensor_side, color_t color, reference_entry_t *out)
+{
+    uint16_t         len;
+    const rgb_raw_t *raw = kv_peek(KV_KEY_REF(sensor_side, color), &len);
+
+    if (raw == NULL || len != sizeof(rgb_raw_t))
+        return false;
+
+    set_entry(out, color, *raw, 0, 0);
+    return true;
+}
+
 void load_color_reference_table(void)
 {
-    for (int i = 0; i < COLOR_COUNT; i++)
+    uint8_t active = color_cal_active();
+    bool    prof   = color_cal_load(active, &s_prof);
+    bool    blob   = color_cal_present();
+
+    for (uint8_t i = 0; i < 2; i++)
     {
-        color_reference_tbl_left[i]  = flash_read_color_reference(BH1749_ADDR_LEFT,  i);
-        color_reference_tbl_right[i] = flash_read_color_reference(BH1749_ADDR_RIGHT, i);
+        uint8_t side = (i == 0) ? BH1749_ADDR_LEFT : BH1749_ADDR_RIGHT;
+        bool    ok   = prof ? load_profile_side(&s_prof, i) : !blob;
+
+        // 블롭이 아직 없을 때만 이전 형식에서 옮겨 온다. 빈 프로필이거나 한 색이라도 비었으면 그 쪽은 기본값
+        for (int c = 0; c < COLOR_COUNT && ok && !prof; c++)
+            ok = load_legacy_entry(side, (color_t)c, &s_cal.ref[i][c]);
+
+        if (!ok)
+        {
+            uart_printf("[CAL] %s: profile %u has no calibration, using defaults\r\n",
+                        i == 0 ? "LEFT" : "RIGHT", (unsigned)active);
+            for (int c = 0; c < COLOR_COUNT; c++)
+                set_entry(&s_cal.ref[i][c], (color_t)c, color_cal_default_raw((color_t)c), 0, 0);
+        }
     }
+
+    color_stats_load();
+    color_ccm_fit();
+    color_rebuild_models(BH1749_ADDR_LEFT);
+    color_rebuild_models(BH1749_ADDR_RIGHT);
+
+    // 앵커 = 방금 읽은 캘리 값, (적응 모드면) 저장된 적응값 덮어쓰기
+    color_drift_load();
 }
 
 void debug_print_color_reference_table(void)
@@ -192,19 +493,21 @@ void debug_print_color_reference_table(void)
     uart_printf("=== LEFT COLOR REFERENCE TABLE ===\r\n");
     for (int i = 0; i < COLOR_COUNT; i++)
     {
-        reference_entry_t e = color_reference_tbl_left[i];
-        uart_printf("[%2d | %-11s] R: %4d, G: %4d, B: %4d, OFFSET: %8llu\r\n",
+        reference_entry_t e = s_cal.ref[0][i];
+        uart_printf("[%2d | %-11s] R: %4d, G: %4d, B: %4d, IR: %4d, OFFSET: %8lu, n=%u sd=%u\r\n",
                     i, color_to_string(e.color),
-                    e.raw.red_raw, e.raw.green_raw, e.raw.blue_raw, e.offset);
+                    e.raw.red_raw, e.raw.green_raw, e.raw.blue_raw, e.raw.ir_raw,
+                    (unsigned long)e.offset, e.n, e.spread);
     }
 
     uart_printf("=== RIGHT COLOR REFERENCE TABLE ===\r\n");
     for (int i = 0; i < COLOR_COUNT; i++)
     {
-        reference_entry_t e = color_reference_tbl_right[i];
-        uart_printf("[%2d | %-11s] R: %4d, G: %4d, B: %4d, OFFSET: %8llu\r\n",
+        reference_entry_t e = s_cal.ref[1][i];
+        uart_printf("[%2d | %-11s] R: %4d, G: %4d, B: %4d, IR: %4d, OFFSET: %8lu, n=%u sd=%u\r\n",
                     i, color_to_string(e.color),
-                    e.raw.red_raw, e.raw.green_raw, e.raw.blue_raw, e.offset);
+                    e.raw.red_raw, e.raw.green_raw, e.raw.blue_raw, e.raw.ir_raw,
+                    (unsigned long)e.offset, e.n, e.spread);
     }
 
     uart_printf("=== BRIGHTNESS OFFSET TABLE ===\r\n");
@@ -212,6 +515,31 @@ void debug_print_color_reference_table(void)
     uart_printf("offset_aver: %d\r\n", offset_average);
 }
 
+void debug_print_color_bus_stats(void)
+{
+    const uint8_t addrs[2] = { BH1749_ADDR_LEFT, BH1749_ADDR_RIGHT };
+
+    uart_printf("=== BH1749 I2C STATS ===\r\n");
+    for (int i = 0; i < 2; i++)
+    {
+        const i2c_stats_t *st = i2c_get_stats(addrs[i]);
+        if (st == NULL)
+            continue;
+        uart_printf("[0x%02X] xfer:%lu err:%lu nack:%lu to:%lu bus:%lu retry:%lu rec:%lu\r\n",
+                    addrs[i], st->xfer_cnt, st->err_cnt, st->nack_cnt, st->timeout_cnt,
+                    st->bus_err_cnt, st->retry_cnt, st->recover_cnt);
+        uart_printf("       last:%uus max:%uus last_err:%s\r\n",
+                    st->last_us, st->max_us, i2c_status_str(st->last_err));
+#if (_USE_COLOR_AE == 1)
+        uart_printf("       ae:%s\r\n", color_ae_level_str(color_ae_level(addrs[i])));
+#endif
+    }
+#if (_USE_COLOR_STROBE == 1)
+    debug_print_color_strobe();
+#endif
+    debug_print_color_health();
+}
+
 uint32_t calculate_brightness(uint16_t r, uint16_t g, uint16_t b)
 {
     // H/W 없이 빠른 정수계수 Y ≈ 0.2126R + 0.7152G + 0.0722B
@@ -220,13 +548,13 @@ uint32_t calculate_brightness(uint16_t r, uint16_t g, uint16_t b)
 
 void calculate_color_brightness_offset(void)
 {
-    offset_black = (uint16_t)abs((int)color_reference_tbl_left[COLOR_BLACK].offset
-                               - (int)color_reference_tbl_right[COLOR_BLACK].offset);
-    offset_white = (uint16_t)abs((int)color_reference_tbl_left[COLOR_WHITE].offset
-                               - (int)color_reference_tbl_right[COLOR_WHITE].offset);
+    offset_black = (uint16_t)abs((int)s_cal.ref[0][COLOR_BLACK].offset
+                               - (int)s_cal.ref[1][COLOR_BLACK].offset);
+    offset_white = (uint16_t)abs((int)s_cal.ref[0][COLOR_WHITE].offset
+                               - (int)s_cal.ref[1][COLOR_WHITE].offset);
 
-    offset_side = (color_reference_tbl_left[COLOR_BLACK].offset >
-                   color_reference_tbl_right[COLOR_BLACK].offset) ? LEFT : RIGHT;
+    offset_side = (s_cal.ref[0][COLOR_BLACK].offset >
+                   s_cal.ref[1][COLOR_BLACK].offset) ? LEFT : RIGHT;
 
     offset_average = (uint16_t)((offset_black + offset_white) / 2);
 }
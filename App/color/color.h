@@ -11,6 +11,7 @@
 
 #include "def.h"
 #include "rgb.h"
+#include "i2c.h"
 
 // ==== Device I2C address (7-bit) ====
 #define BH1749_ADDR_LEFT          0x38
@@ -32,9 +33,11 @@
 // PART ID는 0x40 하위 6비트 읽기 전용(0x0D) — 필요시 확인.
 
 // MODE_CONTROL1 (0x41)
-// [IR_GAIN1:0][RGB_GAIN1:0][MEAS_MODE2:0]
+// [7]rsv [6:5]IR_GAIN [4:3]RGB_GAIN [2:0]MEAS_MODE
 // IR/RGB gain: 01 = x1, 11 = x32
 // MEAS_MODE: 101=35ms, 010=120ms, 011=240ms
+#define BH1749_MODE1(rgb_gain, ir_gain, meas) \
+    ((uint8_t)((((ir_gain) & 0x03u) << 5) | (((rgb_gain) & 0x03u) << 3) | ((meas) & 0x07u)))
 #define BH1749_GAIN_X1            0x01
 #define BH1749_GAIN_X32           0x03
 #define BH1749_MEAS_35MS          0x05
@@ -48,6 +51,9 @@
 // ==== App limits ====
 #define MAX_INSERTED_COMMANDS     20
 
+// 어떤 클래스와도 충분히 가깝지 않음(맨 테이블/손/반쯤 걸친 카드) 또는 버스 에러
+#define COLOR_UNKNOWN             ((color_t)COLOR_COUNT)
+
 
 
 typedef struct
@@ -63,17 +69,41 @@ typedef struct
     uint16_t red_raw;
     uint16_t green_raw;
     uint16_t blue_raw;
+    uint16_t ir_raw;      // 색도 모드의 IR(주변광) 보정용
 } rgb_raw_t;
 
+// 분류 결과: 클래스 + 신뢰도 + 2위와의 여유
+typedef struct
+{
+    color_t  cls;         // COLOR_UNKNOWN = 거부
+    uint8_t  conf;        // 0(경계) ~ 15(확실)
+    uint16_t margin;      // 2위 - 1위 제곱거리 (RGB/색도: >> COLOR_MARGIN_SHIFT, 마할라노비스: 점수 Q0). LUT 경로는 0
+} color_result_t;
+
+// RAM reference (16 B). 플래시에는 color_cal_ref_t로 저장, offset은 로드 시 재계산
 typedef struct
 {
     rgb_raw_t raw;
-    color_t   color;
-    uint8_t   _pad[1];
-    uint64_t  offset;     // 밝기 보정/플래시에 저장용
+    uint32_t  offset;     // 밝기 (calculate_brightness)
+    uint8_t   color;      // color_t
+    uint8_t   n;          // 캘리 샘플 수 (255 포화, 0 = 기본값/이전 형식)
+    uint16_t  spread;     // 샘플 RMS 편차 (카운트)
 } reference_entry_t;
 
 
+typedef enum
+{
+    COLOR_CLS_RGB = 0,    // raw R/G/B 최근접 (밝기에 민감)
+    COLOR_CLS_CHROMA,     // IR 보정 후 색도(r/(r+g+b), g/(r+g+b)) + log 밝기 축
+    COLOR_CLS_MAHAL,      // 클래스별 평균/공분산(다중 샘플 캘리) 마할라노비스 거리
+    COLOR_CLS_MODE_COUNT
+} color_cls_mode_t;
+
+#ifndef COLOR_CLS_MODE_DEFAULT
+#define COLOR_CLS_MODE_DEFAULT    COLOR_CLS_MAHAL
+#endif
+
+
 typedef enum
 {
     MODE_NONE = 0,
@@ -91,18 +121,33 @@ typedef enum
 void     bh1749_write_reg(uint8_t dev_addr, uint8_t reg, uint8_t data);
 uint8_t  bh1749_read_u8(uint8_t dev_addr, uint8_t reg);
 uint16_t bh1749_read_u16(uint8_t dev_addr, uint8_t lsb_reg);
-void     bh1749_init(uint8_t dev_addr, uint8_t rgb_gain, uint8_t ir_gain, uint8_t meas_mode);
+bool     bh1749_init(uint8_t dev_addr, uint8_t rgb_gain, uint8_t ir_gain, uint8_t meas_mode);   // VALID 확인되면 true
+// R/G/B/IR을 한 번의 버스트(0x50~0x59)로 읽음. 실패 시 out은 0으로 채워지고 상태 반환
+i2c_status_t bh1749_read_raw(uint8_t dev_addr, bh1749_color_data_t *out);
+// 위 + 자동 노출 정규화(_USE_COLOR_AE), 스트로브 중이면 주변광 차감 프레임. 분류/캘리는 이쪽 사용
+i2c_status_t bh1749_read(uint8_t dev_addr, bh1749_color_data_t *out);
+// 새 변환(프레임)마다 1 증가 (같은 변환을 여러 번 읽어도 그대로). 주기 필터/제어는 이 값이 바뀔 때만 갱신
+uint32_t     color_frame_seq(uint8_t dev_addr);
 
 // ==== High-level color ====
 void                color_init(void);
 bh1749_color_data_t bh1749_read_rgbir(uint8_t dev_addr);
-void                save_color_reference(uint8_t sensor_side, color_t color, uint16_t r, uint16_t g, uint16_t b);
+void                save_color_reference(uint8_t sensor_side, color_t color, uint16_t r, uint16_t g, uint16_t b, uint16_t ir,
+                                         uint32_t n, uint16_t spread);
+bool                color_reference_commit(void);     // 현재 테이블 → 활성 캘리 프로필 (A/B)
+bool                color_reference_use_profile(uint8_t idx);   // 프로필 전환 + 다시 로드 + LUT 재생성
 color_t             classify_color(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b, uint16_t ir);
-uint8_t             classify_color_side(uint8_t color_side);
+color_result_t      classify_color_ex(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b, uint16_t ir);
+color_t             classify_color_float(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b);   // 기존 float 구현(비교용)
+uint8_t             classify_color_side(uint8_t color_side);   // 버스 에러/거부 시 COLOR_UNKNOWN
+color_result_t      classify_color_side_ex(uint8_t color_side);
+void                color_set_cls_mode(color_cls_mode_t mode);
+color_cls_mode_t    color_get_cls_mode(void);
 
 const char*         color_to_string(color_t color);
 void                load_color_reference_table(void);
 void                debug_print_color_reference_table(void);
+void                debug_print_color_bus_stats(void);
 uint32_t            calculate_brightness(uint16_t r, uint16_t g, uint16_t b);
 void                calculate_color_brightness_offset(void);
 color_mode_t        color_to_mode(color_t color);
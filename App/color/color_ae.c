@@ -0,0 +1,208 @@
+/*
+ * color_ae.c
+ *
+ *  BH1749 자동 노출
+ */
+
+
+#include "color_ae.h"
+
+
+typedef struct
+{
+    uint8_t  gain;          // BH1749_GAIN_*
+    uint8_t  meas;          // BH1749_MEAS_*
+    uint16_t ms;
+    uint16_t sens;          // 게인 × ms (x1/35ms = 35)
+} ae_step_t;
+
+static const ae_step_t s_steps[COLOR_AE_LEVEL_COUNT] =
+{
+    [COLOR_AE_X1_35MS]   = { BH1749_GAIN_X1,  BH1749_MEAS_35MS,   35,   35 },
+    [COLOR_AE_X32_35MS]  = { BH1749_GAIN_X32, BH1749_MEAS_35MS,   35, 1120 },
+    [COLOR_AE_X1_120MS]  = { BH1749_GAIN_X1,  BH1749_MEAS_120MS, 120,  120 },
+    [COLOR_AE_X32_120MS] = { BH1749_GAIN_X32, BH1749_MEAS_120MS, 120, 3840 },
+    [COLOR_AE_X32_240MS] = { BH1749_GAIN_X32, BH1749_MEAS_240MS, 240, 7680 },
+};
+
+// 선택 우선순위: 짧은 측정시간 먼저, 같은 시간이면 높은 게인
+static const color_ae_level_t s_pref[COLOR_AE_LEVEL_COUNT] =
+{
+    COLOR_AE_X32_35MS, COLOR_AE_X1_35MS,
+    COLOR_AE_X32_120MS, COLOR_AE_X1_120MS,
+    COLOR_AE_X32_240MS
+};
+
+typedef struct
+{
+    color_ae_level_t    level;
+    uint32_t            k_q16;          // raw → 정규화 계수
+    uint32_t            switch_ms;
+    uint16_t            settle_ms;
+    bh1749_color_data_t last;           // 직전 정규화 값 (전환 중 유지)
+} ae_state_t;
+
+static ae_state_t s_ae[2];
+
+
+static inline ae_state_t* ae_of(uint8_t dev_addr)
+{
+    return &s_ae[(dev_addr == BH1749_ADDR_LEFT) ? 0 : 1];
+}
+
+static inline uint16_t norm_u16(uint16_t raw, uint32_t k_q16)
+{
+    uint64_t v = ((uint64_t)raw * k_q16 + 0x8000u) >> 16;
+    return (uint16_t)((v > 0xFFFFu) ? 0xFFFFu : v);
+}
+
+// 이 원시값부터 포화: 정규화 값이 0xFFFF를 넘거나(x1/35ms는 ×4라 16384) ADC 최대값
+static inline uint32_t ae_raw_limit(color_ae_level_t lv)
+{
+    uint32_t lim = (0xFFFFu * (uint32_t)s_steps[lv].sens) / (35u << COLOR_AE_NORM_SHIFT) + 1u;
+    return (lim > 0xFFFFu) ? 0xFFFFu : lim;
+}
+
+// AE_HIGH/AE_SAFE를 단계별 상한에 비례해서 줄인다 (ADC 포화와 정규화 포화 중 먼저 오는 쪽)
+static inline uint32_t ae_high(color_ae_level_t lv)
+{
+    return (COLOR_AE_HIGH * ae_raw_limit(lv)) / 0xFFFFu;
+}
+
+static inline uint32_t ae_safe(color_ae_level_t lv)
+{
+    return (COLOR_AE_SAFE * ae_raw_limit(lv)) / 0xFFFFu;
+}
+
+static void ae_apply(uint8_t dev_addr, color_ae_level_t lv)
+{
+    ae_state_t      *st = ae_of(dev_addr);
+    const ae_step_t *s  = &s_steps[lv];
+
+    bh1749_write_reg(dev_addr, BH1749_REG_MODE_CTRL1, BH1749_MODE1(s->gain, s->gain, s->meas));
+
+    // 진행 중이던(이전 설정) 측정 + 새 설정 측정 1회가 끝날 때까지 무시
+    st->settle_ms = (uint16_t)(s_steps[st->level].ms + s->ms);
+    st->switch_ms = millis();
+    st->level     = lv;
+    st->k_q16     = (uint32_t)(((uint64_t)35u << (16 + COLOR_AE_NORM_SHIFT)) / s->sens);
+}
+
+// 현재 최대 채널 mx(현 단계)로 각 단계의 최대값을 예측해 고른다
+static color_ae_level_t ae_choose(color_ae_level_t cur, uint32_t mx)
+{
+    const uint32_t sens_cur = s_steps[cur].sens;
+    color_ae_level_t most = COLOR_AE_X1_35MS;
+    uint16_t most_sens = 0;
+
+    for (int i = 0; i < COLOR_AE_LEVEL_COUNT; i++)
+    {
+        color_ae_level_t lv = s_pref[i];
+        uint32_t p = (uint32_t)(((uint64_t)mx * s_steps[lv].sens) / sens_cur);
+
+        if (p >= COLOR_AE_LOW && p < ae_safe(lv))
+            return lv;
+
+        // 분해능 조건을 아무도 못 채우면 포화 안 되는 가장 민감한 단계
+        if (p < ae_safe(lv) && s_steps[lv].sens > most_sens)
+        {
+            most      = lv;
+            most_sens = s_steps[lv].sens;
+        }
+    }
+
+    return most;
+}
+
+void color_ae_init(uint8_t dev_addr)
+{
+    ae_state_t *st = ae_of(dev_addr);
+
+    memset(st, 0, sizeof(*st));
+    st->level = COLOR_AE_X1_35MS;
+    ae_apply(dev_addr, COLOR_AE_X1_35MS);
+}
+
+bool color_ae_settling(uint8_t dev_addr)
+{
+    const ae_state_t *st = ae_of(dev_addr);
+    return (millis() - st->switch_ms) < st->settle_ms;
+}
+
+bool color_ae_update(uint8_t dev_addr, const bh1749_color_data_t *raw,
+                     bh1749_color_data_t *norm)
+{
+    ae_state_t *st = ae_of(dev_addr);
+
+    if (color_ae_settling(dev_addr))
+    {
+        *norm = st->last;
+        return false;
+    }
+
+    st->last.red   = norm_u16(raw->red,   st->k_q16);
+    st->last.green = norm_u16(raw->green, st->k_q16);
+    st->last.blue  = norm_u16(raw->blue,  st->k_q16);
+    st->last.ir    = norm_u16(raw->ir,    st->k_q16);
+    *norm = st->last;
+
+    uint32_t mx = raw->red;
+    if (raw->green > mx) mx = raw->green;
+    if (raw->blue  > mx) mx = raw->blue;
+
+    color_ae_level_t cur  = st->level;
+    color_ae_level_t best = ae_choose(cur, mx);
+
+    if (best == cur)
+        return true;
+
+    // 현재 단계가 쓸 만하면(비포화 + 분해능 충분하거나 더 민감한 대안 없음) 유지.
+    // 단, 더 짧은 측정시간이 2×LOW 이상 여유로 가능하면 전환 (경계에서 왕복 방지)
+    bool keep = (mx < ae_high(cur)) &&
+                (mx >= COLOR_AE_LOW || s_steps[best].sens <= s_steps[cur].sens);
+    uint32_t p_best = (uint32_t)(((uint64_t)mx * s_steps[best].sens) / s_steps[cur].sens);
+
+    if (!keep || (s_steps[best].ms < s_steps[cur].ms && p_best >= 2u * COLOR_AE_LOW))
+        ae_apply(dev_addr, best);
+
+    return true;
+}
+
+void color_ae_normalize(uint8_t dev_addr, const bh1749_color_data_t *raw,
+                        bh1749_color_data_t *norm)
+{
+    const ae_state_t *st = ae_of(dev_addr);
+
+    norm->red   = norm_u16(raw->red,   st->k_q16);
+    norm->green = norm_u16(raw->green, st->k_q16);
+    norm->blue  = norm_u16(raw->blue,  st->k_q16);
+    norm->ir    = norm_u16(raw->ir,    st->k_q16);
+}
+
+color_ae_level_t color_ae_level(uint8_t dev_addr)
+{
+    return ae_of(dev_addr)->level;
+}
+
+uint16_t color_ae_raw_limit(uint8_t dev_addr)
+{
+    return (uint16_t)ae_raw_limit(ae_of(dev_addr)->level);
+}
+
+uint16_t color_ae_meas_ms(uint8_t dev_addr)
+{
+    return s_steps[ae_of(dev_addr)->level].ms;
+}
+
+const char* color_ae_level_str(color_ae_level_t lv)
+{
+    switch (lv)
+    {
+        case COLOR_AE_X1_35MS:   return "x1/35ms";
+        case COLOR_AE_X32_35MS:  return "x32/35ms";
+        case COLOR_AE_X1_120MS:  return "x1/120ms";
+        case COLOR_AE_X32_120MS: return "x32/120ms";
+        case COLOR_AE_X32_240MS: return "x32/240ms";
+        default:                 return "?";
+    }
+}
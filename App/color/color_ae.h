@@ -0,0 +1,65 @@
+/*
+ * color_ae.h
+ *
+ *  BH1749 자동 노출 (게인 x1/x32 × 측정시간 35/120/240ms)
+ *
+ *  원시 카운트의 최대 채널을 보고 "충분한 분해능(AE_LOW 이상)을 주는 가장 짧은
+ *  측정시간"을 고른다. 같은 시간이면 높은 게인 우선. 포화(AE_HIGH) 직전이면 낮춘다.
+ *  상한은 단계별로 정규화 포화(0xFFFF)에 맞춰 줄어든다 (x1/35ms: 원시 16384부터 잘림).
+ *  출력은 x1/35ms 기준 카운트 × 2^COLOR_AE_NORM_SHIFT 로 정규화 →
+ *  노출이 바뀌어도 reference 테이블(같은 스케일로 캘리)이 그대로 유효.
+ */
+
+#ifndef COLOR_COLOR_AE_H_
+#define COLOR_COLOR_AE_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#ifndef _USE_COLOR_AE
+#define _USE_COLOR_AE           1
+#endif
+
+// 정규화 스케일: x1/35ms 카운트의 1/4 단위 (어두운 면에서 x32 분해능 보존, 상한 16383 카운트)
+#ifndef COLOR_AE_NORM_SHIFT
+#define COLOR_AE_NORM_SHIFT     2U
+#endif
+
+#define COLOR_AE_LOW            2000U   // 이보다 작으면 분해능 부족 → 더 민감하게
+#define COLOR_AE_HIGH           60000U  // 이 이상은 포화 직전 → 덜 민감하게 (정규화 상한 0xFFFF 기준 비율)
+#define COLOR_AE_SAFE           40000U  // 새 단계 선택 시 예측 최대값 상한(여유), 같은 비율
+
+
+typedef enum
+{
+    COLOR_AE_X1_35MS = 0,
+    COLOR_AE_X32_35MS,
+    COLOR_AE_X1_120MS,
+    COLOR_AE_X32_120MS,
+    COLOR_AE_X32_240MS,
+    COLOR_AE_LEVEL_COUNT
+} color_ae_level_t;
+
+
+void             color_ae_init(uint8_t dev_addr);
+
+// 원시값 → 노출 조정 + 정규화. 노출 전환 직후(새 측정 완료 전)엔 false, *norm은 직전 값 유지
+bool             color_ae_update(uint8_t dev_addr, const bh1749_color_data_t *raw,
+                                 bh1749_color_data_t *norm);
+
+// 노출 조정 없이 현재 단계 계수로 정규화만 (스트로브 차분 프레임용)
+void             color_ae_normalize(uint8_t dev_addr, const bh1749_color_data_t *raw,
+                                    bh1749_color_data_t *norm);
+
+// 노출 전환 후 새 설정 측정이 아직 안 끝남 (color_ae_update가 직전 값을 돌려주는 구간)
+bool             color_ae_settling(uint8_t dev_addr);
+
+color_ae_level_t color_ae_level(uint8_t dev_addr);
+uint16_t         color_ae_meas_ms(uint8_t dev_addr);
+uint16_t         color_ae_raw_limit(uint8_t dev_addr);     // 이 원시값부터 정규화 값이 0xFFFF로 잘림
+const char*      color_ae_level_str(color_ae_level_t lv);
+
+
+#endif /* COLOR_COLOR_AE_H_ */
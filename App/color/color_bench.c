@@ -0,0 +1,422 @@
+/*
+ * color_bench.c
+ *
+ *  분류기 정확도/속도 벤치마크
+ */
+
+
+#include "color_bench.h"
+#include "color_cls.h"
+#include "color_lut.h"
+#include "color_stats.h"
+#include "color_ccm.h"
+#include "color_ae.h"
+#include "utils.h"
+#include "uart.h"
+
+
+#if (_USE_COLOR_BENCH == 1)
+
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef COLOR_BENCH_DATA_FILE
+#include COLOR_BENCH_DATA_FILE
+#endif
+
+typedef struct
+{
+    uint16_t r, g, b, ir;
+    uint8_t  side;          // BH1749_ADDR_*
+    uint8_t  label;         // color_t
+} bench_sample_t;
+
+typedef enum
+{
+    BENCH_FLOAT = 0,        // 기존 float 최근접 (거부 없음)
+    BENCH_RGB,
+    BENCH_CHROMA,
+    BENCH_MAHAL,
+    BENCH_LUT,
+    BENCH_FULL,             // classify_color_ex (CCM + LUT/모드 폴백, 실사용 경로)
+    BENCH_VARIANT_COUNT
+} bench_variant_t;
+
+static const char* const s_variant_name[BENCH_VARIANT_COUNT] =
+{
+    "float", "rgb", "chroma", "mahal", "lut", "full"
+};
+
+static bench_sample_t    s_set[COLOR_BENCH_MAX_SAMPLES];
+static color_stats_acc_t s_acc[2][COLOR_COUNT];     // 학습 CSV 누적 (캘리와 같은 Welford)
+static uint32_t          s_ir_sum[2][COLOR_COUNT];
+static uint16_t       s_n = 0;
+static uint16_t       s_conf[COLOR_COUNT][COLOR_COUNT + 1];    // [정답][예측], 마지막 열 = UNKNOWN
+
+
+static const char* skip_line(const char *p)
+{
+    while (*p && *p != '\n') p++;
+    return (*p == '\n') ? p + 1 : p;
+}
+
+static const char* parse_side(const char *p, uint8_t *side)
+{
+    if (*p == 'L' || *p == 'l')      { *side = BH1749_ADDR_LEFT;  return p + 1; }
+    if (*p == 'R' || *p == 'r')      { *side = BH1749_ADDR_RIGHT; return p + 1; }
+    if (*p == '0' || *p == '1')      { *side = (*p == '0') ? BH1749_ADDR_LEFT : BH1749_ADDR_RIGHT; return p + 1; }
+    return NULL;
+}
+
+// 색 번호 또는 이름 (color_to_string과 같은 표기)
+static const char* parse_color(const char *p, uint8_t *cls)
+{
+    if (*p >= '0' && *p <= '9')
+    {
+        char *e;
+        uint32_t v = (uint32_t)strtoul(p, &e, 10);
+        if (v >= COLOR_COUNT)
+            return NULL;
+        *cls = (uint8_t)v;
+        return e;
+    }
+
+    for (int c = 0; c < COLOR_COUNT; c++)
+    {
+        const char *name = color_to_string((color_t)c);
+        size_t      len  = strlen(name);
+        if (strncmp(p, name, len) == 0 && !(p[len] == '_' || (p[len] >= 'A' && p[len] <= 'Z')))
+        {
+            *cls = (uint8_t)c;
+            return p + len;
+        }
+    }
+    return NULL;
+}
+
+static const char* parse_u16s(const char *p, uint16_t *dst[], int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        if (*p != ',')
+            return NULL;
+        char *e;
+        uint32_t v = (uint32_t)strtoul(p + 1, &e, 10);
+        if (e == p + 1)
+            return NULL;
+        *dst[i] = (uint16_t)((v > 0xFFFFu) ? 0xFFFFu : v);
+        p = e;
+    }
+    return p;
+}
+
+uint16_t color_bench_load_refs_csv(const char *text)
+{
+    const char *p = text;
+    uint16_t    rows = 0;
+    bool        touched[2] = { false, false };
+
+    while (p && *p)
+    {
+        uint8_t     side, cls;
+        rgb_raw_t   raw;
+        uint16_t   *dst[4] = { &raw.red_raw, &raw.green_raw, &raw.blue_raw, &raw.ir_raw };
+        const char *q = parse_side(p, &side);
+
+        // 헤더/주석/빈 줄은 건너뜀
+        if (q && *q == ',' && (q = parse_color(q + 1, &cls)) != NULL &&
+            (q = parse_u16s(q, dst, 4)) != NULL)
+        {
+            color_adapt_reference(side, (color_t)cls, raw);
+            touched[side == BH1749_ADDR_LEFT ? 0 : 1] = true;
+            rows++;
+        }
+        p = skip_line(q ? q : p);
+    }
+
+    // 테이블 해시가 바뀌므로 LUT는 자동 분리 (LUT 변형은 건너뜀)
+    color_ccm_fit();
+    if (touched[0]) color_rebuild_models(BH1749_ADDR_LEFT);
+    if (touched[1]) color_rebuild_models(BH1749_ADDR_RIGHT);
+
+    return rows;
+}
+
+// "side,R,G,B,IR,color" 한 행. 실패(헤더/주석 포함)면 NULL
+static const char* parse_sample(const char *p, bench_sample_t *s)
+{
+    uint16_t   *dst[4] = { &s->r, &s->g, &s->b, &s->ir };
+    const char *q = parse_side(p, &s->side);
+
+    if (q && (q = parse_u16s(q, dst, 4)) != NULL && *q == ',')
+        return parse_color(q + 1, &s->label);
+    return NULL;
+}
+
+uint16_t color_bench_load_csv(const char *text)
+{
+    const char *p = text;
+
+    s_n = 0;
+    while (p && *p && s_n < COLOR_BENCH_MAX_SAMPLES)
+    {
+        bench_sample_t s;
+        const char    *q = parse_sample(p, &s);
+
+        if (q)
+            s_set[s_n++] = s;
+        p = skip_line(q ? q : p);
+    }
+
+    return s_n;
+}
+
+uint16_t color_bench_train_csv(const char *text)
+{
+    const uint8_t addr[2] = { BH1749_ADDR_LEFT, BH1749_ADDR_RIGHT };
+    const char   *p    = text;
+    uint16_t      rows = 0;
+
+    for (int s = 0; s < 2; s++)
+    {
+        for (int c = 0; c < COLOR_COUNT; c++)
+            color_stats_acc_reset(&s_acc[s][c]);
+    }
+    memset(s_ir_sum, 0, sizeof(s_ir_sum));
+    color_stats_reset();
+
+    while (p && *p)
+    {
+        bench_sample_t s;
+        const char    *q = parse_sample(p, &s);
+
+        if (q)
+        {
+            int i = (s.side == BH1749_ADDR_LEFT) ? 0 : 1;
+            color_stats_acc_add(&s_acc[i][s.label], s.r, s.g, s.b);
+            s_ir_sum[i][s.label] += s.ir;
+            rows++;
+        }
+        p = skip_line(q ? q : p);
+    }
+
+    // 캘리(calib_store_current)와 같은 경로: 평균 → reference, 평균/공분산 → 마할라노비스
+    for (int i = 0; i < 2; i++)
+    {
+        for (int c = 0; c < COLOR_COUNT; c++)
+        {
+            const color_stats_acc_t *a = &s_acc[i][c];
+            if (a->n < COLOR_STATS_MIN_SAMPLES)
+                continue;
+
+            double   var = (a->m2[0] + a->m2[1] + a->m2[2]) / a->n;
+            uint16_t sd  = (uint16_t)fmin(sqrt(var) + 0.5, 65535.0);
+            save_color_reference(addr[i], (color_t)c, (uint16_t)(a->mean[0] + 0.5),
+                                 (uint16_t)(a->mean[1] + 0.5), (uint16_t)(a->mean[2] + 0.5),
+                                 (uint16_t)(s_ir_sum[i][c] / a->n), a->n, sd);
+            (void)color_stats_fit(addr[i], (color_t)c, a);
+        }
+    }
+
+    color_ccm_fit();
+    color_rebuild_models(BH1749_ADDR_LEFT);
+    color_rebuild_models(BH1749_ADDR_RIGHT);
+    color_stats_activate();
+
+#if (_USE_COLOR_LUT == 1)
+    // LUT는 플래시에 생성 (캘리 종료와 같은 규칙)
+    color_lut_refresh();
+#endif
+
+    return rows;
+}
+
+static bool variant_available(bench_variant_t v)
+{
+    const uint8_t sides[2] = { BH1749_ADDR_LEFT, BH1749_ADDR_RIGHT };
+
+    for (int i = 0; i < 2; i++)
+    {
+        uint8_t ms = sides[i];
+        uint16_t d = 0;
+        ms = color_ccm_apply(ms, &d, &d, &d, &d);
+
+        if (v == BENCH_MAHAL && !color_stats_ready(ms)) return false;
+        if (v == BENCH_LUT   && !color_lut_ready(ms))   return false;
+    }
+    return true;
+}
+
+static inline color_t run_one(bench_variant_t v, const bench_sample_t *s)
+{
+    uint16_t r = s->r, g = s->g, b = s->b, ir = s->ir;
+    uint8_t  side = s->side;
+
+    switch (v)
+    {
+        case BENCH_FLOAT:
+            return classify_color_float(side, r, g, b);
+
+        case BENCH_FULL:
+            return classify_color_ex(side, r, g, b, ir).cls;
+
+        case BENCH_LUT:
+        {
+            color_t cls;
+            uint8_t conf;
+            side = color_ccm_apply(side, &r, &g, &b, &ir);
+            return color_lut_lookup(side, r, g, b, ir, &cls, &conf) ? cls : COLOR_UNKNOWN;
+        }
+
+        default:
+        {
+            static const color_cls_mode_t mode[] =
+            {
+                [BENCH_RGB] = COLOR_CLS_RGB, [BENCH_CHROMA] = COLOR_CLS_CHROMA, [BENCH_MAHAL] = COLOR_CLS_MAHAL
+            };
+            side = color_ccm_apply(side, &r, &g, &b, &ir);
+            return color_cls_search(side, mode[v], r, g, b, ir).cls;
+        }
+    }
+}
+
+static inline uint32_t cyc_to_ns(uint64_t cyc, uint32_t n)
+{
+    return (n == 0) ? 0 : (uint32_t)((cyc * 1000u) / ((uint64_t)(SystemCoreClock / 1000000u) * n));
+}
+
+static void print_confusion(void)
+{
+    uart_printf("  true\\pred ");
+    for (int c = 0; c < COLOR_COUNT; c++)
+        uart_printf("%4d", c);
+    uart_printf(" UNK\r\n");
+
+    for (int t = 0; t < COLOR_COUNT; t++)
+    {
+        uart_printf("  %-10.10s", color_to_string((color_t)t));
+        for (int c = 0; c <= COLOR_COUNT; c++)
+            uart_printf("%4u", s_conf[t][c]);
+        uart_printf("\r\n");
+    }
+}
+
+static void run_variant(bench_variant_t v)
+{
+    if (!variant_available(v))
+    {
+        uart_printf("[BENCH] %-6s skipped (model not ready)\r\n", s_variant_name[v]);
+        return;
+    }
+
+    memset(s_conf, 0, sizeof(s_conf));
+
+    // 정확도 (1회)
+    for (uint16_t i = 0; i < s_n; i++)
+    {
+        color_t p = run_one(v, &s_set[i]);
+        s_conf[s_set[i].label][(p < COLOR_COUNT) ? p : COLOR_COUNT]++;
+    }
+
+    // 속도 (분류 호출만, 반복 평균)
+    volatile color_t sink;
+    uint64_t cyc = 0;
+    for (uint32_t k = 0; k < COLOR_BENCH_REPEAT; k++)
+    {
+        for (uint16_t i = 0; i < s_n; i++)
+        {
+            uint32_t t0 = cycles();
+            sink = run_one(v, &s_set[i]);
+            cyc += cycles() - t0;
+        }
+    }
+    (void)sink;
+
+    uint32_t ok = 0, unk = 0;
+    for (int t = 0; t < COLOR_COUNT; t++)
+    {
+        ok  += s_conf[t][t];
+        unk += s_conf[t][COLOR_COUNT];
+    }
+
+    uart_printf("[BENCH] %-6s acc:%lu/%u (%lu.%lu%%) unknown:%lu  %lu ns/cls\r\n",
+                s_variant_name[v], (unsigned long)ok, s_n,
+                (unsigned long)(ok * 1000u / s_n) / 10u, (unsigned long)(ok * 1000u / s_n) % 10u,
+                (unsigned long)unk, (unsigned long)cyc_to_ns(cyc, s_n * COLOR_BENCH_REPEAT));
+    print_confusion();
+
+    // 클래스별 정밀도/재현율 (‰, 표본 없는 클래스는 -)
+    for (int c = 0; c < COLOR_COUNT; c++)
+    {
+        uint32_t tp = s_conf[c][c], actual = 0, predicted = 0;
+        for (int k = 0; k <= COLOR_COUNT; k++) actual += s_conf[c][k];
+        for (int k = 0; k < COLOR_COUNT; k++)  predicted += s_conf[k][c];
+        if (actual == 0 && predicted == 0)
+            continue;
+
+        uart_printf("  %-11s P:%4lu R:%4lu (n=%lu)\r\n", color_to_string((color_t)c),
+                    (unsigned long)(predicted ? tp * 1000u / predicted : 0),
+                    (unsigned long)(actual    ? tp * 1000u / actual    : 0),
+                    (unsigned long)actual);
+    }
+}
+
+static void run_helpers(void)
+{
+    // 분류 앞단에서 샘플마다 도는 보조 함수
+    volatile uint32_t sink = 0;
+    uint64_t cyc_b = 0, cyc_c = 0;
+
+    for (uint16_t i = 0; i < s_n; i++)
+    {
+        const bench_sample_t *s = &s_set[i];
+        uint16_t r = s->r, g = s->g, b = s->b, ir = s->ir;
+
+        uint32_t t0 = cycles();
+        sink += calculate_brightness(s->r, s->g, s->b);
+        uint32_t t1 = cycles();
+        sink += color_ccm_apply(s->side, &r, &g, &b, &ir);
+        uint32_t t2 = cycles();
+
+        cyc_b += t1 - t0;
+        cyc_c += t2 - t1;
+    }
+    (void)sink;
+
+    uart_printf("[BENCH] calculate_brightness %lu ns, ccm_apply %lu ns\r\n",
+                (unsigned long)cyc_to_ns(cyc_b, s_n), (unsigned long)cyc_to_ns(cyc_c, s_n));
+}
+
+void color_bench_run(void)
+{
+    if (s_n == 0)
+    {
+        uart_printf("[BENCH] no samples\r\n");
+        return;
+    }
+
+    cycles_init();
+    uart_printf("=== COLOR BENCH n=%u mode=%d ccm=%d @%luMHz ===\r\n", s_n,
+                (int)color_get_cls_mode(), (int)color_ccm_ready(),
+                (unsigned long)(SystemCoreClock / 1000000u));
+
+    for (int v = 0; v < BENCH_VARIANT_COUNT; v++)
+        run_variant((bench_variant_t)v);
+    run_helpers();
+}
+
+void color_bench_main(void)
+{
+#ifdef COLOR_BENCH_REFS_CSV
+    uart_printf("[BENCH] refs: %u rows\r\n", color_bench_load_refs_csv(COLOR_BENCH_REFS_CSV));
+#endif
+#ifdef COLOR_BENCH_TRAIN_CSV
+    uart_printf("[BENCH] train: %u rows\r\n", color_bench_train_csv(COLOR_BENCH_TRAIN_CSV));
+#endif
+#ifdef COLOR_BENCH_SAMPLES_CSV
+    uart_printf("[BENCH] samples: %u\r\n", color_bench_load_csv(COLOR_BENCH_SAMPLES_CSV));
+#endif
+    color_bench_run();
+}
+
+#endif /* _USE_COLOR_BENCH */
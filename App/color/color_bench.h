@@ -0,0 +1,48 @@
+/*
+ * color_bench.h
+ *
+ *  분류기 정확도/속도 벤치마크 (실제 App/color 코드로 실행)
+ *
+ *  라벨 CSV: side,R,G,B,IR,true_color   (side = L/R/0/1, 색 = 번호 또는 이름)
+ *    R/G/B/IR은 bh1749_read() 출력과 같은 스케일 (AE면 x1/35ms × 2^COLOR_AE_NORM_SHIFT)
+ *  reference CSV(선택): side,color,R,G,B,IR → RAM 테이블만 교체(플래시 불변)
+ *  변형(float/RGB/색도/마할라노비스/LUT/실사용 경로)별로 혼동행렬,
+ *  클래스별 정밀도/재현율, ns/분류를 UART로 출력해 나란히 비교한다.
+ *
+ *  기본 사용: Tools/color_bench 호스트 빌드 (CSV 파일을 읽어서 로드 + 실행)
+ *    build/color_bench -b samples.csv [-t train.csv] [-R refs.csv]
+ *  타깃 시간 측정(선택): ap_init에서 color_bench_main(), 데이터는 COLOR_BENCH_DATA_FILE 헤더의 문자열
+ *    #define COLOR_BENCH_SAMPLES_CSV  "L,1200,300,250,40,RED\n..."
+ *    #define COLOR_BENCH_REFS_CSV     "..."        (없으면 플래시 테이블 사용)
+ *    #define COLOR_BENCH_TRAIN_CSV    "..."        (같은 형식. 있으면 통계/LUT를 학습해 mahal/lut도 측정)
+ */
+
+#ifndef COLOR_COLOR_BENCH_H_
+#define COLOR_COLOR_BENCH_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+// 1 = 벤치마크 코드 포함 (호스트 빌드는 Makefile에서 켬, 타깃은 ap_init에서 실행)
+#ifndef _USE_COLOR_BENCH
+#define _USE_COLOR_BENCH            0
+#endif
+
+#define COLOR_BENCH_MAX_SAMPLES     512U
+#define COLOR_BENCH_REPEAT          4U          // 시간 측정 반복 (캐시/분기 예측 안정화)
+
+
+uint16_t color_bench_load_refs_csv(const char *text);      // 반영된 행 수
+uint16_t color_bench_load_csv(const char *text);           // 읽은 샘플 수
+// 같은 형식의 학습 CSV로 캘리 경로를 재현: 클래스 평균 → reference, 공분산 → 통계(RAM),
+// 그리고 LUT 생성. mahal/lut/full 변형이 이걸로 켜진다 (LUT 페이지를 다시 쓰므로 타깃은 벤치 후 재캘리)
+uint16_t color_bench_train_csv(const char *text);          // 누적한 행 수
+void     color_bench_run(void);
+
+// 타깃용: COLOR_BENCH_DATA_FILE 데이터로 로드 + 실행
+void     color_bench_main(void);
+
+
+#endif /* COLOR_COLOR_BENCH_H_ */
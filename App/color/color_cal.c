@@ -0,0 +1,231 @@
+/*
+ * color_cal.c
+ *
+ *  캘리브레이션 프로필 저장 (A/B 원자적 저장, 압축 레코드)
+ */
+
+
+#include "color_cal.h"
+#include "color_ae.h"
+#include "flash.h"
+#include "uart.h"
+
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t prof_size;     // sizeof(color_cal_profile_t)
+    uint32_t seq;
+    uint32_t crc;           // 유효 프로필들 CRC32 (번호 순으로 이어서)
+    uint16_t valid;         // 프로필별 비트
+    uint8_t  count;         // COLOR_CAL_PROFILES
+    uint8_t  active;
+    uint32_t _rsv[3];
+} cal_hdr_t;
+
+#define CAL_PROF_ADDR(slot, i)  ((slot) + sizeof(cal_hdr_t) + (uint32_t)(i) * sizeof(color_cal_profile_t))
+
+// 캘리 전에도 대략 분류되도록 쓰는 기본 reference. 실측이 아니라 표준 매트 색을
+// gain x1 / 35ms 원시 카운트로 어림한 공칭값 (Tools/line_sim 팔레트와 같은 값).
+// bh1749_read()와 같은 스케일이 되도록 AE면 color_cal_default_raw()에서 2^COLOR_AE_NORM_SHIFT 배
+static const rgb_raw_t k_default_raw[COLOR_COUNT] =
+{
+    [COLOR_RED]         = {  820,  210,  190, 300 },
+    [COLOR_ORANGE]      = {  900,  420,  200, 300 },
+    [COLOR_YELLOW]      = {  980,  900,  260, 300 },
+    [COLOR_GREEN]       = {  260,  560,  300, 250 },
+    [COLOR_BLUE]        = {  200,  330,  700, 250 },
+    [COLOR_PURPLE]      = {  420,  260,  520, 260 },
+    [COLOR_LIGHT_GREEN] = {  600,  900,  420, 280 },
+    [COLOR_SKY_BLUE]    = {  420,  760,  900, 280 },
+    [COLOR_PINK]        = {  950,  520,  640, 300 },
+    [COLOR_BLACK]       = {   70,   80,   65,  60 },
+    [COLOR_WHITE]       = { 1100, 1250, 1000, 320 },
+    [COLOR_GRAY]        = {  450,  500,  420, 180 },
+};
+
+
+_Static_assert(sizeof(cal_hdr_t) % 8 == 0, "cal header must be doubleword aligned");
+_Static_assert(sizeof(color_cal_ref_t) == 12, "cal record must stay packed");
+_Static_assert(sizeof(color_cal_profile_t) % 8 == 0, "cal profile must be doubleword aligned");
+_Static_assert(COLOR_CAL_PROFILES <= 16, "valid mask is 16 bits");
+_Static_assert(CAL_PROF_ADDR(0, COLOR_CAL_PROFILES) <= FLASH_PAGE_SIZE, "cal profiles exceed a page");
+
+
+static inline const cal_hdr_t* slot_hdr(uint32_t slot)
+{
+    return (const cal_hdr_t*)(uintptr_t)slot;
+}
+
+static inline const color_cal_profile_t* slot_prof(uint32_t slot, uint8_t i)
+{
+    return (const color_cal_profile_t*)(uintptr_t)CAL_PROF_ADDR(slot, i);
+}
+
+// 유효 프로필을 번호 순으로 이어서 CRC (src(i) = i번 프로필 내용)
+static uint32_t profiles_crc(uint16_t valid, uint32_t slot, uint8_t repl_idx, const color_cal_profile_t *repl)
+{
+    uint32_t crc = 0;
+
+    for (uint8_t i = 0; i < COLOR_CAL_PROFILES; i++)
+    {
+        if (!(valid & (1u << i)))
+            continue;
+        const color_cal_profile_t *p = (repl && i == repl_idx) ? repl : slot_prof(slot, i);
+        crc = flash_crc32(crc, p, sizeof(*p));
+    }
+    return crc;
+}
+
+static bool slot_valid(uint32_t slot)
+{
+    const cal_hdr_t *h = slot_hdr(slot);
+
+    if (h->magic != COLOR_CAL_MAGIC || h->version != COLOR_CAL_VERSION ||
+        h->prof_size != sizeof(color_cal_profile_t) || h->count != COLOR_CAL_PROFILES ||
+        h->active >= COLOR_CAL_PROFILES)
+        return false;
+
+    return profiles_crc(h->valid, slot, 0, NULL) == h->crc;
+}
+
+// 최신 유효 슬롯 (없으면 0)
+static uint32_t latest_slot(void)
+{
+    bool a = slot_valid(COLOR_CAL_ADDR_A);
+    bool b = slot_valid(COLOR_CAL_ADDR_B);
+
+    if (a && b)
+        return (slot_hdr(COLOR_CAL_ADDR_B)->seq > slot_hdr(COLOR_CAL_ADDR_A)->seq)
+             ? COLOR_CAL_ADDR_B : COLOR_CAL_ADDR_A;
+    if (a) return COLOR_CAL_ADDR_A;
+    if (b) return COLOR_CAL_ADDR_B;
+    return 0;
+}
+
+// 현재 페이지 + (idx 교체) → 다른 슬롯에 새 페이지
+static bool write_slot(uint8_t idx, const color_cal_profile_t *prof, uint8_t active)
+{
+    uint32_t cur   = latest_slot();
+    uint32_t slot  = (cur == COLOR_CAL_ADDR_A) ? COLOR_CAL_ADDR_B : COLOR_CAL_ADDR_A;
+    uint16_t valid = cur ? slot_hdr(cur)->valid : 0u;
+
+    if (prof)
+        valid |= (uint16_t)(1u << idx);
+
+    cal_hdr_t hdr;
+    memset(&hdr, 0xFF, sizeof(hdr));
+    hdr.magic     = COLOR_CAL_MAGIC;
+    hdr.version   = COLOR_CAL_VERSION;
+    hdr.prof_size = sizeof(color_cal_profile_t);
+    hdr.seq       = cur ? (slot_hdr(cur)->seq + 1u) : 1u;
+    hdr.crc       = profiles_crc(valid, cur, idx, prof);
+    hdr.valid     = valid;
+    hdr.count     = COLOR_CAL_PROFILES;
+    hdr.active    = active;
+
+    if (!flash_erase_pages(slot, 1))
+        return false;
+
+    // 프로필 먼저 (빈 칸은 지워진 채로)
+    for (uint8_t i = 0; i < COLOR_CAL_PROFILES; i++)
+    {
+        if (!(valid & (1u << i)))
+            continue;
+        const color_cal_profile_t *p = (prof && i == idx) ? prof : slot_prof(cur, i);
+        if (!flash_program(CAL_PROF_ADDR(slot, i), p, sizeof(*p)))
+            return false;
+    }
+
+    // 헤더 = 커밋
+    if (!flash_program(slot, &hdr, sizeof(hdr)) || !slot_valid(slot))
+    {
+        uart_printf("[CAL] blob write failed (slot %c)\r\n", slot == COLOR_CAL_ADDR_A ? 'A' : 'B');
+        return false;
+    }
+
+    uart_printf("[CAL] blob saved: slot %c seq=%lu profile %u/%u\r\n",
+                slot == COLOR_CAL_ADDR_A ? 'A' : 'B', (unsigned long)hdr.seq,
+                (unsigned)active, (unsigned)COLOR_CAL_PROFILES);
+    return true;
+}
+
+bool color_cal_load(uint8_t idx, color_cal_profile_t *out)
+{
+    uint32_t slot = latest_slot();
+
+    if (slot == 0 || idx >= COLOR_CAL_PROFILES || !(slot_hdr(slot)->valid & (1u << idx)))
+        return false;
+
+    memcpy(out, slot_prof(slot, idx), sizeof(*out));
+    return true;
+}
+
+uint8_t color_cal_active(void)
+{
+    uint32_t slot = latest_slot();
+    return slot ? slot_hdr(slot)->active : 0u;
+}
+
+bool color_cal_present(void)
+{
+    return latest_slot() != 0;
+}
+
+bool color_cal_save(uint8_t idx, const color_cal_profile_t *prof)
+{
+    if (idx >= COLOR_CAL_PROFILES || prof == NULL)
+        return false;
+    return write_slot(idx, prof, idx);
+}
+
+bool color_cal_select(uint8_t idx)
+{
+    if (idx >= COLOR_CAL_PROFILES)
+        return false;
+    if (color_cal_active() == idx)
+        return true;
+    return write_slot(idx, NULL, idx);
+}
+
+rgb_raw_t color_cal_default_raw(color_t color)
+{
+    rgb_raw_t v = k_default_raw[(color < COLOR_COUNT) ? color : COLOR_GRAY];
+
+#if (_USE_COLOR_AE == 1)
+    v.red_raw   = (uint16_t)(v.red_raw   << COLOR_AE_NORM_SHIFT);
+    v.green_raw = (uint16_t)(v.green_raw << COLOR_AE_NORM_SHIFT);
+    v.blue_raw  = (uint16_t)(v.blue_raw  << COLOR_AE_NORM_SHIFT);
+    v.ir_raw    = (uint16_t)(v.ir_raw    << COLOR_AE_NORM_SHIFT);
+#endif
+    return v;
+}
+
+void debug_print_color_cal(void)
+{
+    static const uint32_t slots[2] = { COLOR_CAL_ADDR_A, COLOR_CAL_ADDR_B };
+    uint32_t cur = latest_slot();
+
+    uart_printf("=== CAL BLOB (v%u, %u B/profile) ===\r\n",
+                (unsigned)COLOR_CAL_VERSION, (unsigned)sizeof(color_cal_profile_t));
+    for (int i = 0; i < 2; i++)
+    {
+        const cal_hdr_t *h = slot_hdr(slots[i]);
+        bool ok = slot_valid(slots[i]);
+
+        uart_printf("slot %c: %s seq=%lu%s\r\n", 'A' + i,
+                    ok ? "valid" : (h->magic == COLOR_CAL_MAGIC ? "CORRUPT/OLD" : "empty"),
+                    ok ? (unsigned long)h->seq : 0UL, (slots[i] == cur) ? " <- active" : "");
+    }
+    if (cur == 0)
+        return;
+
+    for (uint8_t i = 0; i < COLOR_CAL_PROFILES; i++)
+    {
+        if (!(slot_hdr(cur)->valid & (1u << i)))
+            continue;
+        uart_printf("  profile %u: %.*s%s\r\n", (unsigned)i, (int)COLOR_CAL_NAME_LEN,
+                    slot_prof(cur, i)->name, (i == slot_hdr(cur)->active) ? " *" : "");
+    }
+}
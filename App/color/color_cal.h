@@ -0,0 +1,68 @@
+/*
+ * color_cal.h
+ *
+ *  캘리브레이션 프로필 저장 (A/B 원자적 저장, 압축 레코드)
+ *
+ *  한 페이지에 프로필(매트별 등) COLOR_CAL_PROFILES개를 담는다.
+ *  - 프로필 = 이름 + 좌/우 색별 12 B 레코드 (16비트 raw, 클래스 ID 바이트, 샘플 수/편차)
+ *    밝기 offset, 분류 모델 등 파생 값은 저장하지 않고 로드 시 다시 계산
+ *  - 헤더: magic, 형식 버전, 레코드 크기, seq, 활성 프로필, 유효 마스크, 내용 CRC32 (하드웨어 CRC)
+ *  - 두 페이지 A/B 중 오래된 쪽을 지우고 프로필 → 헤더 순으로 기록
+ *    → 끊겨도 이전 페이지가 그대로 남아 있음 (헤더가 곧 커밋)
+ *  레코드 형식이 바뀌면 COLOR_CAL_VERSION을 올린다 (이전 블롭 무시).
+ */
+
+#ifndef COLOR_COLOR_CAL_H_
+#define COLOR_COLOR_CAL_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#define COLOR_CAL_ADDR_A        ((uint32_t)0x080DC000)      // 드리프트 로그 아래 2 페이지
+#define COLOR_CAL_ADDR_B        ((uint32_t)0x080DD000)
+#define COLOR_CAL_MAGIC         0x324C4143UL                // "CAL2"
+#define COLOR_CAL_VERSION       2U
+
+#define COLOR_CAL_PROFILES      8U
+#define COLOR_CAL_NAME_LEN      8U
+#define COLOR_CAL_CLS_EMPTY     0xFFU
+
+
+// 색 1개 (12 B)
+typedef struct
+{
+    uint16_t r, g, b, ir;   // 평균 raw
+    uint8_t  cls;           // color_t, COLOR_CAL_CLS_EMPTY = 빈 칸
+    uint8_t  n;             // 샘플 수 (255 포화)
+    uint16_t spread;        // 샘플 RMS 편차
+} color_cal_ref_t;
+
+// [0] = LEFT, [1] = RIGHT (296 B)
+typedef struct
+{
+    char            name[COLOR_CAL_NAME_LEN];
+    color_cal_ref_t ref[2][COLOR_COUNT];
+} color_cal_profile_t;
+
+
+// 저장된 프로필 idx를 out에 복사. 없거나 블롭이 깨졌으면 false
+bool    color_cal_load(uint8_t idx, color_cal_profile_t *out);
+// 현재 활성 프로필 번호 (블롭 없으면 0)
+uint8_t color_cal_active(void);
+// 유효한 블롭이 있는지 (없으면 아직 이전 형식에서 옮겨 오기 전)
+bool    color_cal_present(void);
+
+// 프로필 idx 교체 + 활성으로 (비활성 슬롯에 기록 후 다시 검증)
+bool    color_cal_save(uint8_t idx, const color_cal_profile_t *prof);
+// 활성 프로필만 변경 (비어 있어도 됨 → 다음 캘리가 여기에 저장)
+bool    color_cal_select(uint8_t idx);
+
+// 캘리 전 임시 reference (표준 매트 공칭값)
+rgb_raw_t color_cal_default_raw(color_t color);
+
+void    debug_print_color_cal(void);
+
+
+#endif /* COLOR_COLOR_CAL_H_ */
@@ -0,0 +1,187 @@
+/*
+ * color_ccm.c
+ *
+ *  좌/우 센서 정렬용 3x3 색 보정 행렬
+ */
+
+
+#include "color_ccm.h"
+#include "color_cls.h"
+#include "uart.h"
+
+
+#if (_USE_COLOR_CCM == 1)
+
+#define CCM_MIN_PAIRS   6U
+
+static color_ccm_t s_ccm_right;
+static bool        s_ready = false;
+static uint16_t    s_resid_pm = 0;          // 잔차 (‰, 디버그용)
+
+
+static inline bool entry_valid(const reference_entry_t *e, int idx)
+{
+    // 지워진 플래시(0xFF..)/다른 색 슬롯은 제외
+    return (e->color == (color_t)idx) &&
+           !(e->raw.red_raw == 0xFFFFu && e->raw.green_raw == 0xFFFFu && e->raw.blue_raw == 0xFFFFu);
+}
+
+static int32_t to_q12(double v)
+{
+    return (int32_t)((v >= 0.0) ? (v * COLOR_CCM_ONE + 0.5) : (v * COLOR_CCM_ONE - 0.5));
+}
+
+bool color_ccm_fit(void)
+{
+    const reference_entry_t *ref = color_side_table(COLOR_CCM_MODEL_SIDE);
+    const reference_entry_t *src = color_side_table(BH1749_ADDR_RIGHT);
+
+    // 정규방정식: M = (Σ y xᵀ)(Σ x xᵀ)⁻¹   (x = RIGHT, y = LEFT)
+    double   A[3][3] = { { 0 } }, B[3][3] = { { 0 } };
+    double   ir_x = 0.0, ir_y = 0.0, y_sum = 0.0;
+    uint32_t n = 0;
+
+    s_ready = false;
+
+    for (int i = 0; i < COLOR_COUNT; i++)
+    {
+        if (!entry_valid(&ref[i], i) || !entry_valid(&src[i], i))
+            continue;
+
+        const double x[3] = { src[i].raw.red_raw, src[i].raw.green_raw, src[i].raw.blue_raw };
+        const double y[3] = { ref[i].raw.red_raw, ref[i].raw.green_raw, ref[i].raw.blue_raw };
+
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                A[r][c] += x[r] * x[c];
+                B[r][c] += y[r] * x[c];
+            }
+        }
+        ir_x  += src[i].raw.ir_raw;
+        ir_y  += ref[i].raw.ir_raw;
+        y_sum += y[0] + y[1] + y[2];
+        n++;
+    }
+
+    if (n < CCM_MIN_PAIRS)
+        return false;
+
+    // 3x3 역행렬 (여인수)
+    double inv[3][3];
+    inv[0][0] =   A[1][1] * A[2][2] - A[1][2] * A[2][1];
+    inv[0][1] = -(A[0][1] * A[2][2] - A[0][2] * A[2][1]);
+    inv[0][2] =   A[0][1] * A[1][2] - A[0][2] * A[1][1];
+    inv[1][0] = -(A[1][0] * A[2][2] - A[1][2] * A[2][0]);
+    inv[1][1] =   A[0][0] * A[2][2] - A[0][2] * A[2][0];
+    inv[1][2] = -(A[0][0] * A[1][2] - A[0][2] * A[1][0]);
+    inv[2][0] =   A[1][0] * A[2][1] - A[1][1] * A[2][0];
+    inv[2][1] = -(A[0][0] * A[2][1] - A[0][1] * A[2][0]);
+    inv[2][2] =   A[0][0] * A[1][1] - A[0][1] * A[1][0];
+
+    double det = A[0][0] * inv[0][0] + A[0][1] * inv[1][0] + A[0][2] * inv[2][0];
+    double tr  = A[0][0] + A[1][1] + A[2][2];
+    if (det <= 1e-9 * tr * tr * tr)
+        return false;                       // 색이 한 축에 몰림(거의 특이)
+
+    double M[3][3];
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            M[r][c] = (B[r][0] * inv[0][c] + B[r][1] * inv[1][c] + B[r][2] * inv[2][c]) / det;
+        }
+        if (M[r][r] < COLOR_CCM_DIAG_MIN || M[r][r] > COLOR_CCM_DIAG_MAX)
+            return false;
+    }
+
+    // 잔차: RMS |Mx - y| / 평균 |y|(채널합)
+    double e2 = 0.0;
+    for (int i = 0; i < COLOR_COUNT; i++)
+    {
+        if (!entry_valid(&ref[i], i) || !entry_valid(&src[i], i))
+            continue;
+
+        const double x[3] = { src[i].raw.red_raw, src[i].raw.green_raw, src[i].raw.blue_raw };
+        const double y[3] = { ref[i].raw.red_raw, ref[i].raw.green_raw, ref[i].raw.blue_raw };
+        for (int r = 0; r < 3; r++)
+        {
+            double d = M[r][0] * x[0] + M[r][1] * x[1] + M[r][2] * x[2] - y[r];
+            e2 += d * d;
+        }
+    }
+
+    double y_mean = y_sum / n;
+    double resid  = (y_mean > 0.0) ? (color_isqrt64((uint64_t)(e2 / n)) / y_mean) : 1.0;
+    s_resid_pm = (uint16_t)((resid > 65.535) ? 65535u : (resid * 1000.0 + 0.5));
+    if (resid > COLOR_CCM_RESID_MAX)
+        return false;
+
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 3; c++)
+            s_ccm_right.m[r * 3 + c] = to_q12(M[r][c]);
+    s_ccm_right.ir = (ir_x > 0.0) ? to_q12(ir_y / ir_x) : COLOR_CCM_ONE;
+
+    s_ready = true;
+    return true;
+}
+
+bool color_ccm_ready(void)
+{
+    return s_ready;
+}
+
+static inline uint16_t sat_q12(int64_t acc)
+{
+    acc = (acc + (COLOR_CCM_ONE >> 1)) >> COLOR_CCM_SHIFT;
+    if (acc < 0)      return 0;
+    if (acc > 0xFFFF) return 0xFFFFu;
+    return (uint16_t)acc;
+}
+
+uint8_t color_ccm_apply(uint8_t side, uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *ir)
+{
+    if (!s_ready)
+        return side;                        // 좌/우 개별 모델
+    if (side == COLOR_CCM_MODEL_SIDE)
+        return side;                        // 단위행렬
+
+    const int32_t *m = s_ccm_right.m;
+    const int64_t  x0 = *r, x1 = *g, x2 = *b;
+
+    *r  = sat_q12(m[0] * x0 + m[1] * x1 + m[2] * x2);
+    *g  = sat_q12(m[3] * x0 + m[4] * x1 + m[5] * x2);
+    *b  = sat_q12(m[6] * x0 + m[7] * x1 + m[8] * x2);
+    *ir = sat_q12((int64_t)s_ccm_right.ir * *ir);
+
+    return COLOR_CCM_MODEL_SIDE;
+}
+
+void debug_print_color_ccm(void)
+{
+    if (!s_ready)
+    {
+        uart_printf("=== COLOR CCM: off (resid %u.%u%%) ===\r\n", s_resid_pm / 10u, s_resid_pm % 10u);
+        return;
+    }
+
+    const int32_t *m = s_ccm_right.m;
+    uart_printf("=== COLOR CCM RIGHT->LEFT (Q12, resid %u.%u%%) ===\r\n", s_resid_pm / 10u, s_resid_pm % 10u);
+    for (int r = 0; r < 3; r++)
+        uart_printf("  %6ld %6ld %6ld\r\n", (long)m[r * 3], (long)m[r * 3 + 1], (long)m[r * 3 + 2]);
+    uart_printf("  ir %6ld\r\n", (long)s_ccm_right.ir);
+}
+
+#else
+
+bool    color_ccm_fit(void)     { return false; }
+bool    color_ccm_ready(void)   { return false; }
+uint8_t color_ccm_apply(uint8_t side, uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *ir)
+{
+    (void)r; (void)g; (void)b; (void)ir;
+    return side;
+}
+void    debug_print_color_ccm(void) { }
+
+#endif
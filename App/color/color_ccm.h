@@ -0,0 +1,54 @@
+/*
+ * color_ccm.h
+ *
+ *  좌/우 센서 정렬용 3x3 색 보정 행렬(CCM)
+ *
+ *  캘리 12색으로 RIGHT → LEFT 공간 최소제곱 행렬을 구해(LEFT는 단위행렬)
+ *  두 센서가 LEFT의 reference/통계/LUT 하나를 같이 쓰게 한다.
+ *  → 좌/우 판정이 같은 경계를 공유해 불일치가 줄고, RIGHT LUT는 만들지 않는다.
+ *  행렬은 캘리 테이블에서 부팅 때마다 다시 구하므로 별도 저장 없음.
+ *  적용은 Q12 정수 곱셈-누산 9번 + IR 스케일 1번.
+ */
+
+#ifndef COLOR_COLOR_CCM_H_
+#define COLOR_COLOR_CCM_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#ifndef _USE_COLOR_CCM
+#define _USE_COLOR_CCM              1
+#endif
+
+#define COLOR_CCM_SHIFT             12U
+#define COLOR_CCM_ONE               (1 << COLOR_CCM_SHIFT)
+
+// 공유 모델이 있는 쪽 (이 센서의 CCM = 단위행렬)
+#define COLOR_CCM_MODEL_SIDE        BH1749_ADDR_LEFT
+
+// 이상 행렬 거부: 대각 성분 범위, 잔차(RMS / 평균 밝기) 상한
+#define COLOR_CCM_DIAG_MIN          0.25
+#define COLOR_CCM_DIAG_MAX          4.0
+#define COLOR_CCM_RESID_MAX         0.15
+
+
+typedef struct
+{
+    int32_t m[9];           // Q12, 행 우선 (r', g', b')
+    int32_t ir;             // Q12 IR 스케일
+} color_ccm_t;
+
+
+// 현재 RAM reference 테이블(캘리 값)로 행렬 계산. 실패하면 좌/우 개별 모델 사용
+bool     color_ccm_fit(void);
+bool     color_ccm_ready(void);
+
+// side 샘플을 공유 공간으로 변환하고 분류에 쓸 모델 쪽을 돌려줌
+uint8_t  color_ccm_apply(uint8_t side, uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *ir);
+
+void     debug_print_color_ccm(void);
+
+
+#endif /* COLOR_COLOR_CCM_H_ */
@@ -0,0 +1,533 @@
+/*
+ * color_cls.c
+ *
+ *  정수 최근접 색 분류기
+ */
+
+
+#include "color_cls.h"
+#include "color_stats.h"
+#include "utils.h"
+#include "uart.h"
+
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define COLOR_CLS_USE_DSP   1
+#else
+#define COLOR_CLS_USE_DSP   0
+#endif
+
+
+uint32_t color_isqrt64(uint64_t x)
+{
+    uint64_t r = 0, bit = 1ULL << 62;
+
+    while (bit > x) bit >>= 2;
+    while (bit)
+    {
+        if (x >= r + bit)
+        {
+            x -= r + bit;
+            r  = (r >> 1) + bit;
+        }
+        else
+        {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// 최근접 이웃 제곱거리 → 거부 제곱거리 (반경 RADIUS_Q8/256배, 32비트 포화)
+static uint32_t reject_from_nn(uint64_t nn)
+{
+    if (nn == UINT64_MAX)
+        return UINT32_MAX;              // 클래스 1개: 거부 없음
+
+    uint64_t r = (nn >> 8) * COLOR_REJECT_RADIUS_Q8 * COLOR_REJECT_RADIUS_Q8 >> 8;
+    return (r > UINT32_MAX) ? UINT32_MAX : (uint32_t)r;
+}
+
+void color_cls_build(color_soa_t *m, const reference_entry_t *tbl, uint8_t n)
+{
+    if (n > COLOR_COUNT) n = COLOR_COUNT;
+
+    uint16_t or_all = 0;
+    uint8_t  k      = 0;
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        if (tbl[i].color >= COLOR_COUNT)
+            continue;                   // 지워진/깨진 항목 (0xFF 등)은 제외
+
+        uint16_t r = tbl[i].raw.red_raw;
+        uint16_t g = tbl[i].raw.green_raw;
+        uint16_t b = tbl[i].raw.blue_raw;
+
+        m->rg[k]  = ((uint32_t)g << 16) | r;
+        m->b[k]   = b;
+        m->cls[k] = (uint8_t)tbl[i].color;
+        or_all   |= (uint16_t)(r | g | b);
+        k++;
+    }
+
+    n          = k;
+    m->n       = n;
+    m->simd_ok = ((or_all & 0x8000u) == 0);
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        uint64_t nn = UINT64_MAX;
+        for (uint8_t j = 0; j < n; j++)
+        {
+            if (j == i) continue;
+            int64_t dr = (int64_t)(m->rg[i] & 0xFFFFu) - (int64_t)(m->rg[j] & 0xFFFFu);
+            int64_t dg = (int64_t)(m->rg[i] >> 16)     - (int64_t)(m->rg[j] >> 16);
+            int64_t db = (int64_t)m->b[i]              - (int64_t)m->b[j];
+            uint64_t d = (uint64_t)(dr * dr + dg * dg + db * db);
+            if (d < nn) nn = d;
+        }
+        m->reject[m->cls[i]] = reject_from_nn(nn);
+    }
+}
+
+// FNV-1a: 패딩 제외, 필드만
+uint32_t color_ref_hash(const reference_entry_t *tbl)
+{
+    uint32_t h = 2166136261u;
+
+    for (int i = 0; i < COLOR_COUNT; i++)
+    {
+        const uint16_t v[5] = { tbl[i].raw.red_raw, tbl[i].raw.green_raw,
+                                tbl[i].raw.blue_raw, tbl[i].raw.ir_raw, (uint16_t)tbl[i].color };
+        for (int k = 0; k < 5; k++)
+        {
+            h = (h ^ (v[k] & 0xFFu)) * 16777619u;
+            h = (h ^ (v[k] >> 8))    * 16777619u;
+        }
+    }
+    return h;
+}
+
+// 마할라노비스 점수 차(Q8) → 0 ~ 15. 차 1.0 = 우도비 e^0.5
+uint8_t color_conf_from_score(int64_t s1, int64_t s2)
+{
+    if (s2 == INT64_MAX)
+        return 15;
+
+    int64_t q = (s2 - s1) >> 9;         // 2.0 단위
+    return (uint8_t)((q > 15) ? 15 : q);
+}
+
+// 1위/2위 거리 비 → 0(경계) ~ 15(확실)
+uint8_t color_conf_from_dist(uint64_t d1, uint64_t d2)
+{
+    if (d2 == UINT64_MAX || d2 == UINT32_MAX)
+        return 15;
+    if (d2 == 0)
+        return 0;
+    return (uint8_t)(15u - (uint32_t)((15u * d1) / d2));
+}
+
+/* ---------------- 색도 모드 ---------------- */
+
+// log2(y), Q8: 정수부 = 최상위 비트 위치, 소수부 = 그 아래 8비트 (선형 근사)
+static inline uint16_t ilog2_q8(uint32_t y)
+{
+    if (y == 0)
+        return 0;
+
+    uint32_t n    = 31u - (uint32_t)__builtin_clz(y);
+    uint32_t frac = (n >= 8) ? (y >> (n - 8)) : (y << (8 - n));
+    return (uint16_t)((n << 8) | (frac & 0xFFu));
+}
+
+static inline uint32_t ir_correct(uint16_t c, uint16_t ir, uint32_t k_q10)
+{
+    uint32_t leak = ((uint32_t)ir * k_q10) >> 10;
+    return (c > leak) ? (c - leak) : 0u;
+}
+
+void color_ir_correct(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t ir)
+{
+    *r = (uint16_t)ir_correct(*r, ir, COLOR_IR_K_R);
+    *g = (uint16_t)ir_correct(*g, ir, COLOR_IR_K_G);
+    *b = (uint16_t)ir_correct(*b, ir, COLOR_IR_K_B);
+}
+
+color_chroma_feat_t color_chroma_feat(uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
+{
+    color_chroma_feat_t f;
+
+    uint32_t rr  = ir_correct(r, ir, COLOR_IR_K_R);
+    uint32_t gg  = ir_correct(g, ir, COLOR_IR_K_G);
+    uint32_t bb  = ir_correct(b, ir, COLOR_IR_K_B);
+    uint32_t sum = rr + gg + bb;
+
+    if (sum == 0)
+    {
+        // 신호 없음: 무채색 중심 + 밝기 0
+        f.rc   = (uint16_t)(COLOR_CHROMA_ONE / 3u);
+        f.gc   = (uint16_t)(COLOR_CHROMA_ONE / 3u);
+        f.logy = 0;
+        return f;
+    }
+
+    f.rc   = (uint16_t)((rr * COLOR_CHROMA_ONE) / sum);
+    f.gc   = (uint16_t)((gg * COLOR_CHROMA_ONE) / sum);
+    f.logy = ilog2_q8(calculate_brightness((uint16_t)rr, (uint16_t)gg, (uint16_t)bb));
+    return f;
+}
+
+void color_chroma_build(color_chroma_soa_t *m, const reference_entry_t *tbl, uint8_t n)
+{
+    if (n > COLOR_COUNT) n = COLOR_COUNT;
+
+    uint8_t k = 0;
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        if (tbl[i].color >= COLOR_COUNT)
+            continue;
+
+        color_chroma_feat_t f = color_chroma_feat(tbl[i].raw.red_raw, tbl[i].raw.green_raw,
+                                                  tbl[i].raw.blue_raw, tbl[i].raw.ir_raw);
+        m->rg[k]   = ((uint32_t)f.gc << 16) | f.rc;
+        m->logy[k] = f.logy;
+        m->cls[k]  = (uint8_t)tbl[i].color;
+        k++;
+    }
+
+    n    = k;
+    m->n = n;
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        uint64_t nn = UINT64_MAX;
+        for (uint8_t j = 0; j < n; j++)
+        {
+            if (j == i) continue;
+            int32_t dr = (int32_t)(m->rg[i] & 0xFFFFu) - (int32_t)(m->rg[j] & 0xFFFFu);
+            int32_t dg = (int32_t)(m->rg[i] >> 16)     - (int32_t)(m->rg[j] >> 16);
+            int32_t dy = (int32_t)m->logy[i]           - (int32_t)m->logy[j];
+            uint64_t d = (uint64_t)(dr * dr + dg * dg) + ((uint32_t)(dy * dy) >> COLOR_CHROMA_LOGY_SHIFT);
+            if (d < nn) nn = d;
+        }
+        m->reject[m->cls[i]] = reject_from_nn(nn);
+    }
+}
+
+color_t color_chroma_nearest(const color_chroma_soa_t *m, color_chroma_feat_t f,
+                             uint32_t *out_dist)
+{
+    // 색도 값 ≤ 4096 → 16비트 부호 차이로 항상 표현 가능
+    const uint32_t s_rg = ((uint32_t)f.gc << 16) | f.rc;
+    uint32_t min_dist = UINT32_MAX;
+    color_t  best     = COLOR_GRAY;
+
+    for (uint8_t i = 0; i < m->n; i++)
+    {
+        int32_t dy = (int32_t)f.logy - (int32_t)m->logy[i];
+#if (COLOR_CLS_USE_DSP == 1)
+        uint32_t d_rg = __SSUB16(s_rg, m->rg[i]);
+        uint32_t dist = __SMUAD(d_rg, d_rg);
+#else
+        int32_t dr = (int32_t)(s_rg & 0xFFFFu) - (int32_t)(m->rg[i] & 0xFFFFu);
+        int32_t dg = (int32_t)(s_rg >> 16)     - (int32_t)(m->rg[i] >> 16);
+        uint32_t dist = (uint32_t)(dr * dr + dg * dg);
+#endif
+        dist += (uint32_t)(dy * dy) >> COLOR_CHROMA_LOGY_SHIFT;
+
+        if (dist < min_dist)
+        {
+            min_dist = dist;
+            best     = (color_t)m->cls[i];
+        }
+    }
+
+    if (out_dist) *out_dist = min_dist;
+    return best;
+}
+
+color_t color_chroma_nearest2(const color_chroma_soa_t *m, color_chroma_feat_t f,
+                              uint32_t *d1, uint32_t *d2)
+{
+    uint32_t best_d = UINT32_MAX, second_d = UINT32_MAX;
+    color_t  best   = COLOR_GRAY;
+
+    for (uint8_t i = 0; i < m->n; i++)
+    {
+        int32_t dr = (int32_t)f.rc   - (int32_t)(m->rg[i] & 0xFFFFu);
+        int32_t dg = (int32_t)f.gc   - (int32_t)(m->rg[i] >> 16);
+        int32_t dy = (int32_t)f.logy - (int32_t)m->logy[i];
+        uint32_t dist = (uint32_t)(dr * dr + dg * dg) + ((uint32_t)(dy * dy) >> COLOR_CHROMA_LOGY_SHIFT);
+
+        if (dist < best_d)
+        {
+            second_d = best_d;
+            best_d   = dist;
+            best     = (color_t)m->cls[i];
+        }
+        else if (dist < second_d)
+        {
+            second_d = dist;
+        }
+    }
+
+    if (d1) *d1 = best_d;
+    if (d2) *d2 = second_d;
+    return best;
+}
+
+// 이식형 경로: 64비트 누산 (입력 전체 범위에서 정확). d2 != NULL이면 2위 거리도
+static color_t nearest_portable(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b,
+                                uint64_t *d1, uint64_t *d2)
+{
+    uint64_t best_d = UINT64_MAX, second_d = UINT64_MAX;
+    color_t  best   = COLOR_GRAY;
+
+    for (uint8_t i = 0; i < m->n; i++)
+    {
+        int32_t dr = (int32_t)r - (int32_t)(m->rg[i] & 0xFFFFu);
+        int32_t dg = (int32_t)g - (int32_t)(m->rg[i] >> 16);
+        int32_t db = (int32_t)b - (int32_t)m->b[i];
+
+        uint64_t dist = (uint64_t)((int64_t)dr * dr) +
+                        (uint64_t)((int64_t)dg * dg) +
+                        (uint64_t)((int64_t)db * db);
+
+        if (dist < best_d)
+        {
+            second_d = best_d;
+            best_d   = dist;
+            best     = (color_t)m->cls[i];
+        }
+        else if (dist < second_d)
+        {
+            second_d = dist;
+        }
+    }
+
+    if (d1) *d1 = best_d;
+    if (d2) *d2 = second_d;
+    return best;
+}
+
+#if (COLOR_CLS_USE_DSP == 1)
+// DSP 경로: |차이| < 0x8000 보장 시. dr²+dg² ≤ 2·32767² < 2^31, + db² ≤ 3·32767² < 2^32
+// (실제 거리는 UINT32_MAX에 못 미치므로 UINT32_MAX = 후보 없음)
+static color_t nearest_dsp(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b,
+                           uint32_t *d1, uint32_t *d2)
+{
+    const uint32_t s_rg = ((uint32_t)g << 16) | r;
+    uint32_t best_d = UINT32_MAX, second_d = UINT32_MAX;
+    color_t  best   = COLOR_GRAY;
+
+    for (uint8_t i = 0; i < m->n; i++)
+    {
+        uint32_t d_rg = __SSUB16(s_rg, m->rg[i]);          // [dg | dr]
+        int32_t  db   = (int32_t)b - (int32_t)m->b[i];
+        uint32_t dist = __SMUAD(d_rg, d_rg) + (uint32_t)(db * db);
+
+        if (dist < best_d)
+        {
+            second_d = best_d;
+            best_d   = dist;
+            best     = (color_t)m->cls[i];
+        }
+        else if (dist < second_d)
+        {
+            second_d = dist;
+        }
+    }
+
+    if (d1) *d1 = best_d;
+    if (d2) *d2 = second_d;
+    return best;
+}
+
+static inline uint64_t widen_dist(uint32_t d)
+{
+    return (d == UINT32_MAX) ? UINT64_MAX : d;
+}
+#endif
+
+color_t color_cls_nearest2(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b,
+                           uint64_t *d1, uint64_t *d2)
+{
+#if (COLOR_CLS_USE_DSP == 1)
+    if (m->simd_ok && ((r | g | b) & 0x8000u) == 0)
+    {
+        uint32_t a1, a2;
+        color_t  c = nearest_dsp(m, r, g, b, &a1, d2 ? &a2 : NULL);
+        if (d1) *d1 = widen_dist(a1);
+        if (d2) *d2 = widen_dist(a2);
+        return c;
+    }
+#endif
+
+    return nearest_portable(m, r, g, b, d1, d2);
+}
+
+color_t color_cls_nearest(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b,
+                          uint32_t *out_dist)
+{
+    uint64_t d64;
+    color_t  c = color_cls_nearest2(m, r, g, b, &d64, NULL);
+    if (out_dist) *out_dist = (d64 > UINT32_MAX) ? UINT32_MAX : (uint32_t)d64;
+    return c;
+}
+
+color_t color_cls_nearest_ref(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b)
+{
+    return nearest_portable(m, r, g, b, NULL, NULL);
+}
+
+/* ---------------- 결과(클래스/신뢰도/여유/거부) ---------------- */
+
+static inline uint16_t sat_u16(uint64_t v)
+{
+    return (uint16_t)((v > 0xFFFFu) ? 0xFFFFu : v);
+}
+
+// 여유 = 2위 - 1위 제곱거리 / 2^COLOR_MARGIN_SHIFT (sqrt 없이, 마할라노비스 점수 차와 같은 제곱 단위)
+static inline uint16_t margin_sq(uint64_t d1, uint64_t d2)
+{
+    if (d2 == UINT64_MAX || d2 == UINT32_MAX)
+        return 0xFFFFu;
+    return sat_u16((d2 - d1) >> COLOR_MARGIN_SHIFT);
+}
+
+color_result_t color_cls_search(uint8_t side, color_cls_mode_t mode,
+                                uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
+{
+    color_result_t res = { COLOR_UNKNOWN, 0, 0 };
+
+    switch (mode)
+    {
+        case COLOR_CLS_MAHAL:
+        {
+            int64_t s1, s2;
+            res.cls    = color_stats_nearest2(side, r, g, b, &s1, &s2);
+            res.conf   = color_conf_from_score(s1, s2);
+            res.margin = (s2 == INT64_MAX) ? 0xFFFFu : sat_u16((uint64_t)(s2 - s1) >> 8);
+            if (!color_stats_accept(side, res.cls, s1))
+                res.cls = COLOR_UNKNOWN;
+            break;
+        }
+
+        case COLOR_CLS_CHROMA:
+        {
+            const color_chroma_soa_t *m = color_side_chroma(side);
+            uint32_t d1, d2;
+            res.cls    = color_chroma_nearest2(m, color_chroma_feat(r, g, b, ir), &d1, &d2);
+            res.conf   = color_conf_from_dist(d1, d2);
+            res.margin = margin_sq(d1, d2);
+            if (res.cls >= COLOR_COUNT || d1 > m->reject[res.cls])
+                res.cls = COLOR_UNKNOWN;
+            break;
+        }
+
+        default:
+        {
+            const color_soa_t *m = color_side_model(side);
+            uint64_t d1, d2;
+            res.cls    = color_cls_nearest2(m, r, g, b, &d1, &d2);
+            res.conf   = color_conf_from_dist(d1, d2);
+            res.margin = margin_sq(d1, d2);
+            if (res.cls >= COLOR_COUNT || d1 > m->reject[res.cls])
+                res.cls = COLOR_UNKNOWN;
+            break;
+        }
+    }
+
+    if (res.cls == COLOR_UNKNOWN)
+        res.conf = 0;
+    return res;
+}
+
+/* ---------------- 셀프테스트 / 벤치마크 ---------------- */
+
+static uint32_t s_lcg = 0x12345678u;
+
+static inline uint16_t rand_u16(uint16_t max)
+{
+    s_lcg = s_lcg * 1664525u + 1013904223u;
+    return (uint16_t)((s_lcg >> 8) % ((uint32_t)max + 1u));
+}
+
+// float 구현과의 불일치가 float 반올림에 의한 동률인지(정수로는 거리 차이가 미세한지) 판단
+static bool float_tie(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b,
+                      color_t a, color_t c)
+{
+    uint64_t da = 0, dc = 0;
+    for (uint8_t i = 0; i < m->n; i++)
+    {
+        int64_t dr = (int64_t)r - (int64_t)(m->rg[i] & 0xFFFFu);
+        int64_t dg = (int64_t)g - (int64_t)(m->rg[i] >> 16);
+        int64_t db = (int64_t)b - (int64_t)m->b[i];
+        uint64_t d = (uint64_t)(dr * dr + dg * dg + db * db);
+        if (m->cls[i] == (uint8_t)a) da = d;
+        if (m->cls[i] == (uint8_t)c) dc = d;
+    }
+    uint64_t diff = (da > dc) ? (da - dc) : (dc - da);
+    uint64_t mag  = (da > dc) ? da : dc;
+    return diff <= (mag >> 23);       // float 가수 24비트 한계 이내
+}
+
+// 반환: 불일치 수 (int!=ref64 + float 동률이 아닌 int!=float)
+static uint32_t selftest_side(uint8_t side, uint32_t n, uint16_t max_val)
+{
+    const color_soa_t *m = color_side_model(side);
+
+    uint32_t mism_ref = 0, mism_float = 0, float_ties = 0;
+    uint32_t cyc_int = 0, cyc_flt = 0;
+
+    for (uint32_t k = 0; k < n; k++)
+    {
+        uint16_t r = rand_u16(max_val);
+        uint16_t g = rand_u16(max_val);
+        uint16_t b = rand_u16(max_val);
+
+        uint32_t t0 = cycles();
+        color_t ci  = color_cls_nearest(m, r, g, b, NULL);
+        uint32_t t1 = cycles();
+        color_t cf  = classify_color_float(side, r, g, b);
+        uint32_t t2 = cycles();
+
+        cyc_int += t1 - t0;
+        cyc_flt += t2 - t1;
+
+        if (ci != color_cls_nearest_ref(m, r, g, b))
+            mism_ref++;
+
+        if (ci != cf)
+        {
+            if (float_tie(m, r, g, b, ci, cf)) float_ties++;
+            else                               mism_float++;
+        }
+    }
+
+    uart_printf("[CLS-TEST] side=0x%02X max=%u n=%lu simd=%d dsp=%d\r\n",
+                side, max_val, (unsigned long)n, (int)m->simd_ok, (int)COLOR_CLS_USE_DSP);
+    uart_printf("  int!=ref64:%lu  int!=float:%lu (+float ties:%lu)\r\n",
+                (unsigned long)mism_ref, (unsigned long)mism_float, (unsigned long)float_ties);
+    uart_printf("  cycles/cls  int:%lu  float:%lu\r\n",
+                (unsigned long)(cyc_int / (n ? n : 1)), (unsigned long)(cyc_flt / (n ? n : 1)));
+
+    return mism_ref + mism_float;
+}
+
+uint32_t color_cls_selftest(uint32_t n)
+{
+    uint32_t mism = 0;
+
+    cycles_init();
+
+    // 실사용 범위(15비트 이하: DSP 경로)와 전체 16비트 범위(이식형 경로) 모두 확인
+    mism += selftest_side(BH1749_ADDR_LEFT,  n, 0x7FFF);
+    mism += selftest_side(BH1749_ADDR_RIGHT, n, 0x7FFF);
+    mism += selftest_side(BH1749_ADDR_LEFT,  n, 0xFFFF);
+    return mism;
+}
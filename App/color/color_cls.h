@@ -0,0 +1,133 @@
+/*
+ * color_cls.h
+ *
+ *  정수 최근접 색 분류기 (reference 테이블 → SoA 패킹)
+ *
+ *  Cortex-M33 DSP 확장(__ARM_FEATURE_DSP)이 있으면 SSUB16/SMUAD로
+ *  R/G 두 채널의 차이·제곱합을 한 번에 계산, 없으면(호스트 빌드) 이식형 C 경로.
+ *  두 경로 모두 정확한 정수 제곱거리 → 결과 동일.
+ *
+ *  색도 모드(COLOR_CLS_CHROMA): IR 누설을 빼고 (r,g)/(r+g+b) 색도(Q12)와
+ *  log2 밝기(Q8)로 비교 → 조명 세기/센서 높이 변화에 덜 민감.
+ */
+
+#ifndef COLOR_COLOR_CLS_H_
+#define COLOR_COLOR_CLS_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+// 1 = ap_init에서 정확도/속도 셀프테스트 실행 (float 구현과 비교, UART 출력)
+#ifndef _USE_COLOR_SELFTEST
+#define _USE_COLOR_SELFTEST     0
+#endif
+
+
+// Structure-of-arrays: 루프가 연속 메모리만 읽도록
+typedef struct
+{
+    uint32_t rg[COLOR_COUNT];   // (G << 16) | R
+    uint16_t b[COLOR_COUNT];
+    uint8_t  cls[COLOR_COUNT];  // color_t
+    uint32_t reject[COLOR_COUNT];   // 클래스별 거부 제곱거리 (이보다 멀면 UNKNOWN)
+    uint8_t  n;
+    bool     simd_ok;           // 모든 값 < 0x8000 → 16비트 부호 차이로 표현 가능
+} color_soa_t;
+
+
+// color_result_t.margin (RGB/색도): 1·2위 제곱거리 차를 이만큼 내림
+#define COLOR_MARGIN_SHIFT          8
+
+// 개방집합 거부 반경: 가장 가까운 다른 reference까지 거리 × RADIUS (Q8, 192 = 0.75)
+#ifndef COLOR_REJECT_RADIUS_Q8
+#define COLOR_REJECT_RADIUS_Q8      192U
+#endif
+
+
+// ---- 색도 모드 ----
+#define COLOR_CHROMA_ONE            4096u   // 색도 Q12 (1.0)
+#define COLOR_CHROMA_LOGY_SHIFT     1       // 밝기(log2, Q8) 항 가중치 = 1/2
+
+// 채널별 IR 누설 계수 (Q10). c' = c - k*IR. 보드 실측으로 조정
+#ifndef COLOR_IR_K_R
+#define COLOR_IR_K_R                64      // ≈ 0.06
+#endif
+#ifndef COLOR_IR_K_G
+#define COLOR_IR_K_G                20      // ≈ 0.02
+#endif
+#ifndef COLOR_IR_K_B
+#define COLOR_IR_K_B                20      // ≈ 0.02
+#endif
+
+typedef struct
+{
+    uint16_t rc;        // r/(r+g+b), Q12
+    uint16_t gc;        // g/(r+g+b), Q12
+    uint16_t logy;      // log2(밝기), Q8 → 배율 변화는 상수 이동
+} color_chroma_feat_t;
+
+typedef struct
+{
+    uint32_t rg[COLOR_COUNT];   // (gc << 16) | rc
+    uint16_t logy[COLOR_COUNT];
+    uint8_t  cls[COLOR_COUNT];
+    uint32_t reject[COLOR_COUNT];
+    uint8_t  n;
+} color_chroma_soa_t;
+
+
+void    color_cls_build(color_soa_t *m, const reference_entry_t *tbl, uint8_t n);
+void    color_chroma_build(color_chroma_soa_t *m, const reference_entry_t *tbl, uint8_t n);
+
+// color.c가 보유한 좌/우 모델 (reference 테이블 로드/저장 시 재구성됨)
+const color_soa_t*        color_side_model(uint8_t left_right);
+const color_chroma_soa_t* color_side_chroma(uint8_t left_right);
+const reference_entry_t*  color_side_table(uint8_t left_right);     // [COLOR_COUNT]
+color_cls_mode_t          color_side_cls_mode(uint8_t left_right);  // 통계 없으면 MAHAL → CHROMA
+
+// 최근접 탐색 + 신뢰도/여유 + 클래스별 거부 (LUT 미사용 경로, LUT 생성에도 사용)
+color_result_t color_cls_search(uint8_t side, color_cls_mode_t mode,
+                                uint16_t r, uint16_t g, uint16_t b, uint16_t ir);
+
+// 분류 신뢰도 0(경계) ~ 15(확실): 1·2위 거리 비 / 마할라노비스 점수 차(Q8)
+uint8_t  color_conf_from_dist(uint64_t d1, uint64_t d2);
+uint8_t  color_conf_from_score(int64_t s1, int64_t s2);
+
+uint32_t color_isqrt64(uint64_t x);
+
+// 모델(SoA/색도/LUT 연결) 재구성, RAM reference만 교체(드리프트 추적용, 재구성은 별도)
+void     color_rebuild_models(uint8_t left_right);
+void     color_adapt_reference(uint8_t sensor_side, color_t color, rgb_raw_t raw);
+
+// reference 테이블 해시 (파생 데이터(LUT/통계)의 유효성 확인용)
+uint32_t color_ref_hash(const reference_entry_t *tbl);
+
+// IR 누설 제거 (제자리, 0 하한)
+void    color_ir_correct(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t ir);
+// IR 보정 + 색도/밝기 특징 (고정소수점)
+color_chroma_feat_t color_chroma_feat(uint16_t r, uint16_t g, uint16_t b, uint16_t ir);
+color_t color_chroma_nearest(const color_chroma_soa_t *m, color_chroma_feat_t f,
+                             uint32_t *out_dist);
+
+// 1·2위 거리까지 반환 (신뢰도/거부 계산용). 후보가 없으면 UINT32_MAX / UINT64_MAX
+color_t color_chroma_nearest2(const color_chroma_soa_t *m, color_chroma_feat_t f,
+                              uint32_t *d1, uint32_t *d2);
+// RGB: DSP 가능(simd_ok + 입력 < 0x8000)하면 SSUB16/SMUAD 경로, 아니면 이식형. d2 = NULL 허용
+color_t color_cls_nearest2(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b,
+                           uint64_t *d1, uint64_t *d2);
+
+// 최근접 클래스. out_dist != NULL이면 최소 제곱거리(포화 0xFFFFFFFF) 반환
+color_t color_cls_nearest(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b,
+                          uint32_t *out_dist);
+
+// 기준 구현: 이식형 64비트 정수 (SIMD 경로 검증용)
+color_t color_cls_nearest_ref(const color_soa_t *m, uint16_t r, uint16_t g, uint16_t b);
+
+// 셀프테스트/벤치마크: n개의 의사난수 샘플로 float/정수/SIMD 비교, 반환 = 불일치 수
+// (호스트: Tools/color_bench -s n 이 이식형 경로를 같은 방식으로 확인)
+uint32_t color_cls_selftest(uint32_t n);
+
+
+#endif /* COLOR_COLOR_CLS_H_ */
@@ -0,0 +1,311 @@
+/*
+ * color_drift.c
+ *
+ *  reference 드리프트 추적
+ */
+
+
+#include "color_drift.h"
+#include "color_cls.h"
+#include "color_stats.h"
+#include "flash.h"
+#include "uart.h"
+
+
+#if (_USE_COLOR_DRIFT == 1)
+
+// 플래시 레코드: 양쪽 12색의 적응값 한 벌
+typedef struct
+{
+    uint32_t  magic;
+    uint32_t  seq;
+    uint32_t  anchor_hash[2];           // 기록 당시 캘리 테이블 해시
+    rgb_raw_t raw[2][COLOR_COUNT];
+} drift_rec_t;
+
+#define REC_SIZE        ((sizeof(drift_rec_t) + 7u) & ~7u)
+#define REC_SLOTS       (FLASH_PAGE_SIZE / REC_SIZE)
+
+static bool      s_on = (COLOR_DRIFT_DEFAULT_ON != 0);
+static bool      s_loaded = false;
+
+static rgb_raw_t s_anchor[2][COLOR_COUNT];
+static uint32_t  s_anchor_hash[2];
+static uint32_t  s_ewma[2][COLOR_COUNT][4];     // Q8: r, g, b, ir
+static rgb_raw_t s_saved[2][COLOR_COUNT];       // 마지막으로 저장(또는 복원)한 값
+static bool      s_dirty[2];
+
+static uint32_t  s_apply_ms = 0;
+static uint32_t  s_save_ms  = 0;
+static uint32_t  s_seq      = 0;
+static uint32_t  s_next_slot = 0;
+
+
+static inline uint8_t side_addr(int s)
+{
+    return (s == 0) ? BH1749_ADDR_LEFT : BH1749_ADDR_RIGHT;
+}
+
+static inline uint16_t anchor_ch(const rgb_raw_t *a, int k)
+{
+    switch (k)
+    {
+        case 0:  return a->red_raw;
+        case 1:  return a->green_raw;
+        case 2:  return a->blue_raw;
+        default: return a->ir_raw;
+    }
+}
+
+static inline rgb_raw_t ewma_raw(const uint32_t e[4])
+{
+    rgb_raw_t raw =
+    {
+        .red_raw   = (uint16_t)((e[0] + 0x80u) >> 8),
+        .green_raw = (uint16_t)((e[1] + 0x80u) >> 8),
+        .blue_raw  = (uint16_t)((e[2] + 0x80u) >> 8),
+        .ir_raw    = (uint16_t)((e[3] + 0x80u) >> 8),
+    };
+    return raw;
+}
+
+static inline const drift_rec_t* rec_at(uint32_t slot)
+{
+    return (const drift_rec_t*)(uintptr_t)(COLOR_DRIFT_ADDR + slot * REC_SIZE);
+}
+
+// 적응값을 RAM 테이블/통계 평균에 반영 후 모델 재구성
+static void apply_side(int s)
+{
+    uint8_t side = side_addr(s);
+
+    for (int c = 0; c < COLOR_COUNT; c++)
+    {
+        rgb_raw_t raw = ewma_raw(s_ewma[s][c]);
+        const uint16_t mean[3] = { raw.red_raw, raw.green_raw, raw.blue_raw };
+
+        color_adapt_reference(side, (color_t)c, raw);
+        color_stats_set_mean(side, (color_t)c, mean);
+    }
+    color_rebuild_models(side);
+}
+
+void color_drift_enable(bool on)
+{
+    if (on == s_on)
+        return;
+
+    if (on)
+    {
+        s_on = true;
+        color_drift_load();                 // 저장된 적응값 복원
+    }
+    else
+    {
+        // 캘리 값으로 되돌림 → 테이블 해시가 원래대로 → LUT 재사용
+        for (int s = 0; s < 2; s++)
+        {
+            for (int c = 0; c < COLOR_COUNT; c++)
+                for (int k = 0; k < 4; k++)
+                    s_ewma[s][c][k] = (uint32_t)anchor_ch(&s_anchor[s][c], k) << 8;
+            if (s_loaded)
+                apply_side(s);
+        }
+        s_on = false;
+    }
+    uart_printf("[DRIFT] %s\r\n", on ? "on" : "off");
+}
+
+bool color_drift_enabled(void)
+{
+    return s_on;
+}
+
+void color_drift_load(void)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        const reference_entry_t *tbl = color_side_table(side_addr(s));
+
+        s_anchor_hash[s] = color_ref_hash(tbl);
+        s_dirty[s]       = false;
+        for (int c = 0; c < COLOR_COUNT; c++)
+        {
+            s_anchor[s][c] = tbl[c].raw;
+            s_saved[s][c]  = tbl[c].raw;
+            for (int k = 0; k < 4; k++)
+                s_ewma[s][c][k] = (uint32_t)anchor_ch(&tbl[c].raw, k) << 8;
+        }
+    }
+
+    // 레코드는 앞에서부터 이어 쓰므로 첫 빈 슬롯 직전이 최신
+    const drift_rec_t *last = NULL;
+    s_next_slot = 0;
+    while (s_next_slot < REC_SLOTS && rec_at(s_next_slot)->magic == COLOR_DRIFT_MAGIC)
+    {
+        last = rec_at(s_next_slot);
+        s_next_slot++;
+    }
+    s_seq = last ? (last->seq + 1u) : 0u;
+
+    s_loaded = true;
+
+    if (!s_on || last == NULL ||
+        last->anchor_hash[0] != s_anchor_hash[0] ||
+        last->anchor_hash[1] != s_anchor_hash[1])
+        return;                                         // 없음 / 재캘리 이전 기록
+
+    for (int s = 0; s < 2; s++)
+    {
+        for (int c = 0; c < COLOR_COUNT; c++)
+        {
+            s_saved[s][c] = last->raw[s][c];
+            for (int k = 0; k < 4; k++)
+                s_ewma[s][c][k] = (uint32_t)anchor_ch(&last->raw[s][c], k) << 8;
+        }
+        apply_side(s);
+    }
+
+    uart_printf("[DRIFT] restored seq=%lu\r\n", (unsigned long)last->seq);
+}
+
+void color_drift_observe(uint8_t side, const color_result_t *res,
+                         uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
+{
+    if (!s_on || !s_loaded || res->cls >= COLOR_COUNT || res->conf < COLOR_DRIFT_MIN_CONF)
+        return;
+
+    const int       s = (side == BH1749_ADDR_LEFT) ? 0 : 1;
+    const uint16_t  x[4] = { r, g, b, ir };
+    uint32_t       *e = s_ewma[s][res->cls];
+
+    for (int k = 0; k < 4; k++)
+    {
+        int32_t a   = anchor_ch(&s_anchor[s][res->cls], k);
+        int32_t lim = (a * (int32_t)COLOR_DRIFT_MAX_PCT) / 100;
+        if (lim < (int32_t)COLOR_DRIFT_MAX_MIN) lim = COLOR_DRIFT_MAX_MIN;
+
+        int32_t v = (int32_t)e[k];
+        v += (((int32_t)x[k] << 8) - v) >> COLOR_DRIFT_ALPHA_SHIFT;
+
+        // 안전 범위: 앵커 ± lim
+        int32_t lo = (a - lim) << 8, hi = (a + lim) << 8;
+        if (lo < 0)  lo = 0;
+        if (v < lo)  v = lo;
+        if (v > hi)  v = hi;
+
+        e[k] = (uint32_t)v;
+    }
+    s_dirty[s] = true;
+}
+
+static bool moved_since_save(void)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        for (int c = 0; c < COLOR_COUNT; c++)
+        {
+            rgb_raw_t now = ewma_raw(s_ewma[s][c]);
+            for (int k = 0; k < 4; k++)
+            {
+                int32_t d = (int32_t)anchor_ch(&now, k) - (int32_t)anchor_ch(&s_saved[s][c], k);
+                if (d < 0) d = -d;
+                if (d >= (int32_t)COLOR_DRIFT_SAVE_DELTA)
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void save_record(void)
+{
+    static drift_rec_t rec;     // 스택 절약
+
+    memset(&rec, 0xFF, sizeof(rec));
+    rec.magic          = COLOR_DRIFT_MAGIC;
+    rec.seq            = s_seq;
+    rec.anchor_hash[0] = s_anchor_hash[0];
+    rec.anchor_hash[1] = s_anchor_hash[1];
+    for (int s = 0; s < 2; s++)
+        for (int c = 0; c < COLOR_COUNT; c++)
+            rec.raw[s][c] = ewma_raw(s_ewma[s][c]);
+
+    // 페이지가 가득 찼을 때만 삭제 → 삭제 1회당 REC_SLOTS번 저장
+    if (s_next_slot >= REC_SLOTS)
+    {
+        if (!flash_erase_pages(COLOR_DRIFT_ADDR, 1))
+            return;
+        s_next_slot = 0;
+    }
+
+    if (!flash_program(COLOR_DRIFT_ADDR + s_next_slot * REC_SIZE, &rec, REC_SIZE))
+        return;
+
+    memcpy(s_saved, rec.raw, sizeof(s_saved));
+    s_next_slot++;
+    s_seq++;
+
+    uart_printf("[DRIFT] saved seq=%lu slot=%lu/%u\r\n",
+                (unsigned long)rec.seq, (unsigned long)s_next_slot, (unsigned)REC_SLOTS);
+}
+
+void color_drift_service(void)
+{
+    if (!s_on || !s_loaded)
+        return;
+
+    uint32_t now = millis();
+
+    if ((s_dirty[0] || s_dirty[1]) && (now - s_apply_ms) >= COLOR_DRIFT_APPLY_MS)
+    {
+        s_apply_ms = now;
+        for (int s = 0; s < 2; s++)
+        {
+            if (s_dirty[s])
+            {
+                apply_side(s);
+                s_dirty[s] = false;
+            }
+        }
+    }
+
+    if ((now - s_save_ms) >= COLOR_DRIFT_SAVE_MIN_MS)
+    {
+        s_save_ms = now;
+        if (moved_since_save())
+            save_record();
+    }
+}
+
+void debug_print_color_drift(void)
+{
+    uart_printf("=== COLOR DRIFT (%s, seq=%lu) ===\r\n", s_on ? "on" : "off", (unsigned long)s_seq);
+    for (int s = 0; s < 2; s++)
+    {
+        for (int c = 0; c < COLOR_COUNT; c++)
+        {
+            rgb_raw_t now = ewma_raw(s_ewma[s][c]);
+            uart_printf("[%c %-11s] dR:%+5d dG:%+5d dB:%+5d\r\n", s == 0 ? 'L' : 'R',
+                        color_to_string((color_t)c),
+                        (int)now.red_raw   - (int)s_anchor[s][c].red_raw,
+                        (int)now.green_raw - (int)s_anchor[s][c].green_raw,
+                        (int)now.blue_raw  - (int)s_anchor[s][c].blue_raw);
+        }
+    }
+}
+
+#else
+
+void color_drift_enable(bool on)                { (void)on; }
+bool color_drift_enabled(void)                  { return false; }
+void color_drift_load(void)                     { }
+void color_drift_observe(uint8_t side, const color_result_t *res,
+                         uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
+{
+    (void)side; (void)res; (void)r; (void)g; (void)b; (void)ir;
+}
+void color_drift_service(void)                  { }
+void debug_print_color_drift(void)              { }
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * color_drift.h
+ *
+ *  reference 드리프트 추적 (주변광/LED 노화 보정)
+ *
+ *  신뢰도 높은 분류 결과로 클래스별 평균을 EWMA(Q8)로 따라간다.
+ *  - 캘리 값(앵커) ± DRIFT_MAX_PCT 범위 밖으로는 못 나간다
+ *  - 모델 반영은 DRIFT_APPLY_MS마다 한 번(분류 경로 부담 없음)
+ *  - 플래시 저장은 DRIFT_SAVE_MIN_MS 이상 간격 + 충분히 움직였을 때만,
+ *    한 페이지에 레코드를 이어 쓰고 가득 찼을 때만 삭제 (내구성)
+ *  캘리 테이블 페이지는 건드리지 않는다 → 재캘리하면 앵커 해시가 바뀌어 기록 무효.
+ *  적응 중엔 테이블 해시가 바뀌므로 LUT는 분리되고 최근접 탐색으로 분류.
+ */
+
+#ifndef COLOR_COLOR_DRIFT_H_
+#define COLOR_COLOR_DRIFT_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#ifndef _USE_COLOR_DRIFT
+#define _USE_COLOR_DRIFT            1
+#endif
+
+// 부팅 시 적응 모드 On/Off (color_drift_enable()로 변경)
+#ifndef COLOR_DRIFT_DEFAULT_ON
+#define COLOR_DRIFT_DEFAULT_ON      0
+#endif
+
+#define COLOR_DRIFT_MIN_CONF        10U         // 이 이상 신뢰도 샘플만 반영
+#define COLOR_DRIFT_ALPHA_SHIFT     6U          // EWMA α = 1/64
+#define COLOR_DRIFT_MAX_PCT         20U         // 앵커 대비 최대 이동 (%)
+#define COLOR_DRIFT_MAX_MIN         16U         // 최대 이동 하한 (카운트)
+
+#define COLOR_DRIFT_APPLY_MS        1000U       // 모델 재구성 주기
+#define COLOR_DRIFT_SAVE_MIN_MS     (30U * 60U * 1000U)     // 플래시 저장 최소 간격
+#define COLOR_DRIFT_SAVE_DELTA      8U          // 마지막 저장 대비 이 이상 움직인 채널이 있어야 저장
+
+#define COLOR_DRIFT_ADDR            ((uint32_t)0x080DE000)  // 캘리 A/B 바로 위
+#define COLOR_DRIFT_MAGIC           0x31465244UL            // "DRF1"
+
+
+void    color_drift_enable(bool on);
+bool    color_drift_enabled(void);
+
+// load_color_reference_table()에서 호출: 앵커 = 방금 읽은 캘리 테이블, 저장된 적응값 복원
+void    color_drift_load(void);
+
+// 분류 결과 관찰 (classify_color_ex에서 color_frame_seq()가 바뀐 변환마다 한 번)
+void    color_drift_observe(uint8_t side, const color_result_t *res,
+                            uint16_t r, uint16_t g, uint16_t b, uint16_t ir);
+
+// 메인 루프: 주기적 모델 반영 + 지연 저장
+void    color_drift_service(void);
+
+void    debug_print_color_drift(void);
+
+
+#endif /* COLOR_COLOR_DRIFT_H_ */
@@ -0,0 +1,271 @@
+/*
+ * color_health.c
+ *
+ *  BH1749 상태 감시
+ */
+
+
+#include "color_health.h"
+#include "color_ae.h"
+#include "uart.h"
+
+
+#if (_USE_COLOR_HEALTH == 1)
+
+typedef struct
+{
+    uint16_t            flags;
+    color_health_state_t state;
+
+    uint8_t             fail_run;       // 연속 읽기 실패
+    uint8_t             sat_run;
+    uint8_t             zero_run;
+    uint8_t             stale_probes;
+
+    bh1749_color_data_t last;
+    uint32_t            change_ms;      // 마지막으로 값이 바뀐 시각
+
+    uint32_t            win_xfer;       // 창 시작 시점 i2c 누적 카운트
+    uint32_t            win_err;
+    uint32_t            recover_cnt;
+} health_t;
+
+static health_t       s_h[2];
+static uint32_t       s_probe_ms = 0;
+static uint32_t       s_win_ms   = 0;
+
+static const uint8_t  s_addr[2] = { BH1749_ADDR_LEFT, BH1749_ADDR_RIGHT };
+
+
+static inline health_t* health_of(uint8_t dev_addr)
+{
+    return &s_h[(dev_addr == BH1749_ADDR_LEFT) ? 0 : 1];
+}
+
+static inline const char* side_str(uint8_t dev_addr)
+{
+    return (dev_addr == BH1749_ADDR_LEFT) ? "LEFT" : "RIGHT";
+}
+
+static void set_flag(uint8_t dev_addr, uint16_t flag, bool on)
+{
+    health_t *h = health_of(dev_addr);
+    uint16_t  f = on ? (uint16_t)(h->flags | flag) : (uint16_t)(h->flags & ~flag);
+
+    if (f == h->flags)
+        return;
+    h->flags = f;
+
+    color_health_state_t st = (f & COLOR_HEALTH_FAULT_MASK) ? COLOR_HEALTH_FAULT
+                            : (f != 0)                      ? COLOR_HEALTH_DEGRADED
+                                                            : COLOR_HEALTH_OK;
+    if (st != h->state)
+    {
+        uart_printf("[HEALTH] %s %s -> %s (flags 0x%02X)\r\n", side_str(dev_addr),
+                    color_health_state_str(h->state), color_health_state_str(st), f);
+        h->state = st;
+    }
+}
+
+bool color_health_boot(uint8_t dev_addr, bool valid_seen)
+{
+    health_t *h = health_of(dev_addr);
+
+    memset(h, 0, sizeof(*h));
+    h->change_ms = millis();
+
+    const i2c_stats_t *is = i2c_get_stats(dev_addr);
+    if (is != NULL)
+    {
+        h->win_xfer = is->xfer_cnt;
+        h->win_err  = is->err_cnt;
+    }
+
+    uint8_t id = 0;
+    bool    ok = (i2c_read_regs(dev_addr, BH1749_REG_SYSTEM_CONTROL, &id, 1) == I2C_OK) &&
+                 ((id & BH1749_PART_ID_MASK) == BH1749_PART_ID);
+
+    set_flag(dev_addr, COLOR_HEALTH_F_PART_ID, !ok);
+    set_flag(dev_addr, COLOR_HEALTH_F_STALE,   ok && !valid_seen);
+
+    uart_printf("[HEALTH] %s part id 0x%02X %s%s\r\n", side_str(dev_addr),
+                id & BH1749_PART_ID_MASK, ok ? "ok" : "MISMATCH",
+                (ok && !valid_seen) ? ", no VALID" : "");
+    return ok;
+}
+
+void color_health_observe(uint8_t dev_addr, i2c_status_t st, const bh1749_color_data_t *raw)
+{
+    health_t *h = health_of(dev_addr);
+
+    if (st != I2C_OK)
+    {
+        if (h->fail_run < 0xFFu)
+            h->fail_run++;
+        if (h->fail_run >= COLOR_HEALTH_DISC_CNT)
+            set_flag(dev_addr, COLOR_HEALTH_F_DISCONNECT, true);
+        return;
+    }
+
+    h->fail_run = 0;
+    set_flag(dev_addr, COLOR_HEALTH_F_DISCONNECT, false);
+
+    // 포화: ADC 최대값, AE면 정규화 값이 잘리는 원시값부터 (x1/35ms는 ×4라 16384)
+#if (_USE_COLOR_AE == 1)
+    uint16_t lim = color_ae_raw_limit(dev_addr);
+#else
+    uint16_t lim = 0xFFFFu;
+#endif
+    bool sat = (raw->red >= lim || raw->green >= lim || raw->blue >= lim);
+    h->sat_run = sat ? (uint8_t)((h->sat_run < 0xFFu) ? h->sat_run + 1u : 0xFFu) : 0u;
+    set_flag(dev_addr, COLOR_HEALTH_F_SATURATED, h->sat_run >= COLOR_HEALTH_SAT_CNT);
+
+    // 전 채널 0: LED가 켜져 있는 한 불가능 (스트로브 OFF 프레임도 주변광 때문에 드묾)
+    bool zero = (raw->red == 0 && raw->green == 0 && raw->blue == 0);
+    h->zero_run = zero ? (uint8_t)((h->zero_run < 0xFFu) ? h->zero_run + 1u : 0xFFu) : 0u;
+    set_flag(dev_addr, COLOR_HEALTH_F_ZERO, h->zero_run >= COLOR_HEALTH_ZERO_CNT);
+
+    // 완전 동일 유지: 실제 센서는 최소 ±1 카운트 잡음이 있음
+    uint32_t now = millis();
+    if (memcmp(&h->last, raw, sizeof(*raw)) != 0)
+    {
+        h->last      = *raw;
+        h->change_ms = now;
+    }
+    set_flag(dev_addr, COLOR_HEALTH_F_FROZEN, (now - h->change_ms) >= COLOR_HEALTH_FROZEN_MS);
+}
+
+static void probe_valid(int i)
+{
+    uint8_t   dev = s_addr[i];
+    health_t *h   = &s_h[i];
+    uint8_t   v   = 0;
+
+    if (h->flags & COLOR_HEALTH_F_PART_ID)
+        return;
+    if (i2c_read_regs(dev, BH1749_REG_MODE_CTRL2, &v, 1) != I2C_OK)
+        return;                                     // 분리는 observe/에러율이 판단
+
+    if (v & BH1749_VALID)
+    {
+        h->stale_probes = 0;
+        set_flag(dev, COLOR_HEALTH_F_STALE, false);
+        return;
+    }
+
+    if (h->stale_probes < 0xFFu)
+        h->stale_probes++;
+    if (h->stale_probes >= COLOR_HEALTH_STALE_PROBES)
+        set_flag(dev, COLOR_HEALTH_F_STALE, true);
+
+    // 측정이 멈춰 있으면(단독 리셋 등) 다시 시작
+    if ((v & BH1749_RGB_EN) == 0)
+    {
+        bh1749_write_reg(dev, BH1749_REG_MODE_CTRL2, BH1749_RGB_EN);
+        h->recover_cnt++;
+        uart_printf("[HEALTH] %s RGB_EN lost -> restart\r\n", side_str(dev));
+    }
+}
+
+// DISCONNECT/ZERO는 읽기 결과로만 풀린다. 고장이면 사용처가 읽지 않으므로 여기서 한 번 읽어 본다
+static void reprobe_fault(int i)
+{
+    bh1749_color_data_t raw;
+
+    if (!(s_h[i].flags & (COLOR_HEALTH_F_DISCONNECT | COLOR_HEALTH_F_ZERO)) ||
+        (s_h[i].flags & COLOR_HEALTH_F_PART_ID))
+        return;
+
+    (void)bh1749_read_raw(s_addr[i], &raw);         // → color_health_observe()
+}
+
+static void check_error_rate(int i)
+{
+    uint8_t            dev = s_addr[i];
+    health_t          *h   = &s_h[i];
+    const i2c_stats_t *is  = i2c_get_stats(dev);
+
+    if (is == NULL)
+        return;
+
+    uint32_t dx = is->xfer_cnt - h->win_xfer;
+    uint32_t de = is->err_cnt  - h->win_err;
+    h->win_xfer = is->xfer_cnt;
+    h->win_err  = is->err_cnt;
+
+    if (dx < 5u)
+        return;                                     // 표본 부족 → 유지
+    set_flag(dev, COLOR_HEALTH_F_I2C_RATE, (de * 100u) >= (dx * COLOR_HEALTH_ERR_PCT));
+}
+
+void color_health_service(void)
+{
+    uint32_t now = millis();
+
+    if ((now - s_probe_ms) >= COLOR_HEALTH_PROBE_MS)
+    {
+        s_probe_ms = now;
+        for (int i = 0; i < 2; i++)
+        {
+            probe_valid(i);
+            reprobe_fault(i);
+        }
+    }
+
+    if ((now - s_win_ms) >= COLOR_HEALTH_WIN_MS)
+    {
+        s_win_ms = now;
+        for (int i = 0; i < 2; i++)
+            check_error_rate(i);
+    }
+}
+
+color_health_state_t color_health_state(uint8_t dev_addr)
+{
+    return health_of(dev_addr)->state;
+}
+
+uint16_t color_health_flags(uint8_t dev_addr)
+{
+    return health_of(dev_addr)->flags;
+}
+
+bool color_health_usable(uint8_t dev_addr)
+{
+    return health_of(dev_addr)->state != COLOR_HEALTH_FAULT;
+}
+
+void debug_print_color_health(void)
+{
+    uart_printf("=== COLOR HEALTH ===\r\n");
+    for (int i = 0; i < 2; i++)
+    {
+        uart_printf("[%-5s] %s flags:0x%02X fail:%u sat:%u recover:%lu\r\n",
+                    side_str(s_addr[i]), color_health_state_str(s_h[i].state), s_h[i].flags,
+                    s_h[i].fail_run, s_h[i].sat_run, (unsigned long)s_h[i].recover_cnt);
+    }
+}
+
+#else
+
+bool                 color_health_boot(uint8_t dev_addr, bool valid_seen) { (void)dev_addr; (void)valid_seen; return true; }
+void                 color_health_observe(uint8_t dev_addr, i2c_status_t st,
+                                          const bh1749_color_data_t *raw) { (void)dev_addr; (void)st; (void)raw; }
+void                 color_health_service(void)                 { }
+color_health_state_t color_health_state(uint8_t dev_addr)      { (void)dev_addr; return COLOR_HEALTH_OK; }
+uint16_t             color_health_flags(uint8_t dev_addr)      { (void)dev_addr; return 0; }
+bool                 color_health_usable(uint8_t dev_addr)     { (void)dev_addr; return true; }
+void                 debug_print_color_health(void)            { }
+
+#endif
+
+const char* color_health_state_str(color_health_state_t st)
+{
+    switch (st)
+    {
+        case COLOR_HEALTH_OK:       return "OK";
+        case COLOR_HEALTH_DEGRADED: return "DEGRADED";
+        case COLOR_HEALTH_FAULT:    return "FAULT";
+        default:                    return "?";
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * color_health.h
+ *
+ *  BH1749 상태 감시 (부팅 PART ID + 런타임 포화/정지/무응답/I2C 에러율)
+ *
+ *  - FAULT   : PART ID 불일치, 연속 읽기 실패(분리), 새 변환 없음(VALID 안 뜸),
+ *              RGB가 계속 0 (LED가 켜진 상태에서 불가능) → 이 센서 값은 쓰지 않는다
+ *  - DEGRADED: 포화 지속, I2C 에러율 높음, 값이 오래 완전히 동일 → 쓰되 경고
+ *  새 변환이 안 뜨면 RGB_EN을 다시 써서 복구를 시도한다 (센서 단독 리셋 대비).
+ *  card/line 모드는 color_health_usable()로 한쪽 센서 운용/정지를 고른다.
+ */
+
+#ifndef COLOR_COLOR_HEALTH_H_
+#define COLOR_COLOR_HEALTH_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#ifndef _USE_COLOR_HEALTH
+#define _USE_COLOR_HEALTH           1
+#endif
+
+#define BH1749_PART_ID              0x0DU       // SYSTEM_CONTROL[5:0]
+#define BH1749_PART_ID_MASK         0x3FU
+
+#define COLOR_HEALTH_PROBE_MS       500U        // VALID 확인 주기 (최장 측정 240ms의 2배 이상)
+#define COLOR_HEALTH_STALE_PROBES   2U          // 연속 이만큼 VALID 없으면 STALE
+#define COLOR_HEALTH_WIN_MS         1000U       // I2C 에러율 창
+#define COLOR_HEALTH_ERR_PCT        20U         // 창 안 에러율 이상이면 I2C 플래그
+#define COLOR_HEALTH_DISC_CNT       10U         // 연속 읽기 실패 → 분리
+#define COLOR_HEALTH_SAT_CNT        8U          // 연속 포화 샘플
+#define COLOR_HEALTH_ZERO_CNT       20U         // 연속 RGB=0 샘플
+#define COLOR_HEALTH_FROZEN_MS      5000U       // 4채널 완전 동일 유지 시간
+
+
+typedef enum
+{
+    COLOR_HEALTH_OK = 0,
+    COLOR_HEALTH_DEGRADED,
+    COLOR_HEALTH_FAULT
+} color_health_state_t;
+
+// 플래그 (비트)
+#define COLOR_HEALTH_F_PART_ID      (1u << 0)   // FAULT
+#define COLOR_HEALTH_F_DISCONNECT   (1u << 1)   // FAULT
+#define COLOR_HEALTH_F_STALE        (1u << 2)   // FAULT
+#define COLOR_HEALTH_F_ZERO         (1u << 3)   // FAULT
+#define COLOR_HEALTH_F_SATURATED    (1u << 4)   // DEGRADED
+#define COLOR_HEALTH_F_I2C_RATE     (1u << 5)   // DEGRADED
+#define COLOR_HEALTH_F_FROZEN       (1u << 6)   // DEGRADED
+
+#define COLOR_HEALTH_FAULT_MASK     (COLOR_HEALTH_F_PART_ID | COLOR_HEALTH_F_DISCONNECT | \
+                                     COLOR_HEALTH_F_STALE   | COLOR_HEALTH_F_ZERO)
+
+
+// bh1749_init() 직후: PART ID 확인 + 초기 VALID 결과 반영
+bool                 color_health_boot(uint8_t dev_addr, bool valid_seen);
+
+// bh1749_read_raw()마다 호출 (원시값 기준)
+void                 color_health_observe(uint8_t dev_addr, i2c_status_t st,
+                                          const bh1749_color_data_t *raw);
+
+// 메인 루프: VALID 확인/복구 시도, 고장 센서 재읽기(정상 값이면 DISCONNECT/ZERO 해제), I2C 에러율 창
+void                 color_health_service(void);
+
+color_health_state_t color_health_state(uint8_t dev_addr);
+uint16_t             color_health_flags(uint8_t dev_addr);
+bool                 color_health_usable(uint8_t dev_addr);     // FAULT가 아니면 true
+
+const char*          color_health_state_str(color_health_state_t st);
+void                 debug_print_color_health(void);
+
+
+#endif /* COLOR_COLOR_HEALTH_H_ */
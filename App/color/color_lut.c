@@ -0,0 +1,178 @@
+/*
+ * color_lut.c
+ *
+ *  양자화 RGB → 색 룩업 테이블
+ */
+
+
+#include "color_lut.h"
+#include "color_cls.h"
+#include "color_ccm.h"
+#include "flash.h"
+#include "uart.h"
+
+
+#define LUT_MAX_IDX         (COLOR_LUT_DIM - 1U)
+#define LUT_CHUNK_SIZE      256U                    // 생성 시 한 번에 프로그램하는 셀 수
+
+typedef struct
+{
+    const uint8_t *cells;
+    uint32_t       inv[3];      // (DIM << 16) / full
+    uint8_t        mode;
+    bool           ok;
+} lut_state_t;
+
+static lut_state_t s_lut[2];
+static uint8_t     s_chunk[LUT_CHUNK_SIZE];
+
+
+static inline uint8_t side_idx(uint8_t side)
+{
+    return (side == BH1749_ADDR_LEFT) ? 0 : 1;
+}
+
+static inline uint32_t side_base(uint8_t side)
+{
+    return (side == BH1749_ADDR_LEFT) ? COLOR_LUT_ADDR_LEFT : COLOR_LUT_ADDR_RIGHT;
+}
+
+static inline uint32_t quant(uint16_t c, uint32_t inv)
+{
+    uint32_t q = (uint32_t)(((uint64_t)c * inv) >> 16);
+    return (q > LUT_MAX_IDX) ? LUT_MAX_IDX : q;
+}
+
+static inline uint16_t cell_center(uint32_t q, uint16_t full)
+{
+    return (uint16_t)(((2u * q + 1u) * full) / (2u * COLOR_LUT_DIM));
+}
+
+static uint8_t build_cell(uint8_t side, uint8_t mode, const uint16_t full[3], uint32_t idx)
+{
+    uint16_t r = cell_center(idx >> (2 * COLOR_LUT_BITS),            full[0]);
+    uint16_t g = cell_center((idx >> COLOR_LUT_BITS) & LUT_MAX_IDX,   full[1]);
+    uint16_t b = cell_center(idx & LUT_MAX_IDX,                       full[2]);
+
+    // 색도 모드의 셀 좌표는 이미 IR 보정된 공간 → ir = 0. 거부된 셀은 UNKNOWN(12)
+    color_result_t res = color_cls_search(side, (color_cls_mode_t)mode, r, g, b, 0);
+
+    return COLOR_LUT_CELL((uint8_t)res.cls, res.conf);
+}
+
+bool color_lut_build(uint8_t side)
+{
+    const reference_entry_t *tbl  = color_side_table(side);
+    const uint32_t           base = side_base(side);
+    const uint8_t            mode = (uint8_t)color_side_cls_mode(side);
+
+    s_lut[side_idx(side)].ok = false;
+
+    uint16_t w[3] = { tbl[COLOR_WHITE].raw.red_raw, tbl[COLOR_WHITE].raw.green_raw,
+                      tbl[COLOR_WHITE].raw.blue_raw };
+    if (mode == COLOR_CLS_CHROMA)
+        color_ir_correct(&w[0], &w[1], &w[2], tbl[COLOR_WHITE].raw.ir_raw);
+
+    color_lut_hdr_t hdr;
+    memset(&hdr, 0xFF, sizeof(hdr));
+    hdr.magic    = COLOR_LUT_MAGIC;
+    hdr.ref_hash = color_ref_hash(tbl);
+    hdr.mode     = mode;
+    hdr.bits     = COLOR_LUT_BITS;
+
+    for (int k = 0; k < 3; k++)
+    {
+        // 화이트 미보정(0) / 삭제된 플래시(0xFFFF)면 정규화 불가
+        if (w[k] == 0 || w[k] == 0xFFFFu)
+        {
+            uart_printf("[LUT] side=0x%02X invalid white ref\r\n", side);
+            return false;
+        }
+        uint32_t f  = (uint32_t)w[k] + (w[k] >> 2);          // 화이트보다 25% 밝은 값까지
+        hdr.full[k] = (uint16_t)((f > 0xFFFFu) ? 0xFFFFu : f);
+    }
+
+    uint32_t t0 = millis();
+
+    if (!flash_erase_pages(base, COLOR_LUT_PAGES))
+        return false;
+
+    for (uint32_t cell = 0; cell < COLOR_LUT_CELLS; cell += LUT_CHUNK_SIZE)
+    {
+        for (uint32_t j = 0; j < LUT_CHUNK_SIZE; j++)
+            s_chunk[j] = build_cell(side, mode, hdr.full, cell + j);
+
+        if (!flash_program(base + COLOR_LUT_HDR_SIZE + cell, s_chunk, LUT_CHUNK_SIZE))
+            return false;
+    }
+
+    // 헤더 본문 → magic/hash 순서로 기록 (도중 리셋되면 magic이 0xFF로 남음)
+    if (!flash_program(base + 8, (const uint8_t*)&hdr + 8, sizeof(hdr) - 8) ||
+        !flash_program(base,     &hdr,                     8))
+        return false;
+
+    uart_printf("[LUT] side=0x%02X built (%lu ms)\r\n", side, (unsigned long)(millis() - t0));
+
+    return color_lut_attach(side);
+}
+
+bool color_lut_attach(uint8_t side)
+{
+    lut_state_t           *s   = &s_lut[side_idx(side)];
+    const color_lut_hdr_t *hdr = (const color_lut_hdr_t*)(uintptr_t)side_base(side);
+
+    s->ok = false;
+
+    if (hdr->magic != COLOR_LUT_MAGIC ||
+        hdr->bits  != COLOR_LUT_BITS  ||
+        hdr->mode  != (uint8_t)color_side_cls_mode(side) ||
+        hdr->ref_hash != color_ref_hash(color_side_table(side)))
+        return false;
+
+    for (int k = 0; k < 3; k++)
+    {
+        if (hdr->full[k] == 0)
+            return false;
+        s->inv[k] = ((uint32_t)COLOR_LUT_DIM << 16) / hdr->full[k];
+    }
+
+    s->cells = (const uint8_t*)(uintptr_t)side_base(side) + COLOR_LUT_HDR_SIZE;
+    s->mode  = hdr->mode;
+    s->ok    = true;
+    return true;
+}
+
+bool color_lut_refresh(void)
+{
+    bool ok = color_lut_ready(BH1749_ADDR_LEFT) || color_lut_build(BH1749_ADDR_LEFT);
+
+    if (!color_ccm_ready())                 // CCM이면 RIGHT도 LEFT LUT 사용
+        ok = (color_lut_ready(BH1749_ADDR_RIGHT) || color_lut_build(BH1749_ADDR_RIGHT)) && ok;
+    return ok;
+}
+
+bool color_lut_ready(uint8_t side)
+{
+    return s_lut[side_idx(side)].ok;
+}
+
+bool color_lut_lookup(uint8_t side, uint16_t r, uint16_t g, uint16_t b, uint16_t ir,
+                      color_t *out_cls, uint8_t *out_conf)
+{
+    const lut_state_t *s = &s_lut[side_idx(side)];
+
+    if (!s->ok)
+        return false;
+
+    if (s->mode == COLOR_CLS_CHROMA)
+        color_ir_correct(&r, &g, &b, ir);
+
+    uint32_t idx = (quant(r, s->inv[0]) << (2 * COLOR_LUT_BITS)) |
+                   (quant(g, s->inv[1]) << COLOR_LUT_BITS)       |
+                    quant(b, s->inv[2]);
+    uint8_t cell = s->cells[idx];
+
+    if (out_cls)  *out_cls  = (color_t)(cell & 0x0Fu);
+    if (out_conf) *out_conf = (uint8_t)(cell >> 4);
+    return true;
+}
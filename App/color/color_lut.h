@@ -0,0 +1,65 @@
+/*
+ * color_lut.h
+ *
+ *  양자화 RGB → 색 룩업 테이블 (캘리브레이션 직후 생성, 플래시 저장)
+ *
+ *  채널당 5비트(32³ = 32K 셀), 화이트 기준 × 1.25로 정규화.
+ *  셀 1바이트 = [7:4] 신뢰도(0~15) | [3:0] color_t (COLOR_UNKNOWN = 거부)
+ *  분류 모델이 무엇이든 런타임 비용은 곱셈 3번 + 메모리 1회 읽기.
+ *  헤더의 reference 해시/모드가 현재와 다르면 무효 → 최근접 탐색으로 폴백.
+ */
+
+#ifndef COLOR_COLOR_LUT_H_
+#define COLOR_COLOR_LUT_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#ifndef _USE_COLOR_LUT
+#define _USE_COLOR_LUT          1
+#endif
+
+#define COLOR_LUT_BITS          5U
+#define COLOR_LUT_DIM           (1U << COLOR_LUT_BITS)
+#define COLOR_LUT_CELLS         (COLOR_LUT_DIM * COLOR_LUT_DIM * COLOR_LUT_DIM)
+#define COLOR_LUT_HDR_SIZE      32U
+
+// Bank2 끝 쪽 (코드 영역과 분리). 헤더 + 32K = 9 페이지
+#define COLOR_LUT_ADDR_LEFT     ((uint32_t)0x080E0000)
+#define COLOR_LUT_ADDR_RIGHT    ((uint32_t)0x080F0000)
+#define COLOR_LUT_PAGES         ((COLOR_LUT_HDR_SIZE + COLOR_LUT_CELLS + FLASH_PAGE_SIZE - 1U) / FLASH_PAGE_SIZE)
+
+#define COLOR_LUT_MAGIC         0x3254554CUL    // "LUT2"
+
+#define COLOR_LUT_CELL(cls, conf)   ((uint8_t)(((conf) << 4) | ((cls) & 0x0Fu)))
+
+
+// 플래시에 그대로 놓이는 헤더 (첫 8바이트는 마지막에 기록 → 중간 실패 시 무효)
+typedef struct
+{
+    uint32_t magic;
+    uint32_t ref_hash;      // 생성 당시 reference 테이블 해시
+    uint16_t full[3];       // 정규화 상한 (이 값 → 셀 31)
+    uint8_t  mode;          // color_cls_mode_t
+    uint8_t  bits;
+    uint8_t  _rsv[16];
+} color_lut_hdr_t;
+
+
+// 현재 reference/분류 모드로 LUT 생성 후 플래시에 기록 (수백 ms, 캘리 종료 시 1회)
+bool    color_lut_build(uint8_t side);
+// 플래시 LUT가 현재 reference/모드와 일치하면 사용 설정
+bool    color_lut_attach(uint8_t side);
+bool    color_lut_ready(uint8_t side);
+// 분류에 쓰이는 쪽(LEFT, CCM 없으면 RIGHT도) LUT가 현재 reference와 안 맞으면 다시 생성.
+// LUT는 쪽마다 하나라 캘리 종료/프로필 전환마다 호출
+bool    color_lut_refresh(void);
+
+// O(1) 조회. LUT 미사용이면 false
+bool    color_lut_lookup(uint8_t side, uint16_t r, uint16_t g, uint16_t b, uint16_t ir,
+                         color_t *out_cls, uint8_t *out_conf);
+
+
+#endif /* COLOR_COLOR_LUT_H_ */
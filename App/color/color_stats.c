@@ -0,0 +1,272 @@
+/*
+ * color_stats.c
+ *
+ *  다중 샘플 캘리브레이션 통계 + 마할라노비스 분류
+ */
+
+
+#include "color_stats.h"
+#include "color_cls.h"
+#include "color_cal.h"
+#include "flash.h"
+#include "flash_kv.h"
+#include "uart.h"
+
+
+enum { XX = 0, YY, ZZ, XY, XZ, YZ };
+
+_Static_assert(COLOR_STATS_PAGE_SIZE == FLASH_PAGE_SIZE, "stats page must be one flash page");
+_Static_assert(COLOR_STATS_ADDR(COLOR_CAL_PROFILES) <= KV_ADDR, "stats pages overlap the KV ring");
+_Static_assert(sizeof(color_mahal_t) <= COLOR_STATS_SIDE_OFFSET, "stats side exceeds half a page");
+
+static color_mahal_t s_mahal[2];
+static bool          s_ready[2];
+
+
+static inline uint8_t side_idx(uint8_t side)
+{
+    return (side == BH1749_ADDR_LEFT) ? 0 : 1;
+}
+
+// ln(x), x > 0. libm 없이: x = m·2^e (1 ≤ m < 2), ln m = 2·atanh((m-1)/(m+1))
+static double ln_pos(double x)
+{
+    int e = 0;
+    while (x >= 2.0) { x *= 0.5; e++; }
+    while (x <  1.0) { x *= 2.0; e--; }
+
+    double y  = (x - 1.0) / (x + 1.0);      // ≤ 1/3
+    double y2 = y * y;
+    double t  = y, s = 0.0;
+    for (int k = 1; k <= 15; k += 2)
+    {
+        s += t / k;
+        t *= y2;
+    }
+    return 2.0 * s + e * 0.69314718055994531;
+}
+
+void color_stats_acc_reset(color_stats_acc_t *acc)
+{
+    memset(acc, 0, sizeof(*acc));
+}
+
+void color_stats_acc_add(color_stats_acc_t *acc, uint16_t r, uint16_t g, uint16_t b)
+{
+    const double x[3] = { r, g, b };
+    double d[3], d2[3];
+
+    acc->n++;
+    for (int k = 0; k < 3; k++)
+    {
+        d[k]          = x[k] - acc->mean[k];
+        acc->mean[k] += d[k] / acc->n;
+        d2[k]         = x[k] - acc->mean[k];
+    }
+
+    acc->m2[XX] += d[0] * d2[0];
+    acc->m2[YY] += d[1] * d2[1];
+    acc->m2[ZZ] += d[2] * d2[2];
+    acc->m2[XY] += d[0] * d2[1];
+    acc->m2[XZ] += d[0] * d2[2];
+    acc->m2[YZ] += d[1] * d2[2];
+}
+
+void color_stats_reset(void)
+{
+    memset(s_mahal, 0, sizeof(s_mahal));
+    s_ready[0] = s_ready[1] = false;
+}
+
+bool color_stats_fit(uint8_t side, color_t cls, const color_stats_acc_t *acc)
+{
+    if (cls >= COLOR_COUNT || acc->n < COLOR_STATS_MIN_SAMPLES)
+        return false;
+
+    color_mahal_cls_t *c = &s_mahal[side_idx(side)].c[cls];
+    double S[6];
+
+    for (int k = 0; k < 6; k++)
+        S[k] = acc->m2[k] / (acc->n - 1);
+
+    for (int k = 0; k < 3; k++)
+    {
+        double s0 = COLOR_STATS_SIGMA0_ABS + COLOR_STATS_SIGMA0_REL * acc->mean[k];
+        S[k] += s0 * s0;
+    }
+
+    // 대칭 3x3 역행렬 (여인수)
+    double a = S[XX], b = S[YY], cc = S[ZZ], d = S[XY], e = S[XZ], f = S[YZ];
+    double inv[6] =
+    {
+        [XX] = b * cc - f * f,
+        [YY] = a * cc - e * e,
+        [ZZ] = a * b  - d * d,
+        [XY] = e * f  - d * cc,
+        [XZ] = d * f  - b * e,
+        [YZ] = d * e  - a * f,
+    };
+    double det = a * inv[XX] + d * inv[XY] + e * inv[XZ];
+
+    if (!(det > 0.0))
+        return false;
+
+    double maxabs = 0.0;
+    for (int k = 0; k < 6; k++)
+    {
+        inv[k] /= det;
+        double m = (inv[k] < 0) ? -inv[k] : inv[k];
+        if (m > maxabs) maxabs = m;
+    }
+
+    // |q| ≤ 32767 이 되는 최대 shift (점수 Q8 정렬을 위해 ≥ 8)
+    uint8_t sh = 8;
+    while (sh < 48 && maxabs * (double)(1ULL << (sh + 1)) < 32767.0)
+        sh++;
+
+    for (int k = 0; k < 6; k++)
+    {
+        double q = inv[k] * (double)(1ULL << sh);
+        c->inv[k] = (int16_t)(q < 0 ? q - 0.5 : q + 0.5);
+    }
+    for (int k = 0; k < 3; k++)
+        c->mean[k] = (uint16_t)(acc->mean[k] + 0.5);
+
+    c->shift     = sh;
+    c->logdet_q8 = (int32_t)(ln_pos(det) * 256.0);
+    c->n         = (uint8_t)((acc->n > 255u) ? 255u : acc->n);
+
+    double thr   = COLOR_STATS_REJECT_CHI2 * (1.0 + 4.0 / acc->n) * 256.0;
+    c->reject_q8 = (uint16_t)((thr > 65535.0) ? 65535.0 : thr);
+    return true;
+}
+
+void color_stats_activate(void)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        s_mahal[s].magic    = COLOR_STATS_MAGIC;
+        s_mahal[s].ref_hash = color_ref_hash(color_side_table(s == 0 ? BH1749_ADDR_LEFT : BH1749_ADDR_RIGHT));
+        s_ready[s]          = true;
+    }
+}
+
+bool color_stats_commit(void)
+{
+    color_stats_activate();
+
+    const uint32_t len  = (sizeof(color_mahal_t) + 7u) & ~7u;
+    const uint32_t addr = COLOR_STATS_ADDR(color_cal_active());
+
+    if (!flash_erase_pages(addr, 1))
+        return false;
+
+    return flash_program(addr,                           &s_mahal[0], len) &&
+           flash_program(addr + COLOR_STATS_SIDE_OFFSET, &s_mahal[1], len);
+}
+
+void color_stats_load(void)
+{
+    const uint32_t addr = COLOR_STATS_ADDR(color_cal_active());
+
+    for (int s = 0; s < 2; s++)
+    {
+        uint8_t side = (s == 0) ? BH1749_ADDR_LEFT : BH1749_ADDR_RIGHT;
+
+        memcpy(&s_mahal[s], (const void*)(uintptr_t)(addr + s * COLOR_STATS_SIDE_OFFSET),
+               sizeof(color_mahal_t));
+
+        s_ready[s] = (s_mahal[s].magic == COLOR_STATS_MAGIC &&
+                      s_mahal[s].ref_hash == color_ref_hash(color_side_table(side)));
+    }
+}
+
+bool color_stats_ready(uint8_t side)
+{
+    return s_ready[side_idx(side)];
+}
+
+static inline int64_t mahal_score(const color_mahal_cls_t *c, uint16_t r, uint16_t g, uint16_t b)
+{
+    int64_t x = (int32_t)r - c->mean[0];
+    int64_t y = (int32_t)g - c->mean[1];
+    int64_t z = (int32_t)b - c->mean[2];
+
+    int64_t acc = x * x * c->inv[XX] + y * y * c->inv[YY] + z * z * c->inv[ZZ]
+                + 2 * (x * y * c->inv[XY] + x * z * c->inv[XZ] + y * z * c->inv[YZ]);
+
+    return (acc >> (c->shift - 8)) + c->logdet_q8;
+}
+
+color_t color_stats_nearest2(uint8_t side, uint16_t r, uint16_t g, uint16_t b,
+                             int64_t *s1, int64_t *s2)
+{
+    const color_mahal_t *m = &s_mahal[side_idx(side)];
+    int64_t best_s = INT64_MAX, second_s = INT64_MAX;
+    color_t best   = COLOR_GRAY;
+
+    for (uint8_t i = 0; i < COLOR_COUNT; i++)
+    {
+        if (m->c[i].n == 0)
+            continue;
+
+        int64_t s = mahal_score(&m->c[i], r, g, b);
+        if (s < best_s)
+        {
+            second_s = best_s;
+            best_s   = s;
+            best     = (color_t)i;
+        }
+        else if (s < second_s)
+        {
+            second_s = s;
+        }
+    }
+
+    if (s1) *s1 = best_s;
+    if (s2) *s2 = second_s;
+    return best;
+}
+
+void color_stats_set_mean(uint8_t side, color_t cls, const uint16_t mean[3])
+{
+    if (cls >= COLOR_COUNT)
+        return;
+
+    color_mahal_cls_t *c = &s_mahal[side_idx(side)].c[cls];
+    for (int k = 0; k < 3; k++)
+        c->mean[k] = mean[k];
+}
+
+bool color_stats_accept(uint8_t side, color_t cls, int64_t score)
+{
+    if (cls >= COLOR_COUNT)
+        return false;
+
+    const color_mahal_cls_t *c = &s_mahal[side_idx(side)].c[cls];
+    return (score - c->logdet_q8) <= (int64_t)c->reject_q8;
+}
+
+color_t color_stats_nearest(uint8_t side, uint16_t r, uint16_t g, uint16_t b)
+{
+    return color_stats_nearest2(side, r, g, b, NULL, NULL);
+}
+
+void debug_print_color_stats(void)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        uart_printf("=== %s COLOR STATS (%s) ===\r\n", s == 0 ? "LEFT" : "RIGHT",
+                    s_ready[s] ? "valid" : "invalid");
+        if (!s_ready[s])
+            continue;
+
+        for (int i = 0; i < COLOR_COUNT; i++)
+        {
+            const color_mahal_cls_t *c = &s_mahal[s].c[i];
+            uart_printf("[%2d | %-11s] n:%3u mean:%5u,%5u,%5u sh:%2u lndet:%ld\r\n",
+                        i, color_to_string((color_t)i), c->n,
+                        c->mean[0], c->mean[1], c->mean[2], c->shift, (long)(c->logdet_q8 / 256));
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * color_stats.h
+ *
+ *  다중 샘플 캘리브레이션 통계 + 마할라노비스 분류
+ *
+ *  캘리 중 색마다 N개 샘플(카드를 밀면서)로 평균/공분산을 구하고,
+ *  역공분산을 고정소수점(int16 × 2^-shift)으로 저장한다.
+ *  점수 = (x-μ)ᵀ Σ⁻¹ (x-μ) + ln|Σ|  (Q8, 작을수록 가까움)
+ *  역행렬/로그는 캘리 시 1회만(double), 분류 경로는 정수 곱셈-누산뿐.
+ */
+
+#ifndef COLOR_COLOR_STATS_H_
+#define COLOR_COLOR_STATS_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+// 캘리 프로필마다 1 페이지 (KV 링 바로 아래 COLOR_CAL_PROFILES 페이지).
+// 프로필을 바꿔도 각자의 통계가 남는다. 예전 단일 페이지(0x080DF000)는 쓰지 않음
+// 0x080D0000 위는 데이터 전용 (링커 스크립트 FLASH_DATA, 코드 배치 금지)
+#define COLOR_STATS_ADDR_BASE       ((uint32_t)0x080D0000)
+#define COLOR_STATS_PAGE_SIZE       0x1000U
+#define COLOR_STATS_ADDR(prof)      (COLOR_STATS_ADDR_BASE + (uint32_t)(prof) * COLOR_STATS_PAGE_SIZE)
+#define COLOR_STATS_SIDE_OFFSET     0x800U                      // RIGHT는 +2KB
+#define COLOR_STATS_MAGIC           0x32544153UL                // "SAT2"
+
+#define COLOR_STATS_MIN_SAMPLES     4U
+
+// 거부 임계: χ²(3자유도, 99.9%) = 16.27, 샘플 수가 적을수록 (1 + 4/n)배 완화
+#define COLOR_STATS_REJECT_CHI2     16.27
+
+// 공분산 정규화: σ0 = 2 + 1% × 평균 (센서 잡음 하한, 특이행렬 방지)
+#define COLOR_STATS_SIGMA0_ABS      2.0
+#define COLOR_STATS_SIGMA0_REL      0.01
+
+
+// 캘리용 누적기 (Welford). m2 = [xx, yy, zz, xy, xz, yz]
+typedef struct
+{
+    uint32_t n;
+    double   mean[3];
+    double   m2[6];
+} color_stats_acc_t;
+
+typedef struct
+{
+    int32_t  logdet_q8;     // ln|Σ| × 256
+    int16_t  inv[6];        // Σ⁻¹ × 2^shift  [xx, yy, zz, xy, xz, yz]
+    uint16_t mean[3];
+    uint8_t  shift;
+    uint8_t  n;             // 0 = 미보정 클래스
+    uint16_t reject_q8;     // (x-μ)ᵀΣ⁻¹(x-μ)가 이보다 크면 UNKNOWN (Q8)
+} color_mahal_cls_t;
+
+typedef struct
+{
+    uint32_t          magic;
+    uint32_t          ref_hash;     // 같이 저장된 reference 테이블과 짝 확인
+    color_mahal_cls_t c[COLOR_COUNT];
+} color_mahal_t;
+
+
+void    color_stats_acc_reset(color_stats_acc_t *acc);
+void    color_stats_acc_add(color_stats_acc_t *acc, uint16_t r, uint16_t g, uint16_t b);
+
+// 캘리 진입 시 RAM 모델 무효화 / 한 색의 통계 반영 / 종료 시 활성 프로필 페이지에 저장
+void    color_stats_reset(void);
+bool    color_stats_fit(uint8_t side, color_t cls, const color_stats_acc_t *acc);
+bool    color_stats_commit(void);
+// commit의 RAM 부분만 (현재 reference 해시로 표시 후 사용, 플래시 불변. 벤치 학습용)
+void    color_stats_activate(void);
+
+// 부팅/프로필 전환 시: 활성 프로필 페이지 → RAM, reference 해시가 다르면 무효
+void    color_stats_load(void);
+bool    color_stats_ready(uint8_t side);
+
+color_t color_stats_nearest(uint8_t side, uint16_t r, uint16_t g, uint16_t b);
+// 1·2위 점수(Q8)까지 (LUT 신뢰도용)
+color_t color_stats_nearest2(uint8_t side, uint16_t r, uint16_t g, uint16_t b,
+                             int64_t *s1, int64_t *s2);
+
+// 드리프트 추적용: 클래스 평균만 교체 (공분산/임계 유지)
+void    color_stats_set_mean(uint8_t side, color_t cls, const uint16_t mean[3]);
+
+// 1위 점수가 해당 클래스 분포 안쪽인지 (마할라노비스 제곱거리 ≤ 클래스별 임계)
+bool    color_stats_accept(uint8_t side, color_t cls, int64_t score);
+
+void    debug_print_color_stats(void);
+
+
+#endif /* COLOR_COLOR_STATS_H_ */
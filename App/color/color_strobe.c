@@ -0,0 +1,207 @@
+/*
+ * color_strobe.c
+ *
+ *  흰색 LED 스트로브 + 주변광 차감
+ */
+
+
+#include "color_strobe.h"
+#include "color_ae.h"
+#include "led.h"
+#include "uart.h"
+
+
+#if (_USE_COLOR_STROBE == 1)
+
+typedef enum
+{
+    STROBE_IDLE = 0,
+    STROBE_LIT,                 // LED ON 변환 진행 중
+    STROBE_DARK,                // LED OFF 변환 진행 중
+} strobe_state_t;
+
+typedef struct
+{
+    bh1749_color_data_t lit;    // 원시값
+    bh1749_color_data_t out;    // 차분 + 정규화
+    i2c_status_t        st;
+    bool                valid;
+    uint16_t            ambient;    // 마지막 OFF 프레임 최대 채널 (디버그)
+} strobe_side_t;
+
+static bool            s_on = (COLOR_STROBE_DEFAULT_ON != 0);
+static strobe_state_t  s_state = STROBE_IDLE;
+static uint32_t        s_phase_us = 0;
+static uint32_t        s_wait_us  = 0;
+static uint32_t        s_seq = 0;
+static strobe_side_t   s_side[2];
+
+static const uint8_t   s_addr[2] = { BH1749_ADDR_LEFT, BH1749_ADDR_RIGHT };
+
+
+static inline strobe_side_t* side_of(uint8_t dev_addr)
+{
+    return &s_side[(dev_addr == BH1749_ADDR_LEFT) ? 0 : 1];
+}
+
+static inline uint16_t sub_sat(uint16_t a, uint16_t b)
+{
+    return (a > b) ? (uint16_t)(a - b) : 0u;
+}
+
+// LED 상태 전환 + 양쪽 변환 재시작 (RGB_EN 0→1)
+static void start_phase(bool lit)
+{
+    uint32_t meas = 35;
+
+    led_write(LED_W_CONTROL, lit);
+
+    for (int i = 0; i < 2; i++)
+    {
+        bh1749_write_reg(s_addr[i], BH1749_REG_MODE_CTRL2, 0);
+        bh1749_write_reg(s_addr[i], BH1749_REG_MODE_CTRL2, BH1749_RGB_EN);
+#if (_USE_COLOR_AE == 1)
+        if (color_ae_meas_ms(s_addr[i]) > meas)
+            meas = color_ae_meas_ms(s_addr[i]);
+#endif
+    }
+
+    s_wait_us  = (meas + COLOR_STROBE_MARGIN_MS) * 1000u;
+    s_phase_us = micros();
+}
+
+static void finish_pair(int i, const bh1749_color_data_t *dark)
+{
+    strobe_side_t *sd = &s_side[i];
+    bh1749_color_data_t diff =
+    {
+        .red   = sub_sat(sd->lit.red,   dark->red),
+        .green = sub_sat(sd->lit.green, dark->green),
+        .blue  = sub_sat(sd->lit.blue,  dark->blue),
+        .ir    = sub_sat(sd->lit.ir,    dark->ir),
+    };
+
+    uint16_t amb = dark->red;
+    if (dark->green > amb) amb = dark->green;
+    if (dark->blue  > amb) amb = dark->blue;
+    sd->ambient = amb;
+
+#if (_USE_COLOR_AE == 1)
+    // 두 프레임과 같은 단계 계수로 정규화한 뒤 노출 갱신(다음 쌍부터 적용)
+    bh1749_color_data_t norm, lit_norm;
+    color_ae_normalize(s_addr[i], &diff, &norm);
+    if (!color_ae_update(s_addr[i], &sd->lit, &lit_norm))
+        return;                                     // 노출 전환 직후 → 버림
+    sd->out = norm;
+#else
+    sd->out = diff;
+#endif
+    sd->valid = true;
+}
+
+void color_strobe_enable(bool on)
+{
+    s_on    = on;
+    s_state = STROBE_IDLE;
+    s_side[0].valid = s_side[1].valid = false;
+
+    // Off면 기존 동작(상시 점등), On이면 다음 service에서 스트로브 시작
+    led_write(LED_W_CONTROL, !on);
+    uart_printf("[STROBE] %s\r\n", on ? "on" : "off");
+}
+
+bool color_strobe_enabled(void)
+{
+    return s_on;
+}
+
+void color_strobe_service(void)
+{
+    if (!s_on)
+        return;
+
+    uint32_t now = micros();
+
+    switch (s_state)
+    {
+        case STROBE_IDLE:
+#if (COLOR_STROBE_IDLE_MS > 0)
+            if ((now - s_phase_us) < (COLOR_STROBE_IDLE_MS * 1000u))
+                return;
+#endif
+            start_phase(true);
+            s_state = STROBE_LIT;
+            break;
+
+        case STROBE_LIT:
+            if ((now - s_phase_us) < s_wait_us)
+                return;
+            for (int i = 0; i < 2; i++)
+                s_side[i].st = bh1749_read_raw(s_addr[i], &s_side[i].lit);
+            start_phase(false);
+            s_state = STROBE_DARK;
+            break;
+
+        case STROBE_DARK:
+            if ((now - s_phase_us) < s_wait_us)
+                return;
+            for (int i = 0; i < 2; i++)
+            {
+                bh1749_color_data_t dark;
+                i2c_status_t st = bh1749_read_raw(s_addr[i], &dark);
+                if (st != I2C_OK)
+                    s_side[i].st = st;
+                if (s_side[i].st == I2C_OK)
+                    finish_pair(i, &dark);
+            }
+            s_seq++;
+            s_phase_us = micros();          // 휴지 시작 (LED OFF 유지)
+            s_state    = STROBE_IDLE;
+            break;
+    }
+}
+
+i2c_status_t color_strobe_read(uint8_t dev_addr, bh1749_color_data_t *out)
+{
+    const strobe_side_t *sd = side_of(dev_addr);
+
+    if (sd->st != I2C_OK || !sd->valid)
+    {
+        memset(out, 0, sizeof(*out));
+        return (sd->st != I2C_OK) ? sd->st : I2C_ERR_BUSY;
+    }
+
+    *out = sd->out;
+    return I2C_OK;
+}
+
+uint32_t color_strobe_seq(void)
+{
+    return s_seq;
+}
+
+void debug_print_color_strobe(void)
+{
+    uart_printf("=== COLOR STROBE (%s, pairs=%lu) ===\r\n", s_on ? "on" : "off", (unsigned long)s_seq);
+    for (int i = 0; i < 2; i++)
+    {
+        uart_printf("[%s] ambient max:%u valid:%d\r\n", i == 0 ? "LEFT " : "RIGHT",
+                    s_side[i].ambient, s_side[i].valid);
+    }
+}
+
+#else
+
+void         color_strobe_enable(bool on)   { (void)on; }
+bool         color_strobe_enabled(void)     { return false; }
+void         color_strobe_service(void)     { }
+i2c_status_t color_strobe_read(uint8_t dev_addr, bh1749_color_data_t *out)
+{
+    (void)dev_addr;
+    memset(out, 0, sizeof(*out));
+    return I2C_ERR_PARAM;
+}
+uint32_t     color_strobe_seq(void)         { return 0; }
+void         debug_print_color_strobe(void) { }
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * color_strobe.h
+ *
+ *  흰색 LED 스트로브 + 주변광 차감
+ *
+ *  LED ON 변환 1회 → LED OFF 변환 1회를 번갈아 하고 (ON - OFF)만 남겨
+ *  교실 조명/햇빛 성분을 지운다. LED 전환 때마다 변환을 재시작해
+ *  한 프레임에 두 조명 상태가 섞이지 않게 하고, 변환 1회 + 여유 후에 읽는다.
+ *  LED는 ON 프레임 동안만 켜지므로 평균 전류는 상시 점등의 절반 이하.
+ *  (AE 사용 시 노출 조정은 ON 프레임 기준 → 주변광+LED가 포화되지 않게)
+ *
+ *  켜져 있으면 bh1749_read()가 최신 차분 프레임을 돌려준다.
+ *  reference 캘리도 같은 모드에서 해야 스케일이 맞는다.
+ */
+
+#ifndef COLOR_COLOR_STROBE_H_
+#define COLOR_COLOR_STROBE_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#ifndef _USE_COLOR_STROBE
+#define _USE_COLOR_STROBE           1
+#endif
+
+// 부팅 시 스트로브 On/Off (Off = 기존처럼 LED 상시 점등)
+#ifndef COLOR_STROBE_DEFAULT_ON
+#define COLOR_STROBE_DEFAULT_ON     0
+#endif
+
+#ifndef COLOR_STROBE_MARGIN_MS
+#define COLOR_STROBE_MARGIN_MS      3U          // 변환 재시작 후 측정시간 + 이만큼 기다려 읽음
+#endif
+#ifndef COLOR_STROBE_IDLE_MS
+#define COLOR_STROBE_IDLE_MS        0U          // 한 쌍 끝난 뒤 LED OFF 휴지 (전류 추가 절감용)
+#endif
+
+
+void         color_strobe_enable(bool on);
+bool         color_strobe_enabled(void);
+
+// 메인 루프에서 호출 (논블로킹 상태머신, 한 쌍 ≈ 2 × (측정시간 + 여유))
+void         color_strobe_service(void);
+
+// 최신 차분 프레임 (정규화 후). 아직 없거나 마지막 읽기 실패면 그 상태
+i2c_status_t color_strobe_read(uint8_t dev_addr, bh1749_color_data_t *out);
+uint32_t     color_strobe_seq(void);    // 완료된 쌍 개수 (새 프레임 확인용)
+
+void         debug_print_color_strobe(void);
+
+
+#endif /* COLOR_COLOR_STROBE_H_ */
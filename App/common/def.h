@@ -42,6 +42,7 @@
 
 void delay_ms(uint32_t ms);
 uint32_t millis(void);
+uint32_t micros(void);   // TIM2 free-running 1 MHz (ap_init에서 가장 먼저 Start)
 
 
 
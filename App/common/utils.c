@@ -21,3 +21,20 @@ uint32_t millis(void)
 {
 	return HAL_GetTick();
 }
+
+uint32_t micros(void)
+{
+	return TIM2->CNT;
+}
+
+void cycles_init(void)
+{
+	DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t cycles(void)
+{
+	return DWT->CYCCNT;
+}
@@ -14,6 +14,11 @@
 
 void delay_ms(uint32_t ms);
 uint32_t millis(void);
+uint32_t micros(void);   // TIM2 free-running 1 MHz (ap_init에서 가장 먼저 Start)
+
+// DWT 사이클 카운터 (벤치마크용)
+void     cycles_init(void);
+uint32_t cycles(void);
 
 
 
@@ -38,6 +38,7 @@ typedef struct
     volatile uint8_t  press_flag;  // 눌림 엣지(pop)
     volatile uint16_t hold_ms;     // 누르고 있는 누적 시간(ms)
     volatile uint8_t  long_reported; // 이번 눌림 동안 long-press를 이미 보고했는지
+    volatile uint8_t  long_used;     // 이번 눌림이 long-press로 소비됨 (떼도 짧은 누름 아님, 디바운스된 뗌에서 해제)
 } btn_state_t;
 
 
@@ -45,6 +46,8 @@ static btn_state_t 	s_btn[BTN_COUNT];
 static uint32_t 	s_uptime_ms = 0;	//btn_update_1ms()가 올려주는 부팅 후 경과시간(ms)
 // 활성화 마스크: 1=활성, 0=비활성
 static uint32_t 	s_enable_mask = 0xFFFFFFFFu; // 기본 전체 활성
+// 뗌 보고 마스크: 1=눌림 이벤트를 떼는 순간에 (long-press로 소비되지 않았을 때만), 0=눌림 엣지에
+static uint32_t 	s_release_mask = 0u;
 
 
 static inline uint8_t btn_read_raw(btn_id_t id)
@@ -70,6 +73,7 @@ void btn_init(void)
         s_btn[i].press_flag  = 0u;
         s_btn[i].hold_ms     = 0u;
         s_btn[i].long_reported = 0u;
+        s_btn[i].long_used   = 0u;
     }
     s_uptime_ms = 0;
 }
@@ -85,6 +89,7 @@ void btn_update_1ms(void)
 			s_btn[i].press_flag    = 0u;
 			s_btn[i].hold_ms       = 0u;
 			s_btn[i].long_reported = 0u;
+			s_btn[i].long_used     = 0u;
             continue;
         }
 
@@ -114,9 +119,19 @@ void btn_update_1ms(void)
             s_btn[i].stable = raw;
             s_btn[i].cntr   = 0u;
 
+            bool on_release = ((s_release_mask >> i) & 1u) != 0u;
+
             if (prev == 0u && raw == 1u)  // 눌림 엣지
             {
-                s_btn[i].press_flag = 1u; // 여기선 enabled가 보장됨
+                s_btn[i].long_used = 0u;
+                if (!on_release)
+                    s_btn[i].press_flag = 1u; // 여기선 enabled가 보장됨
+            }
+            else if (prev == 1u && raw == 0u)  // 뗌 엣지: 길게 누름으로 쓰지 않은 짧은 누름만
+            {
+                if (on_release && !s_btn[i].long_used)
+                    s_btn[i].press_flag = 1u;
+                s_btn[i].long_used = 0u;
             }
         }
     }
@@ -170,6 +185,7 @@ bool btn_pop_long_press(btn_id_t id, uint16_t threshold_ms)
     if (s_btn[id].stable && (s_btn[id].hold_ms >= threshold_ms) && !s_btn[id].long_reported)
     {
         s_btn[id].long_reported = 1u;
+        s_btn[id].long_used     = 1u;
         return true;
     }
     return false;
@@ -191,6 +207,11 @@ uint32_t btn_enable_mask_get(void)
     return s_enable_mask;
 }
 
+void btn_release_mask_set(uint32_t mask)
+{
+    s_release_mask = mask;
+}
+
 static const char *btn_name(btn_id_t id)
 {
     switch (id)
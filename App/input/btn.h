@@ -43,7 +43,7 @@ void btn_update_1ms(void);
 bool btn_is_pressed(btn_id_t id);
 bool btn_get_press(btn_id_t id);
 bool btn_pop_any_press(btn_id_t *out_id);
-// 길게 누름 발생을 1회 팝(pop)하는 API
+// 길게 누름 발생을 1회 팝(pop)하는 API. 팝하면 이번 눌림은 소비됨 (뗌 보고 버튼은 짧은 누름 안 나옴)
 bool btn_pop_long_press(btn_id_t id, uint16_t threshold_ms);
 
 void btn_print_states(void);
@@ -53,6 +53,8 @@ void btn_print_one(btn_id_t id);
 // ▲ 활성화 마스크 API 추가
 void btn_enable_mask_set(uint32_t mask);
 uint32_t btn_enable_mask_get(void);
+// 같은 버튼에 짧은/긴 누름 기능이 같이 있을 때: 마스크 버튼은 눌림 이벤트를 뗄 때 보고
+void btn_release_mask_set(uint32_t mask);
 
 
 #endif /* INPUT_BTN_H_ */
@@ -0,0 +1,101 @@
+/*
+ * line_pos.c
+ *
+ *  좌/우 센서 → 라인 위치 추정
+ */
+
+
+#include "line_pos.h"
+#include "color_cls.h"
+#include "uart.h"
+
+
+typedef struct
+{
+    uint32_t black;         // 밝기 (calculate_brightness)
+    uint32_t inv_span_q16;  // 2^31 / (white - black) → d = (white - y) × inv >> 16 (Q15)
+} norm_t;
+
+static norm_t  s_norm[2];
+static bool    s_ready = false;
+static bool    s_lost  = true;
+static int32_t s_last_pos = 0;
+
+
+static bool calib_side(uint8_t side, norm_t *n)
+{
+    const reference_entry_t *tbl = color_side_table(side);
+    uint32_t black = calculate_brightness(tbl[COLOR_BLACK].raw.red_raw,
+                                          tbl[COLOR_BLACK].raw.green_raw,
+                                          tbl[COLOR_BLACK].raw.blue_raw);
+    uint32_t white = calculate_brightness(tbl[COLOR_WHITE].raw.red_raw,
+                                          tbl[COLOR_WHITE].raw.green_raw,
+                                          tbl[COLOR_WHITE].raw.blue_raw);
+
+    if (white < black + LINE_POS_MIN_SPAN)
+        return false;
+
+    n->black        = black;
+    n->inv_span_q16 = (uint32_t)((1ULL << 31) / (white - black));
+    return true;
+}
+
+bool line_pos_calibrate(void)
+{
+    s_ready = calib_side(BH1749_ADDR_LEFT,  &s_norm[0]) &&
+              calib_side(BH1749_ADDR_RIGHT, &s_norm[1]);
+
+    if (!s_ready)
+        uart_printf("[LPOS] BLACK/WHITE reference invalid -> calibrate first\r\n");
+
+    line_pos_reset();
+    return s_ready;
+}
+
+bool line_pos_ready(void)
+{
+    return s_ready;
+}
+
+void line_pos_reset(void)
+{
+    s_lost     = true;
+    s_last_pos = 0;
+}
+
+// 어두움 Q15: WHITE 이상 0, BLACK 이하 1
+static inline uint16_t darkness(const norm_t *n, const bh1749_color_data_t *c)
+{
+    uint32_t y = calculate_brightness(c->red, c->green, c->blue);
+
+    if (y <= n->black)
+        return LINE_POS_ONE;
+
+    uint32_t d = (uint32_t)(((uint64_t)(y - n->black) * n->inv_span_q16) >> 16);   // 밝음 Q15
+    return (d >= LINE_POS_ONE) ? 0 : (uint16_t)(LINE_POS_ONE - d);
+}
+
+bool line_pos_update(const bh1749_color_data_t *left, const bh1749_color_data_t *right,
+                     line_pos_t *out)
+{
+    if (!s_ready)
+        return false;
+
+    uint16_t dl  = darkness(&s_norm[0], left);
+    uint16_t dr  = darkness(&s_norm[1], right);
+    int32_t  sum = (int32_t)dl + dr;
+
+    if (s_lost ? (sum > LINE_POS_LOST_OFF) : (sum >= LINE_POS_LOST_ON))
+        s_lost = false;
+    else
+        s_lost = true;
+
+    if (!s_lost)
+        s_last_pos = (int32_t)dr - (int32_t)dl;
+
+    out->pos    = s_last_pos;
+    out->dark_l = dl;
+    out->dark_r = dr;
+    out->lost   = s_lost;
+    return true;
+}
@@ -0,0 +1,47 @@
+/*
+ * line_pos.h
+ *
+ *  좌/우 센서 → 라인 위치 추정
+ *
+ *  각 센서 밝기를 자기 BLACK/WHITE reference 사이로 정규화해 "어두움" d(0~1)를 구하고
+ *  pos = d_R - d_L  (Q15, -1 ~ +1, + = 라인이 오른쪽)
+ *  로 낸다. 두 센서가 라인 양 가장자리에 걸친 배치에서 거의 선형이고,
+ *  매트 밝기/센서 감도 차이가 정규화로 빠지므로 같은 게인이 다른 매트에서도 통한다.
+ *  d_L + d_R이 작으면(둘 다 흰 바닥) 라인 놓침(히스테리시스).
+ */
+
+#ifndef MOTION_LINE_POS_H_
+#define MOTION_LINE_POS_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#define LINE_POS_ONE            (1 << 15)                   // Q15 1.0
+#define LINE_POS_MIN_SPAN       64U                         // WHITE - BLACK 최소 밝기 차 (미만이면 캘리 무효)
+#define LINE_POS_LOST_ON        ((LINE_POS_ONE * 12) / 100) // d_L + d_R < 0.12 → 놓침
+#define LINE_POS_LOST_OFF       ((LINE_POS_ONE * 20) / 100) // d_L + d_R > 0.20 → 다시 찾음
+
+
+typedef struct
+{
+    int32_t  pos;           // Q15, + = 라인이 오른쪽 (놓침이면 마지막 유효값 유지)
+    uint16_t dark_l;        // Q15
+    uint16_t dark_r;        // Q15
+    bool     lost;
+} line_pos_t;
+
+
+// reference 테이블의 BLACK/WHITE로 정규화 계수 계산 (캘리/로드 후 호출)
+bool    line_pos_calibrate(void);
+bool    line_pos_ready(void);
+
+// 샘플 한 쌍 → 위치. 정규화 계수가 없으면 false
+bool    line_pos_update(const bh1749_color_data_t *left, const bh1749_color_data_t *right,
+                        line_pos_t *out);
+
+void    line_pos_reset(void);
+
+
+#endif /* MOTION_LINE_POS_H_ */
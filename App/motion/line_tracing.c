@@ -6,50 +6,146 @@
  */
 
 
-#include <stdlib.h>
 #include "line_tracing.h"
 
 // 프로젝트 환경에 맞게 필요한 헤더로 교체/추가하세요.
 #include "color.h"     // bh1749_read_rgbc, BH1749_ADDR_LEFT/RIGHT
+#include "color_health.h"
+#include "line_pos.h"
+#include "lt_autotune.h"
+#include "lt_mark.h"
+#include "lt_search.h"
+#include "pid.h"
+#include "speed_sched.h"
 #include "stepper.h"    // step_drive, step_drive_ratio, OP_*
 #include "uart.h"       // (옵션) 디버깅 출력
 
 static lt_config_t g_cfg;
 static bool        g_enabled = false;
 
-static float   prev_error = 0.0f;
-static float   integral   = 0.0f;
-static uint32_t prev_ms   = 0;
-
-static uint8_t  offset_side_local = 0;   // 0: RIGHT, 1: LEFT (프로젝트 정의에 맞게 사용)
-static uint16_t offset_avg_local  = 0;
+static pid_q16_t g_pid;
+static speed_sched_t g_sched;
+static uint32_t s_prev_step_us = 0;      // 마지막 새 변환으로 제어한 시각
+static uint32_t s_prev_tick_us = 0;      // 마지막 구동 주기 시각
+static uint32_t s_frame_seq[2];          // 마지막으로 쓴 좌/우 변환 번호
+static bool     sensor_halt = false;      // 센서 고장으로 정지 중
+static bool     s_tuning = false;         // 릴레이 자동 튜닝 중
 
+// 주행 상태: 추종 → (놓침) 재탐색 → 추종, 추종 → (교차로 + 회전 마크) 회전 → 추종
+typedef enum
+{
+    LT_ST_FOLLOW = 0,
+    LT_ST_SEARCH,
+    LT_ST_TURN
+} lt_state_t;
+
+static lt_state_t    s_state = LT_ST_FOLLOW;
+static int32_t       s_last_steer = 0;
+static lt_mark_act_t s_pending_turn = LT_MARK_NONE;     // 다음 교차로에서 할 회전
+static int8_t        s_turn_dir = 0;
+static uint32_t      s_turn_ms = 0;
+static uint8_t       s_junc_hits = 0;
+static color_result_t s_cl, s_cr;                       // 마지막 새 변환의 좌/우 분류
+static bool          s_on_mark = false;
+static bool          s_slow = false;
+static uint32_t      s_slow_until_ms = 0;
+
+// 타이머(1ms ISR)가 interval_ms마다 제어 1회를 "릴리스" → 메인 루프가 실행
+static volatile bool     s_release    = false;
+static volatile uint32_t s_release_us = 0;
+static volatile uint32_t s_missed     = 0;  // 이전 릴리스를 아직 못 돌았는데 다음 릴리스
+static uint8_t           s_div        = 0;
+static uint32_t          s_prev_rel_us = 0;
+static lt_stats_t        s_stats;
+
+
+static inline uint32_t ticks_to_rate(uint16_t ticks)
+{
+    return ticks ? (LT_TICK_HZ / ticks) : 0u;
+}
 
-extern uint8_t  offset_side;
-extern uint16_t offset_average;
+// 스텝/s → period tick, [min, max] 클램프
+static inline uint16_t rate_to_ticks(uint32_t rate)
+{
+    uint32_t t = rate ? (LT_TICK_HZ / rate) : g_cfg.max_ticks;
 
+    if (t < g_cfg.min_ticks) t = g_cfg.min_ticks;
+    if (t > g_cfg.max_ticks) t = g_cfg.max_ticks;
+    return (uint16_t)t;
+}
 
 void line_tracing_init(const lt_config_t *cfg)
 {
     g_cfg = *cfg;
     g_enabled   = false;
-    prev_error  = 0.0f;
-    integral    = 0.0f;
-    prev_ms     = 0;
+    if (g_cfg.interval_ms == 0)
+    {
+        g_cfg.interval_ms = LT_DEFAULT_INTERVAL_MS;
+    }
+
+    // 이 속도에서 자동 튜닝한 게인이 저장돼 있으면 그것을 사용
+    if (lt_autotune_load(g_cfg.base_ticks, &g_cfg.Kp, &g_cfg.Ki, &g_cfg.Kd))
+    {
+        uart_printf("[LT] tuned gains (x1000) Kp=%ld Ki=%ld Kd=%ld\r\n",
+                    (long)(g_cfg.Kp * 1000.0f), (long)(g_cfg.Ki * 1000.0f), (long)(g_cfg.Kd * 1000.0f));
+    }
 
-    offset_avg_local = offset_average;
-    offset_side_local = offset_side;
+    // 오차 = 라인 위치 Q15, 출력 = 조향비 Q15
+    const pid_cfg_t pc =
+    {
+        .kp = PID_Q16(g_cfg.Kp), .ki = PID_Q16(g_cfg.Ki), .kd = PID_Q16(g_cfg.Kd),
+        .kaw = PID_Q16(LT_PID_KAW), .d_tau_us = LT_PID_D_TAU_US,
+        .out_min = -LT_STEER_MAX, .out_max = LT_STEER_MAX,
+    };
+    pid_init(&g_pid, &pc);
+
+    uint16_t fast = g_cfg.fast_ticks ? g_cfg.fast_ticks : g_cfg.base_ticks;
+    const speed_sched_cfg_t sc =
+    {
+        .v_min = ticks_to_rate(g_cfg.base_ticks), .v_max = ticks_to_rate(fast),
+        .wheel_max = ticks_to_rate(g_cfg.min_ticks),
+        .accel = LT_SCHED_ACCEL, .decel = LT_SCHED_DECEL,
+        .k_full = LT_SCHED_K_FULL, .lookahead_us = LT_SCHED_LOOKAHEAD_US, .tau_us = LT_SCHED_TAU_US,
+    };
+    speed_sched_init(&g_sched, &sc);
+
+    lt_mark_init();
+    line_pos_calibrate();
 }
 
 void line_tracing_enable(bool on)
 {
-    g_enabled = on;
+    if (on == g_enabled)
+    {
+        return;
+    }
 
     if (on)
     {
-        prev_error = 0.0f;
-        integral   = 0.0f;
-        prev_ms    = 0;
+        // 캘리가 바뀌었을 수 있으니 BLACK/WHITE 정규화 다시 계산 (없으면 출발 안 함)
+        if (!line_pos_calibrate())
+        {
+            return;
+        }
+
+        pid_reset(&g_pid, 0);              // 직진(보정 0)에서 무충격 시작
+        speed_sched_reset(&g_sched, ticks_to_rate(g_cfg.base_ticks));   // 커브 속도에서 가속 시작
+        s_prev_step_us = 0;
+        s_prev_tick_us = 0;
+        sensor_halt = false;
+        s_state     = LT_ST_FOLLOW;
+        s_last_steer   = 0;
+        s_pending_turn = LT_MARK_NONE;
+        s_junc_hits    = 0;
+        s_on_mark      = false;
+        s_slow         = false;
+        speed_sched_set_limit(&g_sched, 0);
+        lt_mark_reset();
+        s_release   = false;
+        s_div       = 0;
+        s_prev_rel_us = 0;
+        line_tracing_reset_stats();
+        g_enabled   = true;
 
         // 구동 가능 상태
         step_set_hold(HOLD_BRAKE);
@@ -57,8 +153,15 @@ void line_tracing_enable(bool on)
     }
     else
     {
+        if (s_tuning)
+        {
+            lt_autotune_abort();
+            s_tuning = false;
+        }
+        g_enabled = false;
         step_coast_stop();
     }
+    uart_printf("[LT] %s\r\n", on ? "start" : "stop");
 }
 
 bool line_tracing_enabled(void)
@@ -66,111 +169,389 @@ bool line_tracing_enabled(void)
     return g_enabled;
 }
 
-void line_tracing_set_offset(uint8_t side, uint16_t avg)
-{
-    offset_side_local = side;
-    offset_avg_local  = avg;
-}
-
 void line_tracing_set_gains(float kp, float ki, float kd)
 {
     g_cfg.Kp = kp;
     g_cfg.Ki = ki;
     g_cfg.Kd = kd;
+    pid_set_gains(&g_pid, kp, ki, kd);
 }
 
-static inline uint32_t brightness(uint16_t r, uint16_t g, uint16_t b)
+bool line_tracing_autotune(void)
 {
-    // 프로젝트의 calculate_brightness()가 따로 있으면 그걸 사용해도 됩니다.
-    return (uint32_t)r + g + b;
+    if (!g_enabled)
+    {
+        line_tracing_enable(true);
+        if (!g_enabled)
+            return false;
+    }
+
+    lt_autotune_start(micros());
+    s_tuning = true;
+    return true;
 }
 
-void line_tracing_update(uint32_t now_ms)
+bool line_tracing_tuning(void)
 {
-    if (!g_enabled)
+    return s_tuning;
+}
+
+// 튜닝 종료: 성공이면 게인 적용/저장 후 PID로 계속 주행, 실패면 정지
+static void lt_autotune_finish(void)
+{
+    lt_at_result_t r;
+
+    s_tuning = false;
+    if (!lt_autotune_result(&r))
     {
+        line_tracing_enable(false);
         return;
     }
 
-    if (g_cfg.interval_ms == 0)
+    // newlib-nano printf에 float 없음 → ×1000 정수로 출력
+    uart_printf("[AT] (x1000) Ku=%ld Tu=%ldms a=%ld -> Kp=%ld Ki=%ld Kd=%ld\r\n",
+                (long)(r.ku * 1000.0f), (long)(r.tu_s * 1000.0f), (long)(r.amp * 1000.0f),
+                (long)(r.kp * 1000.0f), (long)(r.ki * 1000.0f), (long)(r.kd * 1000.0f));
+    line_tracing_set_gains(r.kp, r.ki, r.kd);
+    lt_autotune_save(&r, g_cfg.base_ticks);
+
+    pid_reset(&g_pid, 0);
+    speed_sched_reset(&g_sched, ticks_to_rate(g_cfg.base_ticks));
+}
+
+void line_tracing_tick_1ms(void)
+{
+    if (!g_enabled || ++s_div < g_cfg.interval_ms)
     {
-        g_cfg.interval_ms = 5;
+        return;
     }
+    s_div = 0;
 
-    if (prev_ms && (uint32_t)(now_ms - prev_ms) < g_cfg.interval_ms)
+    if (s_release)
     {
-        return;
+        s_missed++;
     }
+    s_release_us = micros();
+    s_release    = true;
+}
+
+// 차동 주행: 좌 = v(1 - s), 우 = v(1 + s)
+static void lt_drive(uint32_t v, int32_t steer)
+{
+    if (steer >  SPEED_SCHED_ONE) steer =  SPEED_SCHED_ONE;
+    if (steer < -SPEED_SCHED_ONE) steer = -SPEED_SCHED_ONE;
+
+    uint32_t rate_l = (uint32_t)(((uint64_t)v * (uint32_t)(SPEED_SCHED_ONE - steer)) >> 15);
+    uint32_t rate_r = (uint32_t)(((uint64_t)v * (uint32_t)(SPEED_SCHED_ONE + steer)) >> 15);
+
+    step_drive(OP_FORWARD);
+    step_drive_ratio(rate_to_ticks(rate_l), rate_to_ticks(rate_r));
+}
 
-    prev_ms = now_ms;
+// 제자리 회전 (+1 = 왼쪽), base 속도
+static void lt_rotate(int8_t dir)
+{
+    step_drive((dir > 0) ? OP_TURN_LEFT : OP_TURN_RIGHT);
+    step_drive_ratio(g_cfg.base_ticks, g_cfg.base_ticks);
+}
+
+// 재탐색/회전 뒤 추종 복귀: 직진 보정 0, 커브 속도부터 다시 가속
+static void lt_follow_resume(void)
+{
+    s_state      = LT_ST_FOLLOW;
+    s_junc_hits  = 0;
+    s_last_steer = 0;
+    pid_reset(&g_pid, 0);
+    speed_sched_reset(&g_sched, ticks_to_rate(g_cfg.base_ticks));
+}
+
+// 확정된 색 마크 처리. 정지면 true
+static bool lt_on_mark(color_t mark, uint32_t now_ms)
+{
+    lt_mark_act_t act = lt_mark_action(mark);
+
+    uart_printf("[LT] mark %s -> %s\r\n", color_to_string(mark), lt_mark_act_name(act));
+    switch (act)
+    {
+        case LT_MARK_STOP:
+            line_tracing_enable(false);
+            return true;
+
+        case LT_MARK_SLOW:
+            s_slow          = true;
+            s_slow_until_ms = now_ms + LT_MARK_SLOW_MS;
+            speed_sched_set_limit(&g_sched, ticks_to_rate(g_cfg.base_ticks));
+            break;
+
+        case LT_MARK_TURN_LEFT:
+        case LT_MARK_TURN_RIGHT:
+            s_pending_turn = act;
+            s_junc_hits    = 0;
+            break;
+
+        default:
+            break;
+    }
+    return false;
+}
+
+// 제어 1회: 센서 → 위치/색 → (상태별) 조향 → 모터
+static void lt_step(uint32_t now_us)
+{
+    // ── 센서 고장: 좌/우 차이로 조향하므로 한쪽만으론 불가 → 정지, 회복 시 재출발 ──
+    if (!color_health_usable(BH1749_ADDR_LEFT) || !color_health_usable(BH1749_ADDR_RIGHT))
+    {
+        if (!sensor_halt)
+        {
+            sensor_halt = true;
+            step_coast_stop();
+            uart_printf("[LT] sensor fault -> halt\r\n");
+        }
+        return;
+    }
+    if (sensor_halt)
+    {
+        sensor_halt = false;
+        pid_reset(&g_pid, 0);
+        speed_sched_reset(&g_sched, ticks_to_rate(g_cfg.base_ticks));
+        step_set_hold(HOLD_BRAKE);
+        step_drive(OP_FORWARD);
+        uart_printf("[LT] sensor ok -> resume\r\n");
+    }
 
     // ── 센서 읽기(폴링; ISR에서 호출 금지) ─────────────────────────────
-    bh1749_color_data_t L = bh1749_read_rgbir(BH1749_ADDR_LEFT);
-    bh1749_color_data_t R = bh1749_read_rgbir(BH1749_ADDR_RIGHT);
+    bh1749_color_data_t L, R;
+    if (bh1749_read(BH1749_ADDR_LEFT,  &L) != I2C_OK ||
+        bh1749_read(BH1749_ADDR_RIGHT, &R) != I2C_OK)
+    {
+        // 버스 에러: 이번 주기는 이전 명령 유지
+        return;
+    }
+
+    // ── 라인 위치 (BLACK/WHITE 정규화, Q15) ──────────────────────────
+    line_pos_t lp;
+    if (!line_pos_update(&L, &R, &lp))
+    {
+        return;                                 // 캘리 없음
+    }
 
-    uint32_t lb = calculate_brightness(L.red, L.green, L.blue);
-    uint32_t rb = calculate_brightness(R.red, R.green, R.blue);
+    // ── 새 변환인지: 센서는 35ms마다 갱신, 제어 주기(5ms)마다 같은 값이 반복된다 ──
+    // 오차/미분/곡률은 새 변환에서만 (변환 간 dt), 구동은 매 주기
+    uint32_t seq_l = color_frame_seq(BH1749_ADDR_LEFT);
+    uint32_t seq_r = color_frame_seq(BH1749_ADDR_RIGHT);
+    bool     fresh = (seq_l != s_frame_seq[0]) || (seq_r != s_frame_seq[1]) || s_prev_step_us == 0;
+    s_frame_seq[0] = seq_l;
+    s_frame_seq[1] = seq_r;
+
+    uint32_t now_ms  = millis();
+    int32_t  error   = -lp.pos;                 // + = 라인이 왼쪽 → 왼쪽으로 (s > 0)
+    uint32_t tick_dt = s_prev_tick_us ? (now_us - s_prev_tick_us) : (g_cfg.interval_ms * 1000u);
+    uint32_t dt      = s_prev_step_us ? (now_us - s_prev_step_us) : tick_dt;
+    s_prev_tick_us = now_us;
+    if (fresh)
+    {
+        s_prev_step_us = now_us;
+    }
 
-    // 오프셋 보정(측정 환경 따라 한쪽만 기준치 빼기)
-    if (offset_side_local)   // LEFT 기준
+    if (s_tuning)
     {
-        if (lb > offset_avg_local)
+        // ── 릴레이 실험: base 속도 고정 (게인은 이 속도 기준) ─────────────
+        if (!fresh)
         {
-            lb -= offset_avg_local;
+            return;                             // 릴레이 출력 유지
         }
+        if (lp.lost)
+        {
+            lt_autotune_abort();                // 릴레이 진폭이 라인 폭을 넘음 → 실험 무효
+        }
+        int32_t steer = lt_autotune_step(error, now_us);
+        if (lt_autotune_state() != LT_AT_RUNNING)
+        {
+            lt_autotune_finish();
+            return;
+        }
+        lt_drive(ticks_to_rate(g_cfg.base_ticks), steer);
+        return;
     }
-    else                     // RIGHT 기준
+
+    // ── 색 마크: 같은 샘플로 분류 (추가 I2C 없음), 확정 횟수는 변환 단위 ────
+    if (fresh)
     {
-        if (rb > offset_avg_local)
+        s_cl = classify_color_ex(BH1749_ADDR_LEFT,  L.red, L.green, L.blue, L.ir);
+        s_cr = classify_color_ex(BH1749_ADDR_RIGHT, R.red, R.green, R.blue, R.ir);
+        color_t mark = lt_mark_update(&s_cl, &s_cr, &s_on_mark);
+        if (mark != COLOR_UNKNOWN && lt_on_mark(mark, now_ms))
         {
-            rb -= offset_avg_local;
+            return;                             // 정지 마크
         }
     }
 
-    // ── PID ────────────────────────────────────────────────────────────
-    float error      = (float)rb - (float)lb;
-    // integral      += error * dt;  // dt가 필요하면 interval_ms 사용
-    float derivative = error - prev_error;
-    float output     = g_cfg.Kp * error + g_cfg.Ki * integral + g_cfg.Kd * derivative;
-    prev_error       = error;
+    if (s_slow && (int32_t)(now_ms - s_slow_until_ms) >= 0)
+    {
+        s_slow = false;
+        speed_sched_set_limit(&g_sched, 0);     // 램프로 다시 가속
+    }
+
+    switch (s_state)
+    {
+        case LT_ST_TURN:
+        {
+            // 최소 회전 후 라인이 중앙 근처에 오면 추종 복귀 (최대 시간 넘으면 그냥 복귀)
+            uint32_t t = now_ms - s_turn_ms;
+            bool centred = !lp.lost && lp.pos > -LT_TURN_DONE_POS && lp.pos < LT_TURN_DONE_POS;
+            if ((t >= LT_TURN_MIN_MS && centred) || t >= LT_TURN_MAX_MS)
+            {
+                lt_follow_resume();
+                break;
+            }
+            lt_rotate(s_turn_dir);
+            return;
+        }
+
+        case LT_ST_SEARCH:
+        {
+            if (!lp.lost)
+            {
+                uart_printf("[LT] line found (%s)\r\n",
+                            lt_search_phase() == LT_SEARCH_COAST ? "coast" :
+                            lt_search_phase() == LT_SEARCH_SWEEP ? "sweep" : "spiral");
+                lt_follow_resume();
+                break;
+            }
+
+            lt_search_cmd_t cmd;
+            if (!lt_search_step(now_ms, &cmd))
+            {
+                uart_printf("[LT] line not found -> stop\r\n");
+                line_tracing_enable(false);
+                return;
+            }
+            if (cmd.rotate != 0)
+                lt_rotate(cmd.rotate);
+            else
+                lt_drive(ticks_to_rate(g_cfg.base_ticks), cmd.steer);
+            return;
+        }
+
+        default:
+            break;
+    }
 
-    // ── 속도(=period ticks) 계산 ───────────────────────────────────────
-    uint32_t left_ticks  = (float)g_cfg.base_ticks + output;
-    uint32_t right_ticks = (float)g_cfg.base_ticks - output;
+    // ── 추종 ─────────────────────────────────────────────────────────
+    if (s_on_mark)
+    {
+        return;                                 // 색 패드 위: 밝기 위치 무의미 → 이전 명령 유지
+    }
 
+    if (lp.lost)
+    {
+        // 놓치기 직전 라인 쪽부터 탐색 (pos ≤ 0 = 왼쪽)
+        lt_search_start(now_ms, (lp.pos <= 0) ? 1 : -1, s_last_steer);
+        s_state = LT_ST_SEARCH;
+        uart_printf("[LT] line lost -> search\r\n");
+        return;
+    }
 
+    // 회전 마크 대기 중 교차로(양쪽 모두 어둡고 BLACK) → 제자리 회전
+    // 색 패드도 어둡게 보이므로 밝기만으로는 교차로로 오인한다
+    if (s_pending_turn != LT_MARK_NONE && fresh)
+    {
+        if (lp.dark_l >= LT_JUNC_DARK && lp.dark_r >= LT_JUNC_DARK &&
+            s_cl.cls == COLOR_BLACK && s_cr.cls == COLOR_BLACK)
+        {
+            if (++s_junc_hits >= LT_JUNC_CONFIRM)
+            {
+                s_turn_dir     = (s_pending_turn == LT_MARK_TURN_LEFT) ? 1 : -1;
+                s_pending_turn = LT_MARK_NONE;
+                s_turn_ms      = now_ms;
+                s_state        = LT_ST_TURN;
+                uart_printf("[LT] junction -> turn %s\r\n", s_turn_dir > 0 ? "left" : "right");
+                lt_rotate(s_turn_dir);
+                return;
+            }
+        }
+        else
+        {
+            s_junc_hits = 0;
+        }
+    }
 
-    // 데드존 완화
-    if (abs((int)output) < 200)
+    // ── PID (Q16, 변환 간 dt) → 조향비. 같은 프레임이면 이전 조향 유지 ──
+    if (fresh)
     {
-        left_ticks  = (float)g_cfg.base_ticks;
-        right_ticks = (float)g_cfg.base_ticks;
+        s_last_steer = pid_update(&g_pid, error, now_us);
+
+        // 곡률 기반 목표 속도 (직선 가속 / 커브 전 감속)
+        speed_sched_estimate(&g_sched, lp.pos, s_last_steer, dt);
     }
+    int32_t steer = s_last_steer;
+
+    // ── 가감속 한계 램프는 매 주기 (속도 계단 없이) ──────────────────────
+    uint32_t v = speed_sched_ramp(&g_sched, tick_dt);
 
-    // 한계 클램프
-    if (left_ticks  < g_cfg.min_ticks) left_ticks  = (float)g_cfg.min_ticks;
-    if (right_ticks < g_cfg.min_ticks) right_ticks = (float)g_cfg.min_ticks;
-    if (left_ticks  > g_cfg.max_ticks) left_ticks  = (float)g_cfg.max_ticks;
-    if (right_ticks > g_cfg.max_ticks) right_ticks = (float)g_cfg.max_ticks;
+    // ── 차동 조향: 제자리 회전 대신 좌/우 속도 차 ───────────────────────
+    lt_drive(v, steer);
+}
 
-    // ── 조향(느리면 제자리 턴) ────────────────────────────────────────
-    if (left_ticks < 800.0f || right_ticks < 800.0f)
+void line_tracing_service(void)
+{
+    if (!g_enabled || !s_release)
     {
-        step_drive((left_ticks < right_ticks) ? OP_TURN_RIGHT : OP_TURN_LEFT);
+        return;
     }
-    else
+
+    __disable_irq();
+    uint32_t rel = s_release_us;
+    s_release    = false;
+    __enable_irq();
+
+    uint32_t t0 = micros();
+    lt_step(t0);
+    uint32_t exec = micros() - t0;
+
+    // 릴리스 → 실행 시작 지연, 릴리스 간격 흔들림, 실행 시간
+    uint32_t lat = t0 - rel;
+    if (lat  > s_stats.lat_max_us)  s_stats.lat_max_us  = lat;
+    if (exec > s_stats.exec_max_us) s_stats.exec_max_us = exec;
+    s_stats.exec_sum_us += exec;
+    s_stats.lat_sum_us  += lat;
+
+    if (s_prev_rel_us != 0)
     {
-        step_drive(OP_FORWARD);
+        uint32_t period = rel - s_prev_rel_us;
+        if (period < s_stats.period_min_us) s_stats.period_min_us = period;
+        if (period > s_stats.period_max_us) s_stats.period_max_us = period;
     }
+    s_prev_rel_us = rel;
+    s_stats.runs++;
+    s_stats.missed = s_missed;
+}
 
-    step_drive_ratio((uint16_t)left_ticks, (uint16_t)right_ticks);
+const lt_stats_t* line_tracing_stats(void)
+{
+    return &s_stats;
+}
 
-	uart_printf("g_cfg_base_ticks: %d\r\n", g_cfg.base_ticks);
-	uart_printf("g_cfg_min_ticks: %d\r\n", g_cfg.min_ticks);
-	uart_printf("g_cfg_max_ticks: %d\r\n", g_cfg.max_ticks);
-	uart_printf("left_ticks: %d | right_ticks: %d\r\n", left_ticks, right_ticks);
+void line_tracing_reset_stats(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.period_min_us = UINT32_MAX;
+    s_missed = 0;
+}
 
-    // (옵션) 디버깅
-    // uart_printf("[LT] lb:%lu rb:%lu err:%0.2f out:%0.2f L:%0.1f R:%0.1f\r\n",
-    //             (unsigned long)lb, (unsigned long)rb, error, output, left_ticks, right_ticks);
+void line_tracing_print_stats(void)
+{
+    const lt_stats_t *st = &s_stats;
+    uint32_t n = st->runs ? st->runs : 1;
+
+    uart_printf("=== LINE TRACING %u Hz (%s) ===\r\n", 1000u / g_cfg.interval_ms, g_enabled ? "run" : "stop");
+    uart_printf("runs:%lu missed:%lu\r\n", (unsigned long)st->runs, (unsigned long)st->missed);
+    uart_printf("latency avg:%luus max:%luus | exec avg:%luus max:%luus\r\n",
+                (unsigned long)(st->lat_sum_us / n), (unsigned long)st->lat_max_us,
+                (unsigned long)(st->exec_sum_us / n), (unsigned long)st->exec_max_us);
+    if (st->runs > 1)
+    {
+        uart_printf("period min:%luus max:%luus\r\n",
+                    (unsigned long)st->period_min_us, (unsigned long)st->period_max_us);
+    }
 }
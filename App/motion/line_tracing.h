@@ -15,17 +15,64 @@
 
 
 
+// 기본 설정 (ap_init)
+#define LT_DEFAULT_INTERVAL_MS  5U          // 200 Hz 제어
+#define LT_DEFAULT_BASE_TICKS   1500U       // 급커브 기준 속도
+#define LT_DEFAULT_FAST_TICKS   800U        // 직선 기준 속도
+#define LT_DEFAULT_MIN_TICKS    500U
+#define LT_DEFAULT_MAX_TICKS    2500U
+#define LT_DEFAULT_KP           0.8f
+#define LT_DEFAULT_KI           0.3f
+#define LT_DEFAULT_KD           0.03f
+
+#define LT_PID_KAW          4.0f        // back-calculation 게인 (1/s)
+#define LT_PID_D_TAU_US     15000U      // 미분 LPF 시정수 (센서 35ms 변환 계단 완화)
+
+// 차동 조향: 좌 = v(1 - s), 우 = v(1 + s). |s| ≤ STEER_MAX → 안쪽 바퀴도 전진 (제자리 회전 없음)
+#define LT_STEER_MAX        ((int32_t)(0.85f * 32768))
+
+// 속도 스케줄 (스텝/s = LT_TICK_HZ / period tick)
+#define LT_TICK_HZ          1000000U    // 스테퍼 period tick = TIM2 1µs
+#define LT_SCHED_ACCEL      3000U       // 스텝/s²
+#define LT_SCHED_DECEL      10000U      // 스텝/s²
+#define LT_SCHED_K_FULL     ((int32_t)(0.45f * 32768))  // 이 곡률(Q15) 이상이면 base 속도
+#define LT_SCHED_LOOKAHEAD_US   60000U
+#define LT_SCHED_TAU_US     100000U
+
+// 색 마크 동작 / 교차로 회전
+#define LT_MARK_SLOW_MS     3000U       // SLOW 마크: 이 시간 동안 base 속도 제한
+#define LT_JUNC_DARK        ((uint16_t)(0.60f * 32768))     // 양쪽 어두움 ≥ 이 값 → 교차로
+#define LT_JUNC_CONFIRM     2U          // 연속 변환
+#define LT_TURN_MIN_MS      300U        // 원래 라인을 벗어날 최소 회전 시간
+#define LT_TURN_MAX_MS      2500U
+#define LT_TURN_DONE_POS    ((int32_t)(0.30f * 32768))      // |pos| < 이 값이면 새 라인 잡음
+
+
 typedef struct
 {
-    float    Kp;
-    float    Ki;
-    float    Kd;
-    uint16_t base_ticks;   // 예: 1500
-    uint16_t min_ticks;    // 예: 500
-    uint16_t max_ticks;    // 예: 2500
-    uint8_t  interval_ms;  // PID 갱신 간격(예: 5ms)
+    float    Kp;           // 조향비 / 위치 (둘 다 ±1 스케일)
+    float    Ki;           // 조향비 / (위치·s)
+    float    Kd;           // 조향비·s / 위치
+    uint16_t base_ticks;   // 급커브 기준 속도 (예: 1500)
+    uint16_t fast_ticks;   // 직선 기준 속도 (0 = 스케줄 없이 base 고정)
+    uint16_t min_ticks;    // 바퀴 최고 속도 (예: 500)
+    uint16_t max_ticks;    // 바퀴 최저 속도 (예: 2500)
+    uint8_t  interval_ms;  // 제어 주기(예: 5ms = 200Hz), 타이머 1ms 단위
 } lt_config_t;
 
+// 제어 주기 통계 (릴리스 = 타이머가 제어 1회를 허락한 시각)
+typedef struct
+{
+    uint32_t runs;
+    uint32_t missed;            // 실행 전에 다음 릴리스가 온 횟수 (주기 초과)
+    uint32_t lat_max_us;        // 릴리스 → 실행 시작
+    uint64_t lat_sum_us;
+    uint32_t exec_max_us;       // 제어 1회 실행 시간
+    uint64_t exec_sum_us;
+    uint32_t period_min_us;     // 릴리스 간격
+    uint32_t period_max_us;
+} lt_stats_t;
+
 
 
 
@@ -33,10 +80,18 @@ void line_tracing_init(const lt_config_t *cfg);
 void line_tracing_enable(bool on);
 bool line_tracing_enabled(void);
 
-void line_tracing_set_offset(uint8_t side, uint16_t avg);
 void line_tracing_set_gains(float kp, float ki, float kd);
 
-void line_tracing_update(uint32_t now_ms);
+// 릴레이 자동 튜닝 시작 (정지 중이면 출발). 끝나면 게인 적용·플래시 저장 후 계속 주행
+bool line_tracing_autotune(void);
+bool line_tracing_tuning(void);
+
+void line_tracing_tick_1ms(void);      // 1ms ISR: interval_ms마다 제어 1회 릴리스
+void line_tracing_service(void);       // 메인 루프: 릴리스됐으면 제어 1회 실행 + 통계
+
+const lt_stats_t* line_tracing_stats(void);
+void line_tracing_reset_stats(void);
+void line_tracing_print_stats(void);
 
 
 #endif /* MOTION_LINE_TRACING_H_ */
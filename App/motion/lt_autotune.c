@@ -0,0 +1,218 @@
+/*
+ * lt_autotune.c
+ *
+ *  라인트레이싱 PID 자동 튜닝 (릴레이 실험)
+ */
+
+
+#include "lt_autotune.h"
+#include "flash_kv.h"
+#include "uart.h"
+
+#include <math.h>
+
+
+#if (_USE_LT_AUTOTUNE == 1)
+
+// KV_KEY_LT_GAINS 값
+typedef struct
+{
+    uint16_t base_ticks;
+    uint16_t _rsv;
+    float    kp, ki, kd;
+    float    ku, tu_s;
+} at_rec_t;
+
+static lt_at_state_t  s_state = LT_AT_IDLE;
+static lt_at_result_t s_res;
+
+static uint32_t s_start_us;
+static int32_t  s_out;              // 현재 릴레이 출력 ±d
+static uint32_t s_rises;            // -d → +d 전환 횟수
+static uint32_t s_last_rise_us;
+static int32_t  s_max, s_min;       // 이번 주기 오차 극값
+static uint32_t s_period_us[LT_AT_CYCLES];
+static int32_t  s_amp[LT_AT_CYCLES];
+
+
+static void fail(const char *why)
+{
+    s_state = LT_AT_FAILED;
+    uart_printf("[AT] failed: %s\r\n", why);
+}
+
+// 측정 주기 평균 → Ku, Tu → 게인
+static void finish(void)
+{
+    uint64_t p_sum = 0, a_sum = 0;
+
+    for (uint32_t i = 0; i < LT_AT_CYCLES; i++)
+    {
+        p_sum += s_period_us[i];
+        a_sum += (uint32_t)s_amp[i];
+    }
+    uint32_t p_avg = (uint32_t)(p_sum / LT_AT_CYCLES);
+    uint32_t tol   = (p_avg * LT_AT_PERIOD_TOL_PCT) / 100u;
+
+    for (uint32_t i = 0; i < LT_AT_CYCLES; i++)
+    {
+        uint32_t d = (s_period_us[i] > p_avg) ? (s_period_us[i] - p_avg) : (p_avg - s_period_us[i]);
+        if (d > tol)
+        {
+            fail("irregular oscillation");
+            return;
+        }
+    }
+
+    const float one = 32768.0f;
+    float a   = (float)a_sum / LT_AT_CYCLES / one;
+    float eps = (float)LT_AT_HYST / one;
+    float d   = (float)LT_AT_RELAY / one;
+
+    if (a <= eps * 1.1f)
+    {
+        fail("amplitude too small");
+        return;
+    }
+
+    s_res.amp  = a;
+    s_res.tu_s = (float)p_avg * 1e-6f;
+    s_res.ku   = (4.0f * d) / (3.14159265f * sqrtf(a * a - eps * eps));
+
+    float ti = LT_AT_TI_TU * s_res.tu_s;
+    float td = LT_AT_TD_TU * s_res.tu_s;
+    s_res.kp = LT_AT_KP_KU * s_res.ku;
+    s_res.ki = s_res.kp / ti;
+    s_res.kd = s_res.kp * td;
+
+    s_state = LT_AT_DONE;
+}
+
+void lt_autotune_start(uint32_t now_us)
+{
+    memset(&s_res, 0, sizeof(s_res));
+    s_start_us = now_us;
+    s_out      = 0;
+    s_rises    = 0;
+    s_max      = INT32_MIN;
+    s_min      = INT32_MAX;
+    s_state    = LT_AT_RUNNING;
+    uart_printf("[AT] relay d=%d eps=%d\r\n", (int)LT_AT_RELAY, (int)LT_AT_HYST);
+}
+
+void lt_autotune_abort(void)
+{
+    if (s_state == LT_AT_RUNNING)
+        fail("aborted");
+}
+
+lt_at_state_t lt_autotune_state(void)
+{
+    return s_state;
+}
+
+int32_t lt_autotune_step(int32_t err, uint32_t now_us)
+{
+    if (s_state != LT_AT_RUNNING)
+        return 0;
+
+    if ((now_us - s_start_us) >= LT_AT_TIMEOUT_MS * 1000u)
+    {
+        fail("timeout");
+        return 0;
+    }
+
+    if (err > s_max) s_max = err;
+    if (err < s_min) s_min = err;
+
+    if (s_out == 0)
+    {
+        s_out = (err >= 0) ? LT_AT_RELAY : -LT_AT_RELAY;
+    }
+    else if (s_out < 0 && err > LT_AT_HYST)
+    {
+        s_out = LT_AT_RELAY;
+
+        // 상승 전환 사이 = 한 주기. 앞의 SKIP 주기는 과도 구간
+        if (s_rises > LT_AT_SKIP)
+        {
+            uint32_t i = s_rises - LT_AT_SKIP - 1u;
+            s_period_us[i] = now_us - s_last_rise_us;
+            s_amp[i]       = (s_max - s_min) / 2;
+            if (i + 1u == LT_AT_CYCLES)
+            {
+                finish();
+                return 0;
+            }
+        }
+        s_rises++;
+        s_last_rise_us = now_us;
+        s_max = err;
+        s_min = err;
+    }
+    else if (s_out > 0 && err < -LT_AT_HYST)
+    {
+        s_out = -LT_AT_RELAY;
+    }
+    return s_out;
+}
+
+bool lt_autotune_result(lt_at_result_t *out)
+{
+    if (s_state != LT_AT_DONE)
+        return false;
+    *out = s_res;
+    return true;
+}
+
+bool lt_autotune_save(const lt_at_result_t *res, uint16_t base_ticks)
+{
+    at_rec_t rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.base_ticks = base_ticks;
+    rec.kp = res->kp;  rec.ki = res->ki;  rec.kd = res->kd;
+    rec.ku = res->ku;  rec.tu_s = res->tu_s;
+
+    if (!kv_put(KV_KEY_LT_GAINS, &rec, sizeof(rec)))
+        return false;
+
+    uart_printf("[AT] saved (base=%u)\r\n", (unsigned)base_ticks);
+    return true;
+}
+
+bool lt_autotune_load(uint16_t base_ticks, float *kp, float *ki, float *kd)
+{
+    at_rec_t rec;
+    uint16_t len;
+
+    if (!kv_get(KV_KEY_LT_GAINS, &rec, sizeof(rec), &len) || len != sizeof(rec))
+        return false;
+    if (rec.base_ticks != base_ticks)
+        return false;                               // 다른 속도에서 측정
+
+    *kp = rec.kp;
+    *ki = rec.ki;
+    *kd = rec.kd;
+    return true;
+}
+
+#else
+
+void            lt_autotune_start(uint32_t now_us)      { (void)now_us; }
+void            lt_autotune_abort(void)                 { }
+lt_at_state_t   lt_autotune_state(void)                 { return LT_AT_IDLE; }
+int32_t         lt_autotune_step(int32_t err, uint32_t now_us) { (void)err; (void)now_us; return 0; }
+bool            lt_autotune_result(lt_at_result_t *out) { (void)out; return false; }
+bool            lt_autotune_save(const lt_at_result_t *res, uint16_t base_ticks)
+{
+    (void)res; (void)base_ticks;
+    return false;
+}
+bool            lt_autotune_load(uint16_t base_ticks, float *kp, float *ki, float *kd)
+{
+    (void)base_ticks; (void)kp; (void)ki; (void)kd;
+    return false;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * lt_autotune.h
+ *
+ *  라인트레이싱 PID 자동 튜닝 (Åström–Hägglund 릴레이 실험)
+ *
+ *  PID 대신 릴레이(±d, 히스테리시스 ε)로 조향하면 라인 위에서 한계 사이클이 생긴다.
+ *  진동 진폭 a, 주기 Tu를 재서
+ *      Ku = 4d / (π·√(a² - ε²))
+ *  로 임계 게인을 구하고 Ziegler–Nichols 규칙으로 PID 게인을 만든다.
+ *  - 처음 SKIP 주기는 버리고 CYCLES 주기를 평균, 주기 편차가 크면 실패
+ *  - 결과는 KV 저장소(KV_KEY_LT_GAINS)에 저장, 부팅 시 복원
+ *  - 게인은 속도에 따라 달라지므로 측정 당시 base_ticks와 같을 때만 복원
+ *  오차/조향비 단위는 line_tracing과 같다 (Q15, ±1).
+ */
+
+#ifndef MOTION_LT_AUTOTUNE_H_
+#define MOTION_LT_AUTOTUNE_H_
+
+
+#include "def.h"
+
+
+#ifndef _USE_LT_AUTOTUNE
+#define _USE_LT_AUTOTUNE        1
+#endif
+
+#define LT_AT_RELAY             ((int32_t)(0.30f * 32768))  // 릴레이 조향비 d
+#define LT_AT_HYST              ((int32_t)(0.04f * 32768))  // 히스테리시스 ε (센서 잡음 이상)
+#define LT_AT_SKIP              2U          // 과도 구간으로 버리는 주기 수
+#define LT_AT_CYCLES            4U          // 평균낼 주기 수
+#define LT_AT_PERIOD_TOL_PCT    25U         // 주기 편차 허용 (평균 대비 %)
+#define LT_AT_TIMEOUT_MS        15000U
+
+// Ziegler–Nichols PID: Kp = 0.6·Ku, Ti = Tu/2, Td = Tu/8
+#define LT_AT_KP_KU             0.6f
+#define LT_AT_TI_TU             0.5f
+#define LT_AT_TD_TU             0.125f
+
+
+typedef enum
+{
+    LT_AT_IDLE = 0,
+    LT_AT_RUNNING,
+    LT_AT_DONE,
+    LT_AT_FAILED
+} lt_at_state_t;
+
+typedef struct
+{
+    float    ku;
+    float    tu_s;
+    float    amp;           // 위치 진폭 (±1 스케일)
+    float    kp, ki, kd;
+} lt_at_result_t;
+
+
+// 실험 시작 (이후 제어 주기마다 lt_autotune_step)
+void            lt_autotune_start(uint32_t now_us);
+void            lt_autotune_abort(void);
+lt_at_state_t   lt_autotune_state(void);
+
+// 제어 주기마다: 오차(Q15) → 릴레이 조향비(Q15). 끝나면 상태가 DONE/FAILED
+int32_t         lt_autotune_step(int32_t err, uint32_t now_us);
+
+// DONE일 때 측정값/게인
+bool            lt_autotune_result(lt_at_result_t *out);
+
+// 플래시 저장/복원 (base_ticks = 측정 당시 속도)
+bool            lt_autotune_save(const lt_at_result_t *res, uint16_t base_ticks);
+bool            lt_autotune_load(uint16_t base_ticks, float *kp, float *ki, float *kd);
+
+
+#endif /* MOTION_LT_AUTOTUNE_H_ */
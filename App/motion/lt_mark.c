@@ -0,0 +1,106 @@
+/*
+ * lt_mark.c
+ *
+ *  라인트레이싱 중 트랙 색 마크 인식
+ */
+
+
+#include "lt_mark.h"
+
+
+#if (_USE_LT_MARK == 1)
+
+static uint8_t  s_act[COLOR_COUNT];
+static color_t  s_cand  = COLOR_UNKNOWN;
+static uint8_t  s_hits  = 0;
+static uint8_t  s_miss  = 0;
+static bool     s_armed = true;
+
+
+void lt_mark_init(void)
+{
+    memset(s_act, LT_MARK_NONE, sizeof(s_act));
+    s_act[COLOR_RED]    = LT_MARK_STOP;
+    s_act[COLOR_YELLOW] = LT_MARK_SLOW;
+    s_act[COLOR_BLUE]   = LT_MARK_TURN_LEFT;
+    s_act[COLOR_GREEN]  = LT_MARK_TURN_RIGHT;
+    lt_mark_reset();
+}
+
+void lt_mark_reset(void)
+{
+    s_cand  = COLOR_UNKNOWN;
+    s_hits  = 0;
+    s_miss  = 0;
+    s_armed = true;
+}
+
+void lt_mark_set_action(color_t c, lt_mark_act_t act)
+{
+    // 라인/바닥 색은 마크가 될 수 없다
+    if (c >= COLOR_COUNT || c == COLOR_BLACK || c == COLOR_WHITE || c == COLOR_GRAY)
+        return;
+    s_act[c] = (uint8_t)act;
+}
+
+lt_mark_act_t lt_mark_action(color_t c)
+{
+    return (c < COLOR_COUNT) ? (lt_mark_act_t)s_act[c] : LT_MARK_NONE;
+}
+
+color_t lt_mark_update(const color_result_t *left, const color_result_t *right, bool *on_mark)
+{
+    bool seen = left->cls < COLOR_COUNT && left->cls == right->cls &&
+                left->conf >= LT_MARK_MIN_CONF && right->conf >= LT_MARK_MIN_CONF &&
+                s_act[left->cls] != LT_MARK_NONE;
+
+    if (on_mark) *on_mark = seen;
+
+    if (!seen)
+    {
+        s_hits = 0;
+        if (!s_armed && ++s_miss >= LT_MARK_CLEAR)
+        {
+            s_armed = true;
+            s_cand  = COLOR_UNKNOWN;
+        }
+        return COLOR_UNKNOWN;
+    }
+
+    s_miss = 0;
+    if (left->cls != s_cand)
+    {
+        s_cand  = left->cls;
+        s_hits  = 0;
+        s_armed = true;             // 다른 색 마크가 바로 이어지면 새 마크
+    }
+    if (!s_armed || ++s_hits < LT_MARK_CONFIRM)
+        return COLOR_UNKNOWN;
+
+    s_armed = false;
+    return s_cand;
+}
+
+#else
+
+void            lt_mark_init(void)                              { }
+void            lt_mark_reset(void)                             { }
+void            lt_mark_set_action(color_t c, lt_mark_act_t act) { (void)c; (void)act; }
+lt_mark_act_t   lt_mark_action(color_t c)                       { (void)c; return LT_MARK_NONE; }
+color_t         lt_mark_update(const color_result_t *left, const color_result_t *right, bool *on_mark)
+{
+    (void)left; (void)right;
+    if (on_mark) *on_mark = false;
+    return COLOR_UNKNOWN;
+}
+
+#endif
+
+const char* lt_mark_act_name(lt_mark_act_t act)
+{
+    static const char *names[LT_MARK_ACT_COUNT] =
+    {
+        "NONE", "STOP", "SLOW", "TURN_LEFT", "TURN_RIGHT"
+    };
+    return (act < LT_MARK_ACT_COUNT) ? names[act] : "?";
+}
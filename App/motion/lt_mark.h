@@ -0,0 +1,55 @@
+/*
+ * lt_mark.h
+ *
+ *  라인트레이싱 중 트랙 색 마크 인식
+ *
+ *  새 변환마다 제어에서 이미 읽은 좌/우 샘플을 그대로 분류한다(추가 I2C 없음, LUT면 수 µs).
+ *  좌/우가 같은 색을 MIN_CONF 이상으로 CONFIRM 변환 연속 보면 마크 1회 확정,
+ *  CLEAR 변환 연속 안 보여야 다시 확정 가능 (한 패드에서 중복 동작 없음).
+ *  같은 프레임을 여러 번 넣으면 한 번의 오분류가 확정될 수 있으므로 변환당 한 번만 호출.
+ *  동작이 NONE인 색(BLACK/WHITE/GRAY 포함)은 마크로 보지 않는다.
+ */
+
+#ifndef MOTION_LT_MARK_H_
+#define MOTION_LT_MARK_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#ifndef _USE_LT_MARK
+#define _USE_LT_MARK            1
+#endif
+
+#define LT_MARK_MIN_CONF        6U
+#define LT_MARK_CONFIRM         2U          // 연속 변환 (35ms × 2)
+#define LT_MARK_CLEAR           3U          // 연속 변환
+
+
+typedef enum
+{
+    LT_MARK_NONE = 0,
+    LT_MARK_STOP,               // 정지 (GO로 재출발)
+    LT_MARK_SLOW,               // 일정 시간 base 속도 제한
+    LT_MARK_TURN_LEFT,          // 다음 교차로에서 좌회전
+    LT_MARK_TURN_RIGHT,         // 다음 교차로에서 우회전
+    LT_MARK_ACT_COUNT
+} lt_mark_act_t;
+
+
+// 기본 동작표: RED=STOP, YELLOW=SLOW, BLUE=TURN_LEFT, GREEN=TURN_RIGHT
+void            lt_mark_init(void);
+void            lt_mark_reset(void);
+
+void            lt_mark_set_action(color_t c, lt_mark_act_t act);
+lt_mark_act_t   lt_mark_action(color_t c);
+
+// 새 변환마다 좌/우 분류 결과 투입. 새 마크가 확정되면 그 색, 아니면 COLOR_UNKNOWN
+// *on_mark = 지금 양쪽이 마크 색 위 (밝기 기반 라인 위치가 무의미)
+color_t         lt_mark_update(const color_result_t *left, const color_result_t *right, bool *on_mark);
+
+const char*     lt_mark_act_name(lt_mark_act_t act);
+
+
+#endif /* MOTION_LT_MARK_H_ */
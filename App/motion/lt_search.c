@@ -0,0 +1,86 @@
+/*
+ * lt_search.c
+ *
+ *  라인 놓침 → 재탐색 패턴
+ */
+
+
+#include "lt_search.h"
+
+
+static lt_search_phase_t s_phase = LT_SEARCH_FAILED;
+static uint32_t s_phase_ms;
+static int8_t   s_dir;
+static int32_t  s_steer;
+static uint8_t  s_leg;              // 훑기 구간 번호
+static uint32_t s_leg_ms;
+
+
+static void enter(lt_search_phase_t ph, uint32_t now_ms)
+{
+    s_phase    = ph;
+    s_phase_ms = now_ms;
+    s_leg      = 0;
+    s_leg_ms   = now_ms;
+}
+
+void lt_search_start(uint32_t now_ms, int8_t dir, int32_t steer)
+{
+    s_dir   = (dir >= 0) ? 1 : -1;
+    s_steer = steer;
+    enter(LT_SEARCH_COAST, now_ms);
+}
+
+bool lt_search_step(uint32_t now_ms, lt_search_cmd_t *cmd)
+{
+    cmd->rotate = 0;
+    cmd->steer  = 0;
+
+    if (s_phase == LT_SEARCH_COAST)
+    {
+        if ((now_ms - s_phase_ms) < LT_SEARCH_COAST_MS)
+        {
+            cmd->steer = s_steer;
+            return true;
+        }
+        enter(LT_SEARCH_SWEEP, now_ms);
+    }
+
+    if (s_phase == LT_SEARCH_SWEEP)
+    {
+        // 구간 k: 방향 dir·(-1)^k, 길이 (2k+1)T → 끝점 +T, -2T, +3T, -4T …
+        uint32_t len = (2u * s_leg + 1u) * LT_SEARCH_SWEEP_MS;
+
+        if ((now_ms - s_leg_ms) >= len)
+        {
+            s_leg++;
+            s_leg_ms = now_ms;
+        }
+        if (s_leg < LT_SEARCH_SWEEPS)
+        {
+            cmd->rotate = (s_leg & 1u) ? (int8_t)-s_dir : s_dir;
+            return true;
+        }
+        enter(LT_SEARCH_SPIRAL, now_ms);
+    }
+
+    if (s_phase == LT_SEARCH_SPIRAL)
+    {
+        uint32_t t = now_ms - s_phase_ms;
+        if (t < LT_SEARCH_SPIRAL_MS)
+        {
+            int32_t s = LT_SEARCH_SPIRAL_S0 -
+                        (int32_t)(((int64_t)(LT_SEARCH_SPIRAL_S0 - LT_SEARCH_SPIRAL_S1) * t) / LT_SEARCH_SPIRAL_MS);
+            cmd->steer = s_dir * s;
+            return true;
+        }
+        enter(LT_SEARCH_FAILED, now_ms);
+    }
+
+    return false;
+}
+
+lt_search_phase_t lt_search_phase(void)
+{
+    return s_phase;
+}
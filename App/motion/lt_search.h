@@ -0,0 +1,52 @@
+/*
+ * lt_search.h
+ *
+ *  라인 놓침 → 재탐색 패턴 (시간 기반, 총 시간 제한)
+ *
+ *  1) COAST : 마지막 조향 그대로 잠깐 진행 (끊긴 라인/짧은 틈)
+ *  2) SWEEP : 마지막으로 라인이 있던 쪽부터 제자리 회전, 좌우로 T, 2T, 3T… 넓혀 가며 훑기
+ *  3) SPIRAL: 같은 쪽으로 조향을 점점 풀며 전진 (바깥으로 커지는 나선)
+ *  4) 실패  : 호출 측이 정지
+ *  엔코더가 없어 각도/거리는 회전/주행 시간으로 대신한다.
+ */
+
+#ifndef MOTION_LT_SEARCH_H_
+#define MOTION_LT_SEARCH_H_
+
+
+#include "def.h"
+
+
+#define LT_SEARCH_COAST_MS      150U
+#define LT_SEARCH_SWEEP_MS      250U        // 첫 훑기 반폭 T
+#define LT_SEARCH_SWEEPS        4U          // 훑기 구간 수 (T, 2T, 3T, 4T)
+#define LT_SEARCH_SPIRAL_MS     3000U
+#define LT_SEARCH_SPIRAL_S0     ((int32_t)(0.90f * 32768))  // 나선 시작 조향비
+#define LT_SEARCH_SPIRAL_S1     ((int32_t)(0.30f * 32768))  // 나선 끝 조향비
+
+
+typedef enum
+{
+    LT_SEARCH_COAST = 0,
+    LT_SEARCH_SWEEP,
+    LT_SEARCH_SPIRAL,
+    LT_SEARCH_FAILED
+} lt_search_phase_t;
+
+typedef struct
+{
+    int8_t  rotate;         // +1 = 제자리 좌회전, -1 = 제자리 우회전, 0 = 조향 주행
+    int32_t steer;          // rotate == 0일 때 조향비 (Q15, + = 왼쪽)
+} lt_search_cmd_t;
+
+
+// dir: 마지막으로 라인이 있던 쪽 (+1 = 왼쪽), steer: 놓치기 직전 조향비
+void                lt_search_start(uint32_t now_ms, int8_t dir, int32_t steer);
+
+// 매 제어 주기: 명령 출력. 탐색 한도를 다 쓰면 false (FAILED)
+bool                lt_search_step(uint32_t now_ms, lt_search_cmd_t *cmd);
+
+lt_search_phase_t   lt_search_phase(void);
+
+
+#endif /* MOTION_LT_SEARCH_H_ */
@@ -0,0 +1,97 @@
+/*
+ * pid.c
+ *
+ *  Q16 고정소수점 PID
+ */
+
+
+#include "pid.h"
+
+
+static inline int64_t clamp64(int64_t v, int64_t lo, int64_t hi)
+{
+    return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+void pid_init(pid_q16_t *pid, const pid_cfg_t *cfg)
+{
+    pid->cfg = *cfg;
+    pid_reset(pid, 0);
+}
+
+void pid_set_gains(pid_q16_t *pid, float kp, float ki, float kd)
+{
+    pid->cfg.kp = PID_Q16(kp);
+    pid->cfg.ki = PID_Q16(ki);
+    pid->cfg.kd = PID_Q16(kd);
+}
+
+void pid_set_limits(pid_q16_t *pid, int32_t out_min, int32_t out_max)
+{
+    pid->cfg.out_min = out_min;
+    pid->cfg.out_max = out_max;
+}
+
+void pid_reset(pid_q16_t *pid, int32_t out0)
+{
+    out0 = (int32_t)clamp64(out0, pid->cfg.out_min, pid->cfg.out_max);
+
+    pid->integ    = (int64_t)out0 << 16;
+    pid->d_filt   = 0;
+    pid->prev_err = 0;
+    pid->prev_us  = 0;
+    pid->primed   = false;
+    pid->sat      = false;
+    pid->out      = out0;
+}
+
+int32_t pid_update(pid_q16_t *pid, int32_t err, uint32_t now_us)
+{
+    const pid_cfg_t *c = &pid->cfg;
+
+    // ── dt ──
+    uint32_t dt = pid->primed ? (uint32_t)(now_us - pid->prev_us) : 0u;
+    if (dt > PID_DT_MAX_US)
+        dt = PID_DT_MAX_US;
+    if (pid->primed && dt == 0)
+        return pid->out;                    // 같은 시각 재호출
+
+    // ── P ──
+    int64_t p = (int64_t)c->kp * err;
+
+    // ── D (첫 샘플은 이력 없음 → 0) ──
+    if (pid->primed)
+    {
+        int64_t d_raw = ((int64_t)c->kd * (err - pid->prev_err) * 1000000) / (int64_t)dt;
+
+        if (c->d_tau_us == 0)
+            pid->d_filt = d_raw;
+        else    // α = dt / (τ + dt)
+            pid->d_filt += ((d_raw - pid->d_filt) * (int64_t)dt) / (int64_t)(c->d_tau_us + dt);
+    }
+
+    // ── I (포화 방향으로는 적분하지 않음) ──
+    int64_t di = ((int64_t)c->ki * err * (int64_t)dt) / 1000000;
+    bool    push_hi = (pid->out >= c->out_max) && (di > 0);
+    bool    push_lo = (pid->out <= c->out_min) && (di < 0);
+    if (!(pid->sat && (push_hi || push_lo)))
+        pid->integ += di;
+
+    const int64_t lo = (int64_t)c->out_min << 16;
+    const int64_t hi = (int64_t)c->out_max << 16;
+
+    int64_t u     = p + pid->integ + pid->d_filt;
+    int64_t u_sat = clamp64(u, lo, hi);
+
+    // back-calculation: 포화된 만큼 적분항을 되돌림 (Kaw·(u_sat - u)·dt)
+    if (u != u_sat && c->kaw != 0)
+        pid->integ += (((u_sat - u) >> 16) * c->kaw * (int64_t)dt) / 1000000;
+    pid->integ = clamp64(pid->integ, lo, hi);
+
+    pid->sat      = (u != u_sat);
+    pid->prev_err = err;
+    pid->prev_us  = now_us;
+    pid->primed   = true;
+    pid->out      = (int32_t)((u_sat + 0x8000) >> 16);
+    return pid->out;
+}
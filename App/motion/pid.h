@@ -0,0 +1,63 @@
+/*
+ * pid.h
+ *
+ *  Q16 고정소수점 PID (실측 dt, 안티와인드업, 미분 저역통과, 무충격 시작)
+ *
+ *  u = Kp·e + ∫Ki·e dt + LPF(Kd·de/dt)
+ *  - dt는 호출 시 넘겨준 µs 시각 차이로 계산 (주기 흔들림이 게인에 안 섞임)
+ *  - 안티와인드업: 포화 방향으로는 적분 정지(클램핑) + 포화량 되먹임(back-calculation)
+ *  - 미분은 1차 저역통과(시정수 d_tau_us), 첫 샘플은 미분 0 (시작 시 튐 방지)
+ *  - pid_reset(out0)으로 현재 출력에서 이어서 시작 (무충격)
+ *  오차/출력 단위는 호출 측이 정한다 (정수, 게인은 출력/오차 Q16).
+ */
+
+#ifndef MOTION_PID_H_
+#define MOTION_PID_H_
+
+
+#include "def.h"
+
+
+#define PID_Q16(x)          ((int32_t)((x) * 65536.0f))
+
+// 이보다 긴 간격(정지/중단 후)은 이 값으로 제한. 호출은 센서 변환마다라
+// 가장 긴 AE 단계(240 ms) + 지터보다 커야 한다 (작으면 적분/미분 dt가 줄어 게인이 틀어짐)
+#define PID_DT_MAX_US       300000U
+
+
+typedef struct
+{
+    int32_t  kp;            // Q16
+    int32_t  ki;            // Q16, 1/s
+    int32_t  kd;            // Q16, s
+    int32_t  kaw;           // Q16, 1/s  back-calculation 게인 (0 = 클램핑만)
+    int32_t  out_min;
+    int32_t  out_max;
+    uint32_t d_tau_us;      // 미분 LPF 시정수 (0 = 필터 없음)
+} pid_cfg_t;
+
+typedef struct
+{
+    pid_cfg_t cfg;
+    int64_t   integ;        // 적분항 (출력 단위 Q16)
+    int64_t   d_filt;       // 필터된 미분항 (출력 단위 Q16)
+    int32_t   prev_err;
+    uint32_t  prev_us;
+    bool      primed;       // 첫 샘플 이후 true
+    bool      sat;          // 직전 출력 포화 여부
+    int32_t   out;
+} pid_q16_t;
+
+
+void    pid_init(pid_q16_t *pid, const pid_cfg_t *cfg);
+void    pid_set_gains(pid_q16_t *pid, float kp, float ki, float kd);
+void    pid_set_limits(pid_q16_t *pid, int32_t out_min, int32_t out_max);
+
+// 다음 update가 out0에서 이어지게 (적분항에 out0을 싣고 미분 이력 지움)
+void    pid_reset(pid_q16_t *pid, int32_t out0);
+
+// 오차 1개 → 출력 (now_us = micros())
+int32_t pid_update(pid_q16_t *pid, int32_t err, uint32_t now_us);
+
+
+#endif /* MOTION_PID_H_ */
@@ -0,0 +1,99 @@
+/*
+ * speed_sched.c
+ *
+ *  라인트레이싱 곡률 기반 속도 스케줄러
+ */
+
+
+#include "speed_sched.h"
+
+
+static inline int32_t iabs32(int32_t v)
+{
+    return (v < 0) ? -v : v;
+}
+
+void speed_sched_init(speed_sched_t *s, const speed_sched_cfg_t *cfg)
+{
+    s->cfg     = *cfg;
+    s->v_limit = 0;
+    speed_sched_reset(s, cfg->v_min);
+}
+
+void speed_sched_reset(speed_sched_t *s, uint32_t v0)
+{
+    s->v_q8       = v0 << 8;
+    s->v_tgt      = v0;
+    s->steer_filt = 0;
+    s->prev_pos   = 0;
+    s->kappa      = 0;
+    s->primed     = false;
+}
+
+void speed_sched_set_limit(speed_sched_t *s, uint32_t v_limit)
+{
+    s->v_limit = v_limit;
+}
+
+void speed_sched_estimate(speed_sched_t *s, int32_t pos, int32_t steer, uint32_t dt_us)
+{
+    const speed_sched_cfg_t *c = &s->cfg;
+
+    if (dt_us == 0)
+        return;
+
+    // ── 곡률 추정 ──
+    int32_t a = iabs32(steer);
+    if (c->tau_us == 0)
+        s->steer_filt = a;
+    else
+        s->steer_filt += (int32_t)(((int64_t)(a - s->steer_filt) * dt_us) / (c->tau_us + dt_us));
+
+    int32_t pred = iabs32(pos);
+    if (s->primed)
+    {
+        // 선행 시간 뒤 예상 위치
+        int64_t p = pos + ((int64_t)(pos - s->prev_pos) * c->lookahead_us) / dt_us;
+        if (p >  SPEED_SCHED_ONE) p =  SPEED_SCHED_ONE;
+        if (p < -SPEED_SCHED_ONE) p = -SPEED_SCHED_ONE;
+        pred = iabs32((int32_t)p);
+    }
+    s->prev_pos = pos;
+    s->primed   = true;
+
+    int32_t k = (s->steer_filt > pred) ? s->steer_filt : pred;
+    s->kappa  = k;
+
+    // ── 목표 속도 ──
+    uint32_t span = (c->v_max > c->v_min) ? (c->v_max - c->v_min) : 0u;
+    uint32_t kf   = (c->k_full > 0 && k < c->k_full) ? (uint32_t)(((int64_t)k << 15) / c->k_full)
+                                                     : (uint32_t)SPEED_SCHED_ONE;
+    uint32_t v_tgt = c->v_max - (uint32_t)(((uint64_t)span * kf) >> 15);
+
+    // 바깥 바퀴 = v × (1 + |조향비|) ≤ wheel_max
+    uint32_t v_cap = (uint32_t)(((uint64_t)c->wheel_max << 15) / (uint32_t)(SPEED_SCHED_ONE + a));
+    s->v_tgt = (v_tgt > v_cap) ? v_cap : v_tgt;
+}
+
+uint32_t speed_sched_ramp(speed_sched_t *s, uint32_t dt_us)
+{
+    const speed_sched_cfg_t *c = &s->cfg;
+
+    uint32_t v_tgt = s->v_tgt;
+    if (s->v_limit && v_tgt > s->v_limit) v_tgt = s->v_limit;
+
+    // ── 가감속 한계 램프 (Q8) ──
+    uint32_t tgt_q8 = v_tgt << 8;
+    if (tgt_q8 > s->v_q8)
+    {
+        uint32_t step = (uint32_t)(((uint64_t)c->accel * dt_us << 8) / 1000000u);
+        s->v_q8 = (tgt_q8 - s->v_q8 > step) ? s->v_q8 + step : tgt_q8;
+    }
+    else
+    {
+        uint32_t step = (uint32_t)(((uint64_t)c->decel * dt_us << 8) / 1000000u);
+        s->v_q8 = (s->v_q8 - tgt_q8 > step) ? s->v_q8 - step : tgt_q8;
+    }
+
+    return s->v_q8 >> 8;
+}
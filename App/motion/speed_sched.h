@@ -0,0 +1,60 @@
+/*
+ * speed_sched.h
+ *
+ *  라인트레이싱 곡률 기반 속도 스케줄러
+ *
+ *  곡률 추정 κ = max( LPF|조향비|,  |위치 + 선행시간 × 위치변화율| )
+ *  - 정상 곡선에서 필요한 조향비는 곡률에 비례 → LPF|조향비|
+ *  - 위치가 빠르게 벌어지면 곧 급커브 → 선행 예측으로 미리 감속
+ *  목표 속도 v = v_max - (v_max - v_min) × min(1, κ / κ_full)
+ *  실제 속도는 가속/감속 한계로 램프 (스테퍼 탈조 방지, 감속은 더 빠르게 허용)
+ *  바깥 바퀴가 wheel_max를 넘지 않게 v ≤ wheel_max / (1 + |조향비|).
+ *  속도 단위: 스텝/s (마이크로스텝)
+ */
+
+#ifndef MOTION_SPEED_SCHED_H_
+#define MOTION_SPEED_SCHED_H_
+
+
+#include "def.h"
+
+
+#define SPEED_SCHED_ONE     (1 << 15)           // Q15 1.0
+
+
+typedef struct
+{
+    uint32_t v_min;         // 급커브 속도
+    uint32_t v_max;         // 직선 속도
+    uint32_t wheel_max;     // 한 바퀴 최고 속도
+    uint32_t accel;         // 스텝/s²
+    uint32_t decel;         // 스텝/s² (감속)
+    int32_t  k_full;        // Q15, 이 곡률 이상이면 v_min
+    uint32_t lookahead_us;  // 위치 변화율 선행 시간
+    uint32_t tau_us;        // |조향비| LPF 시정수
+} speed_sched_cfg_t;
+
+typedef struct
+{
+    speed_sched_cfg_t cfg;
+    uint32_t v_q8;          // 현재 속도 (스텝/s Q8)
+    uint32_t v_tgt;         // 마지막 추정 목표 속도
+    int32_t  steer_filt;    // Q15
+    int32_t  prev_pos;
+    int32_t  kappa;         // 마지막 곡률 추정 (Q15, 디버그)
+    uint32_t v_limit;       // 외부 속도 제한 (0 = 없음, 램프는 그대로 적용)
+    bool     primed;
+} speed_sched_t;
+
+
+void     speed_sched_init(speed_sched_t *s, const speed_sched_cfg_t *cfg);
+void     speed_sched_reset(speed_sched_t *s, uint32_t v0);
+void     speed_sched_set_limit(speed_sched_t *s, uint32_t v_limit);
+
+// 새 센서 변환마다: 위치/조향비(Q15, 부호 무관)와 변환 간 dt → 목표 속도 갱신
+void     speed_sched_estimate(speed_sched_t *s, int32_t pos, int32_t steer, uint32_t dt_us);
+// 구동 주기마다: 목표 속도로 dt만큼 램프 → 기준 속도(스텝/s)
+uint32_t speed_sched_ramp(speed_sched_t *s, uint32_t dt_us);
+
+
+#endif /* MOTION_SPEED_SCHED_H_ */
@@ -0,0 +1,90 @@
+/*
+ * lp_keep.c
+ *
+ *  Standby 동안 버튼/카드 프로그램 유지 (TAMP 백업 레지스터)
+ */
+
+
+#include "lp_keep.h"
+#include "btn_prog.h"
+#include "card_prog.h"
+#include "uart.h"
+
+
+#define KEEP_OPS_MAX        (BTN_PROG_MAX_LEN + CARD_PROG_MAX_LEN)
+#define KEEP_DATA_REGS      ((KEEP_OPS_MAX + 3U) / 4U)
+#define KEEP_REGS           (2U + KEEP_DATA_REGS)
+
+_Static_assert(LP_KEEP_BKP_FIRST + KEEP_REGS <= 32U, "not enough TAMP backup registers");
+
+
+static inline volatile uint32_t* bkp(uint32_t i)
+{
+    return &(&TAMP->BKP0R)[LP_KEEP_BKP_FIRST + i];
+}
+
+static void bkp_access(void)
+{
+    __HAL_RCC_RTCAPB_CLK_ENABLE();          // TAMP 레지스터 APB 클럭
+    HAL_PWR_EnableBkUpAccess();             // 백업 도메인 쓰기 허용
+}
+
+static uint32_t keep_sum(uint32_t head, const uint8_t *ops, uint32_t n)
+{
+    uint32_t h = 2166136261u;
+
+    for (int k = 0; k < 4; k++)
+        h = (h ^ ((head >> (8 * k)) & 0xFFu)) * 16777619u;
+    for (uint32_t i = 0; i < n; i++)
+        h = (h ^ ops[i]) * 16777619u;
+    return h;
+}
+
+void lp_keep_save(void)
+{
+    uint8_t ops[KEEP_DATA_REGS * 4U];
+
+    memset(ops, 0, sizeof(ops));
+    uint8_t nb = btn_prog_export(ops, BTN_PROG_MAX_LEN);
+    uint8_t nc = card_prog_export(ops + nb, CARD_PROG_MAX_LEN);
+
+    uint32_t head = ((uint32_t)LP_KEEP_MAGIC << 16) | ((uint32_t)nb << 8) | nc;
+
+    bkp_access();
+    *bkp(0) = 0;                            // 쓰는 도중 끊기면 무효
+    for (uint32_t i = 0; i < (nb + nc + 3u) / 4u; i++)
+    {
+        uint32_t w;
+        memcpy(&w, &ops[i * 4u], 4);
+        *bkp(2u + i) = w;
+    }
+    *bkp(1) = keep_sum(head, ops, nb + nc);
+    *bkp(0) = head;
+}
+
+bool lp_keep_restore(void)
+{
+    uint8_t ops[KEEP_DATA_REGS * 4U];
+
+    bkp_access();
+
+    uint32_t head = *bkp(0);
+    uint8_t  nb   = (uint8_t)(head >> 8);
+    uint8_t  nc   = (uint8_t)head;
+
+    if ((head >> 16) != LP_KEEP_MAGIC || nb > BTN_PROG_MAX_LEN || nc > CARD_PROG_MAX_LEN)
+        return false;                       // 전원 차단 후 첫 부팅 / 저장 안 됨
+
+    for (uint32_t i = 0; i < (nb + nc + 3u) / 4u; i++)
+    {
+        uint32_t w = *bkp(2u + i);
+        memcpy(&ops[i * 4u], &w, 4);
+    }
+    if (keep_sum(head, ops, nb + nc) != *bkp(1))
+        return false;
+
+    bool ok = btn_prog_import(ops, nb) && card_prog_import(ops + nb, nc);
+    if (ok && (nb || nc))
+        uart_printf("[KEEP] restored btn=%u card=%u\r\n", (unsigned)nb, (unsigned)nc);
+    return ok;
+}
@@ -0,0 +1,31 @@
+/*
+ * lp_keep.h
+ *
+ *  Standby 동안 버튼/카드 프로그램 유지 (TAMP 백업 레지스터)
+ *
+ *  백업 레지스터는 Standby/리셋에도 유지되고 백업 도메인 리셋(전원 차단, 탬퍼)에만 지워진다
+ *  → 플래시 쓰기 없이 Standby 진입 훅(ISR 문맥)에서 레지스터 쓰기만으로 저장.
+ *  - BKP[FIRST]   : magic(16) | 버튼 길이(8) | 카드 길이(8)
+ *  - BKP[FIRST+1] : FNV-1a 체크섬 (길이 + 동작 코드)
+ *  - 이후         : 동작 코드 1바이트씩 (버튼 → 카드), 레지스터당 4개
+ *  복원은 레지스터 27개 읽기 + 검사 → 수 µs.
+ */
+
+#ifndef POWER_LP_KEEP_H_
+#define POWER_LP_KEEP_H_
+
+
+#include "def.h"
+
+
+#define LP_KEEP_BKP_FIRST       0U          // 사용할 첫 백업 레지스터 번호
+#define LP_KEEP_MAGIC           0x504BU     // "KP"
+
+
+// Standby 진입 직전 (lp_stby_prepare_before에서). ISR에서 호출해도 됨
+void lp_keep_save(void);
+// ap_init에서 btn_prog_init/card_prog_init 뒤에. 복원했으면 true
+bool lp_keep_restore(void);
+
+
+#endif /* POWER_LP_KEEP_H_ */
@@ -152,7 +152,7 @@ static void wkup1_config_for_active_low(void)
 }
 
 
-void lp_stby_prepare_before(void)
+__weak void lp_stby_prepare_before(void)
 {
     // 사용자가 오버라이드:
     // - 모터/버저/LED OFF
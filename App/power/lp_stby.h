@@ -32,8 +32,8 @@ void lp_stby_force(void);          // 즉시 Standby 진입
 
 
 void lp_stby_boot_gate(void);
-// 사용자 훅(모터 정지/LED OFF/상태 저장 등). 필요 시 오버라이드.
-void lp_stby_prepare_before(void) __attribute__((weak));
+// 사용자 훅(모터 정지/LED OFF/상태 저장 등). 필요 시 오버라이드 (lp_stby.c의 기본 정의가 weak).
+void lp_stby_prepare_before(void);
 
 
 #endif /* POWER_LP_STBY_H_ */
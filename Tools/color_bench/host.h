@@ -0,0 +1,25 @@
+/*
+ * host.h
+ *
+ *  색 파이프라인 호스트 하네스 공용 정의
+ *
+ *  - I2C: _USE_I2C_EMUL=1 빌드의 i2c.c + i2c_emul.c (BH1749 레지스터 모델)
+ *  - 시간: 가상 시계 (delay_ms/host_advance_us로만 흐름), cycles()는 실제 ns
+ *  - 플래시: 0x08000000에 1 MB를 매핑해서 펌웨어가 절대 주소 그대로 읽고 쓴다
+ *  - 펌웨어: App/color 원본 소스를 그대로 링크 (color_bench.c 포함, _USE_COLOR_BENCH=1)
+ */
+
+#ifndef COLOR_BENCH_HOST_H_
+#define COLOR_BENCH_HOST_H_
+
+
+#include "def.h"
+
+
+bool  host_flash_init(void);            // 실패 = 주소 충돌
+void  host_advance_us(uint32_t us);
+
+char* host_read_file(const char *path); // NUL 종단 버퍼 (free 필요), 실패 NULL
+
+
+#endif /* COLOR_BENCH_HOST_H_ */
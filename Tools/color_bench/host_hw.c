@@ -0,0 +1,177 @@
+/*
+ * host_hw.c
+ *
+ *  펌웨어가 부르는 하드웨어 함수의 호스트 구현
+ *  (가상 시계, 플래시 영역, UART, LED, 사이클 카운터, 파일 읽기)
+ */
+
+
+#include "host.h"
+#include "utils.h"
+#include "uart.h"
+#include "led.h"
+#include "flash.h"
+
+#include <sys/mman.h>
+#include <time.h>
+
+
+#define HOST_FLASH_BASE     0x08000000UL
+#define HOST_FLASH_SIZE     0x00100000UL    // 1 MB (LUT 영역 끝까지)
+
+uint32_t SystemCoreClock = 1000000000UL;    // cycles() = ns
+
+static uint64_t s_now_us;
+static bool     s_led[LED_CH_COUNT];
+
+
+bool host_flash_init(void)
+{
+    // 펌웨어가 절대 주소로 플래시를 읽으므로 같은 주소에 매핑 (지운 상태 = 0xFF)
+    void *p = mmap((void*)HOST_FLASH_BASE, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p != (void*)HOST_FLASH_BASE)
+        return false;
+
+    memset(p, 0xFF, HOST_FLASH_SIZE);
+    return true;
+}
+
+void host_advance_us(uint32_t us)
+{
+    s_now_us += us;
+}
+
+/* ---------------- utils ---------------- */
+
+void delay_ms(uint32_t ms)
+{
+    s_now_us += (uint64_t)ms * 1000u;
+}
+
+uint32_t millis(void)
+{
+    return (uint32_t)(s_now_us / 1000u);
+}
+
+uint32_t micros(void)
+{
+    return (uint32_t)s_now_us;
+}
+
+void cycles_init(void)
+{
+}
+
+// 실제 경과 ns. clock_gettime 자체 비용(수십 ns)이 들어가므로 변형 간 상대 비교용
+uint32_t cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+/* ---------------- uart / led ---------------- */
+
+void uart_init(void)
+{
+}
+
+void uart_printf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+void led_write(led_ch_t ch, bool on)
+{
+    if (ch < LED_CH_COUNT)
+        s_led[ch] = on;
+}
+
+bool led_is_on(led_ch_t ch)
+{
+    return (ch < LED_CH_COUNT) && s_led[ch];
+}
+
+/* ---------------- flash ---------------- */
+
+static inline bool in_flash(uint32_t addr, uint32_t len)
+{
+    return addr >= HOST_FLASH_BASE && len <= HOST_FLASH_SIZE &&
+           addr - HOST_FLASH_BASE <= HOST_FLASH_SIZE - len;
+}
+
+bool flash_erase_pages(uint32_t addr, uint32_t nb_pages)
+{
+    uint32_t page = addr & ~(FLASH_PAGE_SIZE - 1u);
+    uint32_t len  = nb_pages * FLASH_PAGE_SIZE;
+
+    if (!in_flash(page, len))
+        return false;
+
+    memset((void*)(uintptr_t)page, 0xFF, len);
+    return true;
+}
+
+bool flash_program(uint32_t addr, const void *src, uint32_t len)
+{
+    if ((addr & 7u) != 0 || (len & 7u) != 0 || !in_flash(addr, len))
+        return false;
+
+    // 실제 플래시처럼 지워지지 않은 더블워드는 쓰기 실패
+    const uint8_t *dst = (const uint8_t*)(uintptr_t)addr;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (dst[i] != 0xFF)
+            return false;
+    }
+
+    memcpy((void*)(uintptr_t)addr, src, len);
+    return true;
+}
+
+// zlib crc32()와 같은 값 (반사 다항식 0xEDB88320, 비트 단위)
+uint32_t flash_crc32(uint32_t crc, const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t*)data;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+/* ---------------- file ---------------- */
+
+char* host_read_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return NULL;
+
+    char  *buf = NULL;
+    size_t len = 0, cap = 0, n;
+    do
+    {
+        if (len + 4096u + 1u > cap)
+        {
+            cap = cap ? cap * 2u : 8192u;
+            char *nb = realloc(buf, cap);
+            if (nb == NULL) { free(buf); fclose(f); return NULL; }
+            buf = nb;
+        }
+        n = fread(buf + len, 1, cap - len - 1u, f);
+        len += n;
+    } while (n > 0);
+
+    fclose(f);
+    buf[len] = '\0';
+    return buf;
+}
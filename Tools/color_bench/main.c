@@ -0,0 +1,186 @@
+/*
+ * main.c
+ *
+ *  color_bench 호스트 하네스
+ *   -r trace.csv : I2C 에뮬레이터 CSV 리플레이 → 실제 색 파이프라인으로 분류, 바뀔 때마다 출력
+ *   -b samples.csv [-t train.csv] [-R refs.csv] : 라벨 샘플로 분류기 변형별 정확도/속도 비교 (color_bench.c)
+ *      -t: 학습 CSV로 reference/통계/LUT 생성 (없으면 mahal/lut 생략)
+ *   -s n : color_cls_selftest (정수 최근접 == 64비트 기준/float 구현), 불일치가 있으면 exit 1
+ */
+
+
+#include "host.h"
+#include "i2c.h"
+#include "i2c_emul.h"
+#include "color.h"
+#include "color_bench.h"
+#include "color_cls.h"
+#include "color_health.h"
+#include "color_strobe.h"
+#include "flash_kv.h"
+
+
+#define HOST_TICK_US        1000U       // 메인 루프 1회 = 1 ms (ap_main 주기와 비슷하게)
+
+
+typedef struct
+{
+    const char *replay;
+    const char *samples;
+    const char *train;
+    const char *refs;
+    uint32_t    selftest_n;
+    bool        verbose;
+} host_opt_t;
+
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: color_bench -r trace.csv [-v]\n"
+                    "       color_bench -b samples.csv [-t train.csv] [-R refs.csv]\n"
+                    "       color_bench -s n\n"
+                    "  trace.csv:   t_ms,side,r,g,b,ir  (side = L/R, x1 gain / 35 ms counts)\n"
+                    "  samples.csv: side,r,g,b,ir,true_color  (bh1749_read() scale, train.csv 동일)\n"
+                    "  refs.csv:    side,color,r,g,b,ir\n");
+    exit(2);
+}
+
+// ap_init과 같은 순서 (색 관련만)
+static void fw_boot(void)
+{
+    i2c_init();
+    color_init();
+    kv_init();
+    load_color_reference_table();
+    calculate_color_brightness_offset();
+}
+
+static int run_replay(const host_opt_t *o)
+{
+    char *text = host_read_file(o->replay);
+    if (text == NULL)
+    {
+        fprintf(stderr, "cannot read '%s'\n", o->replay);
+        return 2;
+    }
+
+    // i2c_init()이 트레이스를 비우므로 부팅 후에 로드
+    fw_boot();
+    uint16_t rows = i2c_emul_load_csv(text);
+    free(text);
+    if (rows == 0)
+    {
+        fprintf(stderr, "'%s': no trace rows\n", o->replay);
+        return 2;
+    }
+    printf("replay %s: %u rows\n", o->replay, rows);
+
+    const uint8_t addrs[2] = { BH1749_ADDR_LEFT, BH1749_ADDR_RIGHT };
+    color_t       prev[2]  = { COLOR_COUNT + 1, COLOR_COUNT + 1 };
+    uint32_t      changes  = 0, unknown_ms[2] = { 0, 0 };
+
+    i2c_emul_replay_start(false);
+    while (!i2c_emul_replay_done())
+    {
+        host_advance_us(HOST_TICK_US);
+        color_health_service();
+        color_strobe_service();
+
+        for (int s = 0; s < 2; s++)
+        {
+            color_result_t r = classify_color_side_ex(addrs[s]);
+            if (r.cls == COLOR_UNKNOWN)
+                unknown_ms[s]++;
+            if (r.cls == prev[s] && !o->verbose)
+                continue;
+
+            printf("%7lu ms  %c %-11s conf:%2u margin:%u\n", (unsigned long)millis(),
+                   s ? 'R' : 'L', color_to_string(r.cls), (unsigned)r.conf, (unsigned)r.margin);
+            if (r.cls != prev[s])
+                changes++;
+            prev[s] = r.cls;
+        }
+    }
+
+    debug_print_color_bus_stats();
+    printf("RESULT replay %lu ms: %lu changes, conversions L:%lu R:%lu, unknown L:%lu R:%lu ms\n",
+           (unsigned long)millis(), (unsigned long)changes,
+           (unsigned long)i2c_emul_conversions(BH1749_ADDR_LEFT),
+           (unsigned long)i2c_emul_conversions(BH1749_ADDR_RIGHT),
+           (unsigned long)unknown_ms[0], (unsigned long)unknown_ms[1]);
+    return 0;
+}
+
+static int run_bench(const host_opt_t *o)
+{
+    char *samples = host_read_file(o->samples);
+    char *train   = o->train ? host_read_file(o->train) : NULL;
+    char *refs    = o->refs ? host_read_file(o->refs) : NULL;
+    if (samples == NULL || (o->train && train == NULL) || (o->refs && refs == NULL))
+    {
+        fprintf(stderr, "cannot read '%s'\n", samples == NULL ? o->samples : (o->train && train == NULL) ? o->train : o->refs);
+        free(samples);
+        free(train);
+        free(refs);
+        return 2;
+    }
+
+    fw_boot();
+    if (refs)
+        printf("[BENCH] refs %s: %u rows\n", o->refs, color_bench_load_refs_csv(refs));
+    // 학습은 refs 뒤에: 학습된 클래스 reference가 refs를 덮어쓴다 (캘리와 같음)
+    if (train)
+        printf("[BENCH] train %s: %u rows\n", o->train, color_bench_train_csv(train));
+    uint16_t n = color_bench_load_csv(samples);
+    printf("[BENCH] samples %s: %u\n", o->samples, n);
+    free(samples);
+    free(train);
+    free(refs);
+
+    if (n == 0)
+        return 2;
+    color_bench_run();
+    return 0;
+}
+
+static int run_selftest(const host_opt_t *o)
+{
+    fw_boot();
+    uint32_t mism = color_cls_selftest(o->selftest_n);
+    printf("RESULT selftest n=%lu: %lu mismatches\n", (unsigned long)o->selftest_n, (unsigned long)mism);
+    return mism ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    host_opt_t o = { 0 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "-v") == 0)            { o.verbose = true; continue; }
+        if (v == NULL)                       usage();
+
+        if      (strcmp(a, "-r") == 0)       o.replay = v;
+        else if (strcmp(a, "-b") == 0)       o.samples = v;
+        else if (strcmp(a, "-t") == 0)       o.train = v;
+        else if (strcmp(a, "-R") == 0)       o.refs = v;
+        else if (strcmp(a, "-s") == 0)       o.selftest_n = (uint32_t)strtoul(v, NULL, 0);
+        else                                 usage();
+        i++;
+    }
+    if ((o.replay != NULL) + (o.samples != NULL) + (o.selftest_n != 0) != 1)
+        usage();
+
+    if (!host_flash_init())
+    {
+        fprintf(stderr, "cannot map flash at 0x08000000\n");
+        return 2;
+    }
+
+    if (o.selftest_n)
+        return run_selftest(&o);
+    return o.replay ? run_replay(&o) : run_bench(&o);
+}
@@ -0,0 +1,36 @@
+/*
+ * main.h (color_bench 호스트 빌드용)
+ *
+ *  Core/Inc/main.h 대신 들어가서 펌웨어 헤더가 쓰는 HAL 타입만 흉내낸다.
+ *  I2C는 _USE_I2C_EMUL 모델, 플래시/시간/UART는 host_hw.c가 대신한다.
+ */
+
+#ifndef COLOR_BENCH_STUB_MAIN_H_
+#define COLOR_BENCH_STUB_MAIN_H_
+
+
+#include <stdint.h>
+
+
+typedef struct { volatile uint32_t BSRR; } GPIO_TypeDef;
+typedef struct { uint32_t _rsv; } I2C_HandleTypeDef;
+typedef struct { uint32_t _rsv; } TIM_HandleTypeDef;
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+#define FLASH_PAGE_SIZE     0x1000U
+
+extern uint32_t SystemCoreClock;    // host_hw.c: cycles()가 ns라서 1 GHz
+
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void)  { }
+static inline void __NOP(void)         { }
+
+
+#endif /* COLOR_BENCH_STUB_MAIN_H_ */
@@ -0,0 +1,271 @@
+/*
+ * line_sim.c
+ *
+ *  라인트레이싱 폐루프 호스트 시뮬레이터 + 랩타임 벤치마크
+ *
+ *  빌드/실행 (Linux, gcc):
+ *      make -C Tools/line_sim
+ *      Tools/line_sim/build/line_sim -t rrect -l 3
+ *
+ *  옵션:
+ *      -t oval|rrect|wave      트랙 (기본 oval)
+ *      -l N                    랩 수 (기본 3)
+ *      -T sec                  제한 시간 (기본 600)
+ *      -s seed                 센서 잡음 시드
+ *      -m COLOR:s_mm           색 패드 추가 (예: -m YELLOW:600), 여러 번 가능
+ *      -kp/-ki/-kd x           게인 (기본 LT_DEFAULT_*)
+ *      -a                      먼저 릴레이 자동 튜닝 (lt_autotune), 얻은 게인으로 랩 측정
+ *      -base/-fast/-min/-max n period tick (fast 0 = 속도 스케줄 끔)
+ *      -max-lap ms, -max-rms mm   넘으면 종료코드 1 (회귀 테스트용)
+ *      -v                      펌웨어 UART 로그 출력
+ *
+ *  마지막 줄 "RESULT,..."는 스크립트 비교용 CSV.
+ */
+
+
+#include "sim.h"
+#include "line_tracing.h"
+
+#include <math.h>
+
+
+typedef struct
+{
+    const char *track;
+    int         laps;
+    double      timeout_s;
+    uint32_t    seed;
+    bool        verbose;
+    bool        autotune;
+    double      max_lap_ms;
+    double      max_rms_mm;
+    lt_config_t cfg;
+} sim_opt_t;
+
+#define MAX_LAPS        32
+#define AUTOTUNE_MAX_MS 60000U
+
+
+static color_t color_from_name(const char *s, size_t n)
+{
+    for (int c = 0; c < COLOR_COUNT; c++)
+    {
+        const char *name = color_to_string((color_t)c);
+        if (strlen(name) == n && strncasecmp(name, s, n) == 0)
+            return (color_t)c;
+    }
+    return COLOR_COUNT;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: line_sim [-t oval|rrect|wave] [-l laps] [-T sec] [-s seed] [-m COLOR:s_mm]...\n"
+                    "                [-kp x] [-ki x] [-kd x] [-base n] [-fast n] [-min n] [-max n]\n"
+                    "                [-a] [-max-lap ms] [-max-rms mm] [-v]\n");
+    exit(2);
+}
+
+// 1 ms: 10µs 스텝 ISR 100회 (메인 루프는 틱 사이마다) + 1ms 제어 틱
+static void run_1ms(sim_pose_t *pose)
+{
+    for (int k = 0; k < 100; k++)
+    {
+        sim_hw_tick_10us(pose);
+        line_tracing_service();
+    }
+    line_tracing_tick_1ms();
+}
+
+int main(int argc, char **argv)
+{
+    sim_opt_t o =
+    {
+        .track = "oval", .laps = 3, .timeout_s = 600.0, .seed = 1,
+        .cfg =
+        {
+            .Kp = LT_DEFAULT_KP, .Ki = LT_DEFAULT_KI, .Kd = LT_DEFAULT_KD,
+            .base_ticks = LT_DEFAULT_BASE_TICKS, .fast_ticks = LT_DEFAULT_FAST_TICKS,
+            .min_ticks = LT_DEFAULT_MIN_TICKS, .max_ticks = LT_DEFAULT_MAX_TICKS,
+            .interval_ms = LT_DEFAULT_INTERVAL_MS,
+        },
+    };
+    const char *marks[16];
+    int         n_marks = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "-v") == 0)            { o.verbose = true; continue; }
+        if (strcmp(a, "-a") == 0)            { o.autotune = true; continue; }
+        if (v == NULL)                       usage();
+
+        if      (strcmp(a, "-t") == 0)       o.track = v;
+        else if (strcmp(a, "-l") == 0)       o.laps = atoi(v);
+        else if (strcmp(a, "-T") == 0)       o.timeout_s = atof(v);
+        else if (strcmp(a, "-s") == 0)       o.seed = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "-m") == 0)       { if (n_marks < 16) marks[n_marks++] = v; }
+        else if (strcmp(a, "-kp") == 0)      o.cfg.Kp = (float)atof(v);
+        else if (strcmp(a, "-ki") == 0)      o.cfg.Ki = (float)atof(v);
+        else if (strcmp(a, "-kd") == 0)      o.cfg.Kd = (float)atof(v);
+        else if (strcmp(a, "-base") == 0)    o.cfg.base_ticks = (uint16_t)atoi(v);
+        else if (strcmp(a, "-fast") == 0)    o.cfg.fast_ticks = (uint16_t)atoi(v);
+        else if (strcmp(a, "-min") == 0)     o.cfg.min_ticks = (uint16_t)atoi(v);
+        else if (strcmp(a, "-max") == 0)     o.cfg.max_ticks = (uint16_t)atoi(v);
+        else if (strcmp(a, "-max-lap") == 0) o.max_lap_ms = atof(v);
+        else if (strcmp(a, "-max-rms") == 0) o.max_rms_mm = atof(v);
+        else                                 usage();
+        i++;
+    }
+    if (o.laps < 1 || o.laps > MAX_LAPS)
+        usage();
+
+    sim_track_t trk;
+    if (!sim_track_build(&trk, o.track))
+    {
+        fprintf(stderr, "unknown track '%s'\n", o.track);
+        return 2;
+    }
+    for (int i = 0; i < n_marks; i++)
+    {
+        const char *colon = strchr(marks[i], ':');
+        color_t     c = colon ? color_from_name(marks[i], (size_t)(colon - marks[i])) : COLOR_COUNT;
+        if (c == COLOR_COUNT)
+            usage();
+        sim_track_add_mark(&trk, atof(colon + 1), c);
+    }
+
+    printf("track %s: %.0f mm, line %.0f mm | wheel %.0f mm, %d steps/rev x %.0f:1 -> %.4f mm/step\n",
+           o.track, trk.length, SIM_LINE_W_MM, SIM_WHEEL_D_MM, STEP_PER_REV, SIM_GEAR_RATIO, SIM_MM_PER_STEP);
+
+    // ── 펌웨어 기동 (ap_init/ap_main과 같은 순서) ──
+    sim_hw_init(&trk, o.seed, o.verbose);
+    sim_pose_t pose = sim_track_start_pose(&trk);
+    for (int i = 0; i < 4000; i++)
+        sim_hw_tick_10us(&pose);            // 첫 센서 변환 완료까지
+
+    line_tracing_init(&o.cfg);
+    line_tracing_enable(true);
+    if (!line_tracing_enabled())
+    {
+        fprintf(stderr, "line tracing refused to start\n");
+        return 2;
+    }
+
+    // ── 자동 튜닝 (성공하면 게인 적용 + KV 저장 후 PID로 계속 주행) ──
+    if (o.autotune)
+    {
+        uint32_t ms = 0;
+
+        line_tracing_autotune();
+        while (line_tracing_tuning() && ms++ < AUTOTUNE_MAX_MS)
+            run_1ms(&pose);
+
+        if (line_tracing_tuning() || !line_tracing_enabled())
+        {
+            printf("autotune failed after %lu ms\n", (unsigned long)ms);
+            printf("RESULT,%s,0,0,0,0,0,0,fail\n", o.track);
+            sim_track_free(&trk);
+            return 1;
+        }
+        printf("autotune %lu ms\n", (unsigned long)ms);
+    }
+
+    // ── 실행: 10µs 스텝 ISR, 1ms 제어 틱, 메인 루프는 틱 사이마다 ──
+    uint32_t t0_us     = sim_hw_now_us();
+    uint32_t limit_ms  = (uint32_t)(o.timeout_s * 1000.0);
+    double   lap_ms[MAX_LAPS];
+    int      laps_done = 0;
+    double   lap_start = 0.0;
+    double   progress  = 0.0, s_prev;
+    double   xte, sq_sum = 0.0, xte_max = 0.0;
+    uint64_t samples   = 0;
+    int      losses    = 0;
+    bool     lost      = false;
+    int      hint;
+    const char *status = "ok";
+
+    sim_pt_t sl, sr;
+    sim_sensor_points(&pose, &sl, &sr);
+    hint = sim_track_nearest(&trk, (sl.x + sr.x) / 2, (sl.y + sr.y) / 2, -1, &xte, &s_prev);
+
+    const double lost_off = SIM_LINE_W_MM / 2 + SIM_SENSOR_GAP_MM / 2 + SIM_SENSOR_R_MM;
+
+    for (uint32_t ms = 0; ms < limit_ms; ms++)
+    {
+        run_1ms(&pose);
+
+        // 센서 중간점 기준 횡오차/진행거리
+        double s;
+        sim_sensor_points(&pose, &sl, &sr);
+        hint = sim_track_nearest(&trk, (sl.x + sr.x) / 2, (sl.y + sr.y) / 2, hint, &xte, &s);
+
+        double ds = s - s_prev;
+        if (ds < -trk.length / 2) ds += trk.length;
+        if (ds >  trk.length / 2) ds -= trk.length;
+        progress += ds;
+        s_prev    = s;
+
+        sq_sum += xte * xte;
+        samples++;
+        if (fabs(xte) > xte_max)
+            xte_max = fabs(xte);
+
+        // 두 센서 모두 라인 밖 = 놓침 1회 (라인 안으로 돌아오면 재무장)
+        if (!lost && fabs(xte) > lost_off)
+        {
+            lost = true;
+            losses++;
+        }
+        else if (lost && fabs(xte) < SIM_LINE_W_MM / 2)
+        {
+            lost = false;
+        }
+
+        double now_ms = (sim_hw_now_us() - t0_us) / 1000.0;
+        if (progress >= (laps_done + 1) * trk.length)
+        {
+            lap_ms[laps_done] = now_ms - lap_start;
+            lap_start         = now_ms;
+            printf("lap %d: %.0f ms\n", laps_done + 1, lap_ms[laps_done]);
+            if (++laps_done >= o.laps)
+                break;
+        }
+
+        if (!line_tracing_enabled())
+        {
+            status = "stopped";
+            break;
+        }
+    }
+    if (laps_done < o.laps && strcmp(status, "ok") == 0)
+        status = "timeout";
+
+    // ── 결과 ──
+    double best = 0, sum = 0;
+    for (int i = 0; i < laps_done; i++)
+    {
+        sum += lap_ms[i];
+        if (best == 0 || lap_ms[i] < best)
+            best = lap_ms[i];
+    }
+    double mean = laps_done ? sum / laps_done : 0;
+    double rms  = samples ? sqrt(sq_sum / samples) : 0;
+
+    const lt_stats_t *st = line_tracing_stats();
+    printf("laps %d/%d (%s) | lap mean %.0f ms best %.0f ms | xte rms %.2f mm max %.2f mm | losses %d\n",
+           laps_done, o.laps, status, mean, best, rms, xte_max, losses);
+    printf("control runs %lu missed %lu\n", (unsigned long)st->runs, (unsigned long)st->missed);
+
+    bool pass = (laps_done == o.laps) &&
+                (o.max_lap_ms <= 0 || mean <= o.max_lap_ms) &&
+                (o.max_rms_mm <= 0 || rms  <= o.max_rms_mm);
+
+    printf("RESULT,%s,%d,%.0f,%.0f,%.3f,%.3f,%d,%s\n",
+           o.track, laps_done, mean, best, rms, xte_max, losses, pass ? "pass" : "fail");
+
+    line_tracing_enable(false);
+    sim_track_free(&trk);
+    return pass ? 0 : 1;
+}
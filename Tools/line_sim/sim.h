@@ -0,0 +1,97 @@
+/*
+ * sim.h
+ *
+ *  라인트레이싱 호스트 시뮬레이터 공용 정의
+ *
+ *  - 트랙: 중심선 폴리라인 → 비트맵(SIM_PX_MM 해상도)으로 래스터화, 색 패드 추가 가능
+ *  - 로봇: 차동 구동. 스테퍼 1 마이크로스텝 = 바퀴 둘레 / (STEP_PER_REV × 기어비)
+ *  - 센서: 발자국(원) 안 비트맵 평균 → 팔레트 RGB/IR 혼합 + 잡음, BH1749 변환 주기마다 갱신
+ *  - 펌웨어: line_tracing/line_pos/pid/speed_sched/lt_*와 색 분류기(color_cls) 원본 소스를 그대로 링크,
+ *    1ms ISR(line_tracing_tick_1ms)과 10µs 스텝 ISR을 실제 주기대로 흉내낸다.
+ */
+
+#ifndef LINE_SIM_SIM_H_
+#define LINE_SIM_SIM_H_
+
+
+#include "def.h"
+#include "color.h"
+#include "stepper.h"
+
+
+// ===== 로봇 기하 (실측값으로 맞출 것) =====
+#define SIM_WHEEL_D_MM          32.0        // 바퀴 지름
+#define SIM_TRACK_W_MM          80.0        // 좌/우 바퀴 간격
+#define SIM_SENSOR_FWD_MM       40.0        // 바퀴축 → 센서 앞쪽 거리
+#define SIM_SENSOR_GAP_MM       18.0        // 좌/우 센서 중심 간격 (라인 양 가장자리에 걸침)
+#define SIM_SENSOR_R_MM         3.0         // 센서 발자국 반지름
+#define SIM_SENSOR_MEAS_US      35000U      // BH1749 변환 주기 (MEAS_35MS)
+#define SIM_SENSOR_NOISE        0.01        // 채널별 가우시안 잡음 (비율)
+
+#if (_USE_STEP_NUM == _STEP_NUM_729)
+#define SIM_GEAR_RATIO          20.0
+#elif (_USE_STEP_NUM == _STEP_NUM_728)
+#define SIM_GEAR_RATIO          10.0
+#else
+#define SIM_GEAR_RATIO          1.0
+#endif
+
+#define SIM_MM_PER_STEP         (3.14159265358979 * SIM_WHEEL_D_MM / (STEP_PER_REV * SIM_GEAR_RATIO))
+
+// ===== 트랙 =====
+#define SIM_PX_MM               0.5         // 비트맵 1픽셀 = 0.5mm
+#define SIM_LINE_W_MM           18.0        // 라인 폭
+
+// 비트맵 픽셀 값: 바닥/라인/색 패드 (팔레트 인덱스)
+enum
+{
+    SIM_PX_WHITE = 0,
+    SIM_PX_BLACK,
+    SIM_PX_MARK0                            // SIM_PX_MARK0 + color_t
+};
+
+typedef struct
+{
+    double x, y;
+} sim_pt_t;
+
+typedef struct
+{
+    // 중심선 (닫힌 폴리라인, 약 2mm 간격)
+    sim_pt_t *pts;
+    double   *s;            // 누적 길이
+    int       n;
+    double    length;
+
+    // 비트맵
+    uint8_t  *px;
+    int       w, h;
+    double    x0, y0;       // 비트맵 (0,0) 픽셀의 월드 좌표
+} sim_track_t;
+
+typedef struct
+{
+    double x, y, th;        // 바퀴축 중심, 진행 방향 (rad, 반시계 +)
+} sim_pose_t;
+
+
+// ----- sim_track.c -----
+bool        sim_track_build(sim_track_t *t, const char *name);
+void        sim_track_free(sim_track_t *t);
+void        sim_track_add_mark(sim_track_t *t, double s_mm, color_t c);
+uint8_t     sim_track_px(const sim_track_t *t, double x, double y);
+sim_pose_t  sim_track_start_pose(const sim_track_t *t);
+
+// 점 → 중심선 최근접 (hint 주변부터 탐색). 부호 있는 거리(+ = 진행 방향 왼쪽)와 누적 길이
+int         sim_track_nearest(const sim_track_t *t, double x, double y, int hint,
+                              double *xte, double *s);
+
+// ----- sim_hw.c -----
+void        sim_hw_init(const sim_track_t *t, uint32_t seed, bool verbose);
+void        sim_hw_tick_10us(sim_pose_t *pose);     // 10µs: 스텝 ISR + 센서 변환 + 자세 적분
+uint32_t    sim_hw_now_us(void);
+bool        sim_hw_moving(void);
+void        sim_sensor_points(const sim_pose_t *p, sim_pt_t *left, sim_pt_t *right);
+
+
+#endif /* LINE_SIM_SIM_H_ */
@@ -0,0 +1,389 @@
+/*
+ * sim_hw.c
+ *
+ *  펌웨어가 부르는 하드웨어 함수의 시뮬레이션 구현
+ *  (시간, UART, 스테퍼, BH1749, 색 모델, 센서 상태, KV)
+ *  색 분류 자체는 펌웨어 color_cls.c(color_cls_search)를 그대로 쓴다.
+ */
+
+
+#include "sim.h"
+#include "uart.h"
+#include "color_cls.h"
+#include "color_stats.h"
+#include "color_health.h"
+#include "flash_kv.h"
+
+#include <math.h>
+
+
+// 좌/우 감도 차 (정규화가 흡수하는지 확인용)
+static const double k_side_gain[2] = { 1.00, 0.92 };
+
+// 팔레트: 각 색 위의 raw R/G/B/IR (gain x1, 35ms 기준)
+static const uint16_t k_palette[COLOR_COUNT][4] =
+{
+    [COLOR_RED]         = {  820,  210,  190, 300 },
+    [COLOR_ORANGE]      = {  900,  420,  200, 300 },
+    [COLOR_YELLOW]      = {  980,  900,  260, 300 },
+    [COLOR_GREEN]       = {  260,  560,  300, 250 },
+    [COLOR_BLUE]        = {  200,  330,  700, 250 },
+    [COLOR_PURPLE]      = {  420,  260,  520, 260 },
+    [COLOR_LIGHT_GREEN] = {  600,  900,  420, 280 },
+    [COLOR_SKY_BLUE]    = {  420,  760,  900, 280 },
+    [COLOR_PINK]        = {  950,  520,  640, 300 },
+    [COLOR_BLACK]       = {   70,   80,   65,  60 },
+    [COLOR_WHITE]       = { 1100, 1250, 1000, 320 },
+    [COLOR_GRAY]        = {  450,  500,  420, 180 },
+};
+
+static const char *k_names[COLOR_COUNT] =
+{
+    "RED", "ORANGE", "YELLOW", "GREEN", "BLUE", "PURPLE",
+    "LIGHT_GREEN", "SKY_BLUE", "PINK", "BLACK", "WHITE", "GRAY"
+};
+
+typedef struct
+{
+    uint32_t period;
+    uint32_t prev_tick;
+    int8_t   dir;           // 논리 방향 (+1 = 전진)
+} wheel_t;
+
+static const sim_track_t *s_trk;
+static bool     s_verbose;
+static uint32_t s_now_us;
+static uint64_t s_rng;
+
+static wheel_t  s_wheel[2];
+static bool     s_run;
+
+static reference_entry_t    s_ref[2][COLOR_COUNT];
+static color_soa_t          s_model[2];
+static color_chroma_soa_t   s_chroma[2];
+static bh1749_color_data_t  s_meas[2];
+static uint32_t             s_meas_us[2];
+static uint32_t             s_meas_seq[2];
+
+
+static inline int side_idx(uint8_t addr)
+{
+    return (addr == BH1749_ADDR_LEFT) ? 0 : 1;
+}
+
+static double rng_u01(void)
+{
+    // xorshift64*
+    s_rng ^= s_rng >> 12;
+    s_rng ^= s_rng << 25;
+    s_rng ^= s_rng >> 27;
+    return (double)((s_rng * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double rng_gauss(void)
+{
+    double u = rng_u01(), v = rng_u01();
+    if (u < 1e-12) u = 1e-12;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * 3.14159265358979 * v);
+}
+
+void sim_sensor_points(const sim_pose_t *p, sim_pt_t *left, sim_pt_t *right)
+{
+    double cx = p->x + cos(p->th) * SIM_SENSOR_FWD_MM;
+    double cy = p->y + sin(p->th) * SIM_SENSOR_FWD_MM;
+    double nx = -sin(p->th) * SIM_SENSOR_GAP_MM / 2.0;     // 왼쪽 법선
+    double ny =  cos(p->th) * SIM_SENSOR_GAP_MM / 2.0;
+
+    left->x  = cx + nx;  left->y  = cy + ny;
+    right->x = cx - nx;  right->y = cy - ny;
+}
+
+// 발자국 안 픽셀 평균 → 팔레트 혼합 + 잡음
+static void sample_sensor(int side, sim_pt_t c)
+{
+    double acc[4] = { 0 };
+    int    n = 0;
+    double r = SIM_SENSOR_R_MM, st = SIM_PX_MM / 2.0;
+
+    for (double dy = -r; dy <= r; dy += st)
+    {
+        for (double dx = -r; dx <= r; dx += st)
+        {
+            if (dx * dx + dy * dy > r * r)
+                continue;
+            uint8_t v   = sim_track_px(s_trk, c.x + dx, c.y + dy);
+            color_t cls = (v == SIM_PX_WHITE) ? COLOR_WHITE :
+                          (v == SIM_PX_BLACK) ? COLOR_BLACK : (color_t)(v - SIM_PX_MARK0);
+            for (int k = 0; k < 4; k++)
+                acc[k] += k_palette[cls][k];
+            n++;
+        }
+    }
+
+    uint16_t out[4];
+    for (int k = 0; k < 4; k++)
+    {
+        double x = acc[k] / n * k_side_gain[side];
+        x *= 1.0 + SIM_SENSOR_NOISE * rng_gauss();
+        out[k] = (x < 0) ? 0 : (x > 65535) ? 65535 : (uint16_t)lround(x);
+    }
+    s_meas[side].red   = out[0];
+    s_meas[side].green = out[1];
+    s_meas[side].blue  = out[2];
+    s_meas[side].ir    = out[3];
+}
+
+void sim_hw_init(const sim_track_t *t, uint32_t seed, bool verbose)
+{
+    s_trk     = t;
+    s_verbose = verbose;
+    s_now_us  = 1;
+    s_rng     = 0x9E3779B97F4A7C15ULL ^ seed;
+    s_run     = false;
+    memset(s_wheel, 0, sizeof(s_wheel));
+    s_wheel[0].period = s_wheel[1].period = UINT32_MAX;
+
+    // reference = 팔레트 × 센서 감도 (캘리 결과에 해당)
+    for (int s = 0; s < 2; s++)
+    {
+        for (int c = 0; c < COLOR_COUNT; c++)
+        {
+            reference_entry_t *e = &s_ref[s][c];
+            memset(e, 0, sizeof(*e));
+            e->raw.red_raw   = (uint16_t)lround(k_palette[c][0] * k_side_gain[s]);
+            e->raw.green_raw = (uint16_t)lround(k_palette[c][1] * k_side_gain[s]);
+            e->raw.blue_raw  = (uint16_t)lround(k_palette[c][2] * k_side_gain[s]);
+            e->raw.ir_raw    = (uint16_t)lround(k_palette[c][3] * k_side_gain[s]);
+            e->color  = (color_t)c;
+            e->offset = calculate_brightness(e->raw.red_raw, e->raw.green_raw, e->raw.blue_raw);
+        }
+        color_cls_build(&s_model[s], s_ref[s], COLOR_COUNT);
+        color_chroma_build(&s_chroma[s], s_ref[s], COLOR_COUNT);
+    }
+
+    // 두 센서 변환 위상을 어긋나게 (실제로도 동기화 안 됨)
+    s_meas_us[0] = 0;
+    s_meas_us[1] = SIM_SENSOR_MEAS_US / 3;
+}
+
+static void wheel_step(int side, sim_pose_t *p)
+{
+    double d = s_wheel[side].dir * SIM_MM_PER_STEP;
+
+    p->x += cos(p->th) * d / 2.0;
+    p->y += sin(p->th) * d / 2.0;
+    p->th += (side == 0 ? -d : d) / SIM_TRACK_W_MM;
+}
+
+void sim_hw_tick_10us(sim_pose_t *pose)
+{
+    s_now_us += 10;
+
+    // step_tick_isr: 10µs 해상도, 마지막 스텝 시각 기준 (stepper.c try_advance와 같음)
+    if (s_run)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            wheel_t *w = &s_wheel[i];
+            if (w->dir != 0 && (s_now_us - w->prev_tick) >= w->period)
+            {
+                w->prev_tick = s_now_us;
+                wheel_step(i, pose);
+            }
+        }
+    }
+
+    // BH1749: 변환 끝날 때마다 새 값 (읽기는 항상 마지막 값)
+    sim_pt_t pt[2];
+    sim_sensor_points(pose, &pt[0], &pt[1]);
+    for (int s = 0; s < 2; s++)
+    {
+        if ((s_now_us - s_meas_us[s]) >= SIM_SENSOR_MEAS_US)
+        {
+            s_meas_us[s] = s_now_us;
+            s_meas_seq[s]++;
+            sample_sensor(s, pt[s]);
+        }
+    }
+}
+
+uint32_t sim_hw_now_us(void)
+{
+    return s_now_us;
+}
+
+bool sim_hw_moving(void)
+{
+    return s_run;
+}
+
+
+// ===================== 펌웨어 외부 함수 =====================
+
+uint32_t micros(void)
+{
+    return s_now_us;
+}
+
+uint32_t millis(void)
+{
+    return s_now_us / 1000u;
+}
+
+void delay_ms(uint32_t ms)
+{
+    (void)ms;
+}
+
+void uart_printf(const char *fmt, ...)
+{
+    if (!s_verbose)
+        return;
+
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%9.3f ", s_now_us * 1e-6);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+void step_drive(StepOperation op)
+{
+    switch (op)
+    {
+        case OP_FORWARD:    s_wheel[0].dir = +1; s_wheel[1].dir = +1; break;
+        case OP_REVERSE:    s_wheel[0].dir = -1; s_wheel[1].dir = -1; break;
+        case OP_TURN_LEFT:  s_wheel[0].dir = -1; s_wheel[1].dir = +1; break;
+        case OP_TURN_RIGHT: s_wheel[0].dir = +1; s_wheel[1].dir = -1; break;
+        case OP_NONE:       s_wheel[0].dir =  0; s_wheel[1].dir =  0; break;
+        default:            return;
+    }
+    s_run = true;
+}
+
+void step_drive_ratio(uint16_t left_ticks, uint16_t right_ticks)
+{
+    s_wheel[0].period = left_ticks  ? left_ticks  : 1;
+    s_wheel[1].period = right_ticks ? right_ticks : 1;
+}
+
+void step_set_hold(hold_mode_t mode)
+{
+    (void)mode;
+}
+
+void step_coast_stop(void)
+{
+    s_run = false;
+}
+
+i2c_status_t bh1749_read(uint8_t dev_addr, bh1749_color_data_t *out)
+{
+    *out = s_meas[side_idx(dev_addr)];
+    return I2C_OK;
+}
+
+uint32_t color_frame_seq(uint8_t dev_addr)
+{
+    return s_meas_seq[side_idx(dev_addr)];
+}
+
+bool color_health_usable(uint8_t dev_addr)
+{
+    (void)dev_addr;
+    return true;
+}
+
+const reference_entry_t* color_side_table(uint8_t left_right)
+{
+    return s_ref[side_idx(left_right)];
+}
+
+// color.c와 같은 식
+uint32_t calculate_brightness(uint16_t r, uint16_t g, uint16_t b)
+{
+    return (uint32_t)((218u * r + 732u * g + 74u * b) >> 10);
+}
+
+const char* color_to_string(color_t color)
+{
+    return (color < COLOR_COUNT) ? k_names[color] : "UNKNOWN";
+}
+
+const color_soa_t* color_side_model(uint8_t left_right)
+{
+    return &s_model[side_idx(left_right)];
+}
+
+const color_chroma_soa_t* color_side_chroma(uint8_t left_right)
+{
+    return &s_chroma[side_idx(left_right)];
+}
+
+// 다중 샘플 통계 없음 (팔레트 reference만) → 펌웨어 폴백과 같은 색도 모드
+color_cls_mode_t color_side_cls_mode(uint8_t left_right)
+{
+    (void)left_right;
+    return COLOR_CLS_CHROMA;
+}
+
+color_t color_stats_nearest2(uint8_t side, uint16_t r, uint16_t g, uint16_t b,
+                             int64_t *s1, int64_t *s2)
+{
+    *s1 = *s2 = INT64_MAX;
+    return COLOR_UNKNOWN;
+}
+
+bool color_stats_accept(uint8_t side, color_t cls, int64_t score)
+{
+    return false;
+}
+
+// color.c와 같은 분류 경로 (CCM/LUT/드리프트 없음: 좌우 각자 팔레트 reference)
+color_result_t classify_color_ex(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
+{
+    return color_cls_search(left_right, color_side_cls_mode(left_right), r, g, b, ir);
+}
+
+// color_cls_selftest 링크용 (시뮬레이터에서는 부르지 않음)
+color_t classify_color_float(uint8_t left_right, uint16_t r, uint16_t g, uint16_t b)
+{
+    return color_cls_nearest(color_side_model(left_right), r, g, b, NULL);
+}
+
+void cycles_init(void)
+{
+}
+
+uint32_t cycles(void)
+{
+    return s_now_us;
+}
+
+// ---- flash_kv: 시뮬레이터 실행 동안만 유지되는 RAM 저장소 (자동 튜닝 게인) ----
+
+static uint8_t  s_kv_val[KV_KEY_COUNT][KV_VAL_MAX];
+static uint16_t s_kv_len[KV_KEY_COUNT];
+static bool     s_kv_has[KV_KEY_COUNT];
+
+bool kv_get(kv_key_t key, void *buf, uint16_t size, uint16_t *out_len)
+{
+    if (key >= KV_KEY_COUNT || !s_kv_has[key])
+        return false;
+
+    memcpy(buf, s_kv_val[key], (size < s_kv_len[key]) ? size : s_kv_len[key]);
+    if (out_len)
+        *out_len = s_kv_len[key];
+    return true;
+}
+
+bool kv_put(kv_key_t key, const void *val, uint16_t len)
+{
+    if (key == KV_KEY_NONE || key >= KV_KEY_COUNT || len > KV_VAL_MAX)
+        return false;
+
+    memcpy(s_kv_val[key], val, len);
+    s_kv_len[key] = len;
+    s_kv_has[key] = true;
+    return true;
+}
@@ -0,0 +1,280 @@
+/*
+ * sim_track.c
+ *
+ *  트랙: 거북이 명령(직선/원호)으로 중심선 생성 → 비트맵 래스터화
+ */
+
+
+#include "sim.h"
+
+#include <math.h>
+
+
+#define SAMPLE_MM       2.0
+#define MARGIN_MM       150.0
+#define MARK_LEN_MM     30.0        // 진행 방향 길이
+#define MARK_WID_MM     50.0        // 폭 (양쪽 센서가 다 올라가게 라인보다 넓게)
+
+#define DEG(a)          ((a) * 3.14159265358979 / 180.0)
+
+
+typedef struct
+{
+    sim_pt_t *pts;
+    int       n, cap;
+    double    x, y, th;
+} turtle_t;
+
+
+static void t_push(turtle_t *t)
+{
+    if (t->n == t->cap)
+    {
+        t->cap = t->cap ? t->cap * 2 : 1024;
+        t->pts = realloc(t->pts, (size_t)t->cap * sizeof(sim_pt_t));
+    }
+    t->pts[t->n].x = t->x;
+    t->pts[t->n].y = t->y;
+    t->n++;
+}
+
+static void t_fwd(turtle_t *t, double len)
+{
+    int k = (int)ceil(len / SAMPLE_MM);
+    for (int i = 0; i < k; i++)
+    {
+        t->x += cos(t->th) * len / k;
+        t->y += sin(t->th) * len / k;
+        t_push(t);
+    }
+}
+
+// 반지름 r, 각도 a (+ = 왼쪽)
+static void t_arc(turtle_t *t, double r, double a)
+{
+    int    k  = (int)ceil(r * fabs(a) / SAMPLE_MM);
+    double da = a / k;
+    for (int i = 0; i < k; i++)
+    {
+        // 현(chord) 방향 = 중간 각도
+        double ch = 2.0 * r * sin(fabs(da) / 2.0);
+        t->th += da / 2.0;
+        t->x  += cos(t->th) * ch;
+        t->y  += sin(t->th) * ch;
+        t->th += da / 2.0;
+        t_push(t);
+    }
+}
+
+// 좌우로 흔들리는 직선 구간 (방향/횡변위 0으로 끝남)
+static void t_wave(turtle_t *t, double r, double a, int k)
+{
+    t_arc(t, r, a / 2.0);
+    for (int i = 0; i < k; i++)
+    {
+        t_arc(t, r, -a);
+        t_arc(t, r,  a);
+    }
+    t_arc(t, r, -a);
+    t_arc(t, r, a / 2.0);
+}
+
+static bool make_centerline(turtle_t *t, const char *name)
+{
+    t_push(t);
+
+    if (strcmp(name, "oval") == 0)
+    {
+        t_fwd(t, 800);  t_arc(t, 250, DEG(180));
+        t_fwd(t, 800);  t_arc(t, 250, DEG(180));
+    }
+    else if (strcmp(name, "rrect") == 0)
+    {
+        // 급커브 (R100)
+        t_fwd(t, 1000); t_arc(t, 100, DEG(90));
+        t_fwd(t, 500);  t_arc(t, 100, DEG(90));
+        t_fwd(t, 1000); t_arc(t, 100, DEG(90));
+        t_fwd(t, 500);  t_arc(t, 100, DEG(90));
+    }
+    else if (strcmp(name, "wave") == 0)
+    {
+        // S자 연속(R300) + 반대편 직선
+        double x0 = t->x;
+        t_wave(t, 300, DEG(40), 3);
+        double len = t->x - x0;
+        t_arc(t, 200, DEG(180));
+        t_fwd(t, len);
+        t_arc(t, 200, DEG(180));
+    }
+    else
+    {
+        return false;
+    }
+
+    t->n--;         // 마지막 점 = 시작점 (닫힘)
+    return true;
+}
+
+static void stamp_segment(sim_track_t *t, sim_pt_t a, sim_pt_t b, double hw)
+{
+    double minx = fmin(a.x, b.x) - hw, maxx = fmax(a.x, b.x) + hw;
+    double miny = fmin(a.y, b.y) - hw, maxy = fmax(a.y, b.y) + hw;
+    int    i0 = (int)((minx - t->x0) / SIM_PX_MM), i1 = (int)((maxx - t->x0) / SIM_PX_MM) + 1;
+    int    j0 = (int)((miny - t->y0) / SIM_PX_MM), j1 = (int)((maxy - t->y0) / SIM_PX_MM) + 1;
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double l2 = dx * dx + dy * dy;
+
+    for (int j = j0; j <= j1; j++)
+    {
+        for (int i = i0; i <= i1; i++)
+        {
+            if (i < 0 || j < 0 || i >= t->w || j >= t->h)
+                continue;
+            double px = t->x0 + (i + 0.5) * SIM_PX_MM;
+            double py = t->y0 + (j + 0.5) * SIM_PX_MM;
+            double u  = (l2 > 0) ? ((px - a.x) * dx + (py - a.y) * dy) / l2 : 0;
+            if (u < 0) u = 0;
+            if (u > 1) u = 1;
+            double ex = px - (a.x + u * dx), ey = py - (a.y + u * dy);
+            if (ex * ex + ey * ey <= hw * hw)
+                t->px[(size_t)j * t->w + i] = SIM_PX_BLACK;
+        }
+    }
+}
+
+bool sim_track_build(sim_track_t *t, const char *name)
+{
+    turtle_t tt = { 0 };
+
+    memset(t, 0, sizeof(*t));
+    if (!make_centerline(&tt, name))
+    {
+        free(tt.pts);
+        return false;
+    }
+
+    t->pts = tt.pts;
+    t->n   = tt.n;
+    t->s   = malloc((size_t)t->n * sizeof(double));
+
+    double minx = 1e9, miny = 1e9, maxx = -1e9, maxy = -1e9;
+    for (int i = 0; i < t->n; i++)
+    {
+        t->s[i] = (i == 0) ? 0 : t->s[i - 1] + hypot(t->pts[i].x - t->pts[i - 1].x,
+                                                     t->pts[i].y - t->pts[i - 1].y);
+        minx = fmin(minx, t->pts[i].x);  maxx = fmax(maxx, t->pts[i].x);
+        miny = fmin(miny, t->pts[i].y);  maxy = fmax(maxy, t->pts[i].y);
+    }
+    const sim_pt_t *last = &t->pts[t->n - 1];
+    t->length = t->s[t->n - 1] + hypot(t->pts[0].x - last->x, t->pts[0].y - last->y);
+
+    t->x0 = minx - MARGIN_MM;
+    t->y0 = miny - MARGIN_MM;
+    t->w  = (int)((maxx - minx + 2 * MARGIN_MM) / SIM_PX_MM) + 1;
+    t->h  = (int)((maxy - miny + 2 * MARGIN_MM) / SIM_PX_MM) + 1;
+    t->px = calloc((size_t)t->w * t->h, 1);
+
+    for (int i = 0; i < t->n; i++)
+        stamp_segment(t, t->pts[i], t->pts[(i + 1) % t->n], SIM_LINE_W_MM / 2.0);
+
+    return true;
+}
+
+void sim_track_free(sim_track_t *t)
+{
+    free(t->pts);
+    free(t->s);
+    free(t->px);
+    memset(t, 0, sizeof(*t));
+}
+
+void sim_track_add_mark(sim_track_t *t, double s_mm, color_t c)
+{
+    s_mm = fmod(s_mm, t->length);
+
+    int k = 0;
+    while (k + 1 < t->n && t->s[k + 1] <= s_mm)
+        k++;
+
+    sim_pt_t a = t->pts[k], b = t->pts[(k + 1) % t->n];
+    double   th = atan2(b.y - a.y, b.x - a.x);
+    double   ct = cos(th), st = sin(th);
+    double   r  = hypot(MARK_LEN_MM, MARK_WID_MM) / 2.0;
+
+    for (double v = -r; v <= r; v += SIM_PX_MM / 2)
+    {
+        for (double u = -r; u <= r; u += SIM_PX_MM / 2)
+        {
+            if (fabs(u) > MARK_LEN_MM / 2 || fabs(v) > MARK_WID_MM / 2)
+                continue;
+            double x = a.x + u * ct - v * st;
+            double y = a.y + u * st + v * ct;
+            int    i = (int)((x - t->x0) / SIM_PX_MM);
+            int    j = (int)((y - t->y0) / SIM_PX_MM);
+            if (i >= 0 && j >= 0 && i < t->w && j < t->h)
+                t->px[(size_t)j * t->w + i] = (uint8_t)(SIM_PX_MARK0 + c);
+        }
+    }
+}
+
+uint8_t sim_track_px(const sim_track_t *t, double x, double y)
+{
+    int i = (int)floor((x - t->x0) / SIM_PX_MM);
+    int j = (int)floor((y - t->y0) / SIM_PX_MM);
+
+    if (i < 0 || j < 0 || i >= t->w || j >= t->h)
+        return SIM_PX_WHITE;
+    return t->px[(size_t)j * t->w + i];
+}
+
+sim_pose_t sim_track_start_pose(const sim_track_t *t)
+{
+    sim_pose_t p;
+    double th = atan2(t->pts[1].y - t->pts[0].y, t->pts[1].x - t->pts[0].x);
+
+    // 센서 중간점이 시작점 위
+    p.th = th;
+    p.x  = t->pts[0].x - cos(th) * SIM_SENSOR_FWD_MM;
+    p.y  = t->pts[0].y - sin(th) * SIM_SENSOR_FWD_MM;
+    return p;
+}
+
+int sim_track_nearest(const sim_track_t *t, double x, double y, int hint,
+                      double *xte, double *s)
+{
+    int lo = 0, hi = t->n;
+    if (hint >= 0)
+    {
+        lo = hint - 60;
+        hi = hint + 60;
+    }
+
+    double best = 1e18, best_u = 0;
+    int    best_k = 0;
+    for (int kk = lo; kk < hi; kk++)
+    {
+        int      k = ((kk % t->n) + t->n) % t->n;
+        sim_pt_t a = t->pts[k], b = t->pts[(k + 1) % t->n];
+        double   dx = b.x - a.x, dy = b.y - a.y;
+        double   l2 = dx * dx + dy * dy;
+        double   u  = (l2 > 0) ? ((x - a.x) * dx + (y - a.y) * dy) / l2 : 0;
+        if (u < 0) u = 0;
+        if (u > 1) u = 1;
+        double ex = x - (a.x + u * dx), ey = y - (a.y + u * dy);
+        double d2 = ex * ex + ey * ey;
+        if (d2 < best)
+        {
+            best   = d2;
+            best_k = k;
+            best_u = u;
+        }
+    }
+
+    sim_pt_t a = t->pts[best_k], b = t->pts[(best_k + 1) % t->n];
+    double   seg = hypot(b.x - a.x, b.y - a.y);
+    double   cross = (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+
+    *xte = (cross >= 0) ? sqrt(best) : -sqrt(best);
+    *s   = t->s[best_k] + best_u * seg;
+    return best_k;
+}
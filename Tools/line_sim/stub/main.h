@@ -0,0 +1,33 @@
+/*
+ * main.h (line_sim 호스트 빌드용)
+ *
+ *  Core/Inc/main.h 대신 들어가서 펌웨어 헤더가 쓰는 HAL 타입만 흉내낸다.
+ *  레지스터 접근 코드는 시뮬레이터에 링크하지 않는다.
+ */
+
+#ifndef LINE_SIM_STUB_MAIN_H_
+#define LINE_SIM_STUB_MAIN_H_
+
+
+#include <stdint.h>
+
+
+typedef struct { volatile uint32_t BSRR; } GPIO_TypeDef;
+typedef struct { uint32_t _rsv; } I2C_HandleTypeDef;
+typedef struct { uint32_t _rsv; } TIM_HandleTypeDef;
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+#define FLASH_PAGE_SIZE     0x1000U
+
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void)  { }
+
+
+#endif /* LINE_SIM_STUB_MAIN_H_ */
@@ -4,16 +4,124 @@
  */
 
 #include "i2c.h"
+#include "i2c_emul.h"
 
-#define I2C_TIMEOUT_US    (2000U)   // 간단한 폴링 타임아웃 (필요시 조정)
+typedef struct
+{
+    uint8_t     addr;       // 0 = 빈 슬롯
+    i2c_stats_t st;
+} i2c_stats_slot_t;
+
+static i2c_stats_slot_t s_stats[I2C_STATS_MAX_DEV];
+
+static i2c_stats_t* stats_slot(uint8_t slave_addr)
+{
+    for (uint32_t i = 0; i < I2C_STATS_MAX_DEV; i++)
+    {
+        if (s_stats[i].addr == slave_addr)
+            return &s_stats[i].st;
+    }
+    for (uint32_t i = 0; i < I2C_STATS_MAX_DEV; i++)
+    {
+        if (s_stats[i].addr == 0)
+        {
+            s_stats[i].addr = slave_addr;
+            return &s_stats[i].st;
+        }
+    }
+    return NULL;    // 슬롯 부족 → 통계만 생략
+}
+
+#if (_USE_I2C_EMUL == 1)
+// 에뮬레이터: 레지스터 모델로 바로 넘긴다 (I2C1/GPIOB/RCC 접근 없음 → 호스트 빌드 가능)
+
+void i2c_init(void)
+{
+    i2c_emul_init();
+}
+
+void i2c_bus_recover(void)
+{
+}
+
+static void i2c_abort(i2c_status_t st, i2c_stats_t *ps)
+{
+    if (st != I2C_ERR_NACK && ps)
+        ps->recover_cnt++;
+}
+
+static i2c_status_t xfer_once(uint8_t slave_addr, uint8_t reg_addr,
+                              const uint8_t *wr, uint8_t *rd, uint8_t len)
+{
+    return i2c_emul_xfer(slave_addr, reg_addr, wr, rd, len);
+}
+
+#else
 
 // HSI16(16 MHz) 기반 100 kHz TIMINGR (표준모드)
 // CubeMX에서 흔히 나오는 값. 클럭 변경 시 반드시 재계산!
 #define I2C_TIMINGR_100K_HSI16   (0x00303D5BUL)
 
-static inline void busy_wait(volatile uint32_t cnt)
+#define I2C_SCL_PIN              8U
+#define I2C_SDA_PIN              9U
+#define I2C_RECOVER_HALF_US      5U         // 복구 클럭 반주기(≈100 kHz)
+
+#define I2C_ICR_ALL              (I2C_ICR_STOPCF | I2C_ICR_NACKCF | I2C_ICR_BERRCF | I2C_ICR_ARLOCF)
+
+static inline void delay_us(uint32_t us)
 {
-    while (cnt--) __NOP();
+    uint32_t t0 = micros();
+    while ((uint32_t)(micros() - t0) < us) { __NOP(); }
+}
+
+// I2C1 리셋 후 타이밍/필터 설정 + Enable (init/복구 공용)
+static void i2c_periph_config(void)
+{
+    RCC->APB1RSTR1 |=  RCC_APB1RSTR1_I2C1RST;
+    RCC->APB1RSTR1 &= ~RCC_APB1RSTR1_I2C1RST;
+
+    // I2C1 Disable 후 타이밍/필터 설정
+    I2C1->CR1 &= ~I2C_CR1_PE;
+
+    // 아날로그 필터 ON(기본), 디지털필터 0 클럭
+    I2C1->CR1 &= ~I2C_CR1_ANFOFF;
+    I2C1->CR1 &= ~I2C_CR1_DNF;
+
+    // TIMINGR 설정 (100 kHz @ HSI16)
+    I2C1->TIMINGR = I2C_TIMINGR_100K_HSI16;
+
+    // I2C Enable
+    I2C1->CR1 |= I2C_CR1_PE;
+}
+
+static inline void pins_to_af(void)
+{
+    // MODER: AF(10)
+    GPIOB->MODER &= ~((3U << (I2C_SCL_PIN * 2)) | (3U << (I2C_SDA_PIN * 2)));
+    GPIOB->MODER |=  ((2U << (I2C_SCL_PIN * 2)) | (2U << (I2C_SDA_PIN * 2)));
+}
+
+static inline void pins_to_gpio_od(void)
+{
+    // 출력 전에 High(릴리즈)로 래치 → OTYPER는 이미 Open-drain
+    GPIOB->BSRR   = (1U << I2C_SCL_PIN) | (1U << I2C_SDA_PIN);
+    GPIOB->MODER &= ~((3U << (I2C_SCL_PIN * 2)) | (3U << (I2C_SDA_PIN * 2)));
+    GPIOB->MODER |=  ((1U << (I2C_SCL_PIN * 2)) | (1U << (I2C_SDA_PIN * 2)));
+}
+
+static inline void scl_write(bool high)
+{
+    GPIOB->BSRR = high ? (1U << I2C_SCL_PIN) : (1U << (I2C_SCL_PIN + 16));
+}
+
+static inline void sda_write(bool high)
+{
+    GPIOB->BSRR = high ? (1U << I2C_SDA_PIN) : (1U << (I2C_SDA_PIN + 16));
+}
+
+static inline bool sda_read(void)
+{
+    return (GPIOB->IDR & (1U << I2C_SDA_PIN)) != 0;
 }
 
 void i2c_init(void)
@@ -53,99 +161,264 @@ void i2c_init(void)
     // 4) I2C1 클럭 Enable
     RCC->APB1ENR1 |= RCC_APB1ENR1_I2C1EN;
 
-    // (선택) I2C1 리셋
-    RCC->APB1RSTR1 |=  RCC_APB1RSTR1_I2C1RST;
-    RCC->APB1RSTR1 &= ~RCC_APB1RSTR1_I2C1RST;
+    // 5) 리셋 + 타이밍/필터 설정 + Enable
+    i2c_periph_config();
+
+    // 6) 전원 인가 시 슬레이브가 SDA를 잡고 있으면 먼저 풀어준다
+    if ((GPIOB->IDR & (1U << I2C_SDA_PIN)) == 0)
+    {
+        i2c_bus_recover();
+    }
+}
 
-    // 5) I2C1 Disable 후 타이밍/필터 설정
+void i2c_bus_recover(void)
+{
     I2C1->CR1 &= ~I2C_CR1_PE;
+    pins_to_gpio_od();
+    delay_us(I2C_RECOVER_HALF_US);
 
-    // 아날로그 필터 ON(기본), 디지털필터 0 클럭
-    I2C1->CR1 &= ~I2C_CR1_ANFOFF;
-    I2C1->CR1 &= ~I2C_CR1_DNF;
+    // 최대 9클럭: 슬레이브가 남은 비트를 밀어내고 SDA를 놓을 때까지
+    for (uint32_t i = 0; i < 9U; i++)
+    {
+        if (sda_read())
+            break;
+        scl_write(false);
+        delay_us(I2C_RECOVER_HALF_US);
+        scl_write(true);
+        delay_us(I2C_RECOVER_HALF_US);
+    }
 
-    // TIMINGR 설정 (100 kHz @ HSI16)
-    I2C1->TIMINGR = I2C_TIMINGR_100K_HSI16;
+    // STOP: SCL High 상태에서 SDA Low → High
+    scl_write(false);
+    delay_us(I2C_RECOVER_HALF_US);
+    sda_write(false);
+    delay_us(I2C_RECOVER_HALF_US);
+    scl_write(true);
+    delay_us(I2C_RECOVER_HALF_US);
+    sda_write(true);
+    delay_us(I2C_RECOVER_HALF_US);
+
+    pins_to_af();
+    i2c_periph_config();
+}
 
-    // 6) I2C Enable
-    I2C1->CR1 |= I2C_CR1_PE;
+// 플래그 대기: 성공/NACK/버스에러/타임아웃을 구분해서 돌려준다
+static i2c_status_t i2c_wait_flag(uint32_t mask)
+{
+    uint32_t t0 = micros();
+    while (1)
+    {
+        uint32_t v = I2C1->ISR;
+        if (v & I2C_ISR_NACKF)
+            return I2C_ERR_NACK;
+        if (v & (I2C_ISR_BERR | I2C_ISR_ARLO))
+            return I2C_ERR_BUS;
+        if (v & mask)
+            return I2C_OK;
+        if ((uint32_t)(micros() - t0) >= I2C_FLAG_TIMEOUT_US)
+            return I2C_ERR_TIMEOUT;
+    }
 }
 
-static bool i2c_wait_flag(volatile uint32_t *reg, uint32_t mask, bool set)
+// 에러 후 정리: NACK이면 STOP 마무리, 그 외(타임아웃/버스에러)는 복구 시퀀스
+static void i2c_abort(i2c_status_t st, i2c_stats_t *ps)
 {
-    uint32_t t = I2C_TIMEOUT_US;
-    while (t--)
+    if (st == I2C_ERR_NACK)
+    {
+        // AUTOEND가 아니면 STOP을 직접 발생
+        if ((I2C1->CR2 & I2C_CR2_AUTOEND) == 0)
+            I2C1->CR2 |= I2C_CR2_STOP;
+
+        uint32_t t0 = micros();
+        while ((I2C1->ISR & I2C_ISR_STOPF) == 0)
+        {
+            if ((uint32_t)(micros() - t0) >= I2C_FLAG_TIMEOUT_US)
+            {
+                st = I2C_ERR_TIMEOUT;   // STOP조차 안 나감 → 락업 취급
+                break;
+            }
+        }
+    }
+
+    if (st != I2C_ERR_NACK)
     {
-        uint32_t v = *reg;
-        if (set ? (v & mask) : !(v & mask))
-            return true;
-        // 대충 1us 정도 기다리기 (코어 클럭에 따라 조절)
-        busy_wait(50);
+        i2c_bus_recover();
+        if (ps) ps->recover_cnt++;
     }
-    return false;
+
+    // TXDR 플러시 + 플래그 정리
+    I2C1->ISR = I2C_ISR_TXE;
+    I2C1->ICR = I2C_ICR_ALL;
 }
 
-void i2c_write(uint8_t slave_addr, uint8_t reg_addr, uint8_t data)
+static i2c_status_t xfer_once(uint8_t slave_addr, uint8_t reg_addr,
+                              const uint8_t *wr, uint8_t *rd, uint8_t len)
 {
-    // 준비: STOP/ERR 플래그 클리어
-    I2C1->ICR = I2C_ICR_STOPCF | I2C_ICR_NACKCF | I2C_ICR_BERRCF;
+    i2c_status_t st;
 
-    // CR2를 한 번에 구성: SADD, NBYTES=2, Write, START, AUTOEND
-    uint32_t cr2 =
-        ((uint32_t)(slave_addr << 1) << I2C_CR2_SADD_Pos) |
-        (2U << I2C_CR2_NBYTES_Pos) |
-        I2C_CR2_AUTOEND |
-        I2C_CR2_START; // RD_WRN=0(Write)
-    I2C1->CR2 = cr2;
+    // 준비: STOP/ERR 플래그 클리어
+    I2C1->ICR = I2C_ICR_ALL;
 
-    // TXIS 대기 후 레지스터 주소
-    if (!i2c_wait_flag(&I2C1->ISR, I2C_ISR_TXIS, true)) return;
-    I2C1->TXDR = reg_addr;
+    // 이전 트랜잭션이 버스를 잡고 있으면 대기(한계 초과 시 stuck)
+    uint32_t t0 = micros();
+    while (I2C1->ISR & I2C_ISR_BUSY)
+    {
+        if ((uint32_t)(micros() - t0) >= I2C_FLAG_TIMEOUT_US)
+            return I2C_ERR_BUSY;
+    }
 
-    // TXIS 대기 후 데이터
-    if (!i2c_wait_flag(&I2C1->ISR, I2C_ISR_TXIS, true)) return;
-    I2C1->TXDR = data;
+    if (wr)
+    {
+        // CR2를 한 번에 구성: SADD, NBYTES=1+len, Write, START, AUTOEND
+        I2C1->CR2 =
+            ((uint32_t)(slave_addr << 1) << I2C_CR2_SADD_Pos) |
+            ((uint32_t)(1U + len) << I2C_CR2_NBYTES_Pos) |
+            I2C_CR2_AUTOEND |
+            I2C_CR2_START; // RD_WRN=0(Write)
+
+        if ((st = i2c_wait_flag(I2C_ISR_TXIS)) != I2C_OK) return st;
+        I2C1->TXDR = reg_addr;
+
+        for (uint8_t i = 0; i < len; i++)
+        {
+            if ((st = i2c_wait_flag(I2C_ISR_TXIS)) != I2C_OK) return st;
+            I2C1->TXDR = wr[i];
+        }
+    }
+    else
+    {
+        // 1) Write phase: sub-address(레지스터) 전송 (AUTOEND 없이 START만)
+        I2C1->CR2 =
+            ((uint32_t)(slave_addr << 1) << I2C_CR2_SADD_Pos) |
+            (1U << I2C_CR2_NBYTES_Pos) |
+            I2C_CR2_START; // RD_WRN=0
+
+        if ((st = i2c_wait_flag(I2C_ISR_TXIS)) != I2C_OK) return st;
+        I2C1->TXDR = reg_addr;
+
+        // 전송 완료(TC) 대기
+        if ((st = i2c_wait_flag(I2C_ISR_TC)) != I2C_OK) return st;
+
+        // 2) Read phase: len바이트 연속 읽기 (레지스터 자동증가, AUTOEND로 자동 STOP)
+        I2C1->CR2 =
+            ((uint32_t)(slave_addr << 1) << I2C_CR2_SADD_Pos) |
+            ((uint32_t)len << I2C_CR2_NBYTES_Pos) |
+            I2C_CR2_RD_WRN |
+            I2C_CR2_START |
+            I2C_CR2_AUTOEND;
+
+        for (uint8_t i = 0; i < len; i++)
+        {
+            if ((st = i2c_wait_flag(I2C_ISR_RXNE)) != I2C_OK) return st;
+            rd[i] = (uint8_t)I2C1->RXDR;
+        }
+    }
 
     // STOPF 대기 및 클리어
-    if (!i2c_wait_flag(&I2C1->ISR, I2C_ISR_STOPF, true)) return;
+    if ((st = i2c_wait_flag(I2C_ISR_STOPF)) != I2C_OK) return st;
     I2C1->ICR = I2C_ICR_STOPCF;
+
+    return I2C_OK;
+}
+
+#endif /* _USE_I2C_EMUL */
+
+static i2c_status_t xfer(uint8_t slave_addr, uint8_t reg_addr,
+                         const uint8_t *wr, uint8_t *rd, uint8_t len)
+{
+    i2c_stats_t *ps = stats_slot(slave_addr);
+    uint32_t     t0 = micros();
+    i2c_status_t st = I2C_OK;
+
+    for (uint32_t attempt = 0; attempt <= I2C_RETRY_MAX; attempt++)
+    {
+        if (attempt && ps) ps->retry_cnt++;
+
+        st = xfer_once(slave_addr, reg_addr, wr, rd, len);
+        if (ps) ps->xfer_cnt++;
+        if (st == I2C_OK)
+            break;
+
+        if (ps)
+        {
+            if (st == I2C_ERR_NACK)         ps->nack_cnt++;
+            else if (st == I2C_ERR_BUS)     ps->bus_err_cnt++;
+            else                            ps->timeout_cnt++;
+        }
+        i2c_abort(st, ps);
+    }
+
+    if (ps)
+    {
+        uint32_t us = (uint32_t)(micros() - t0);
+        if (us > 0xFFFFU) us = 0xFFFFU;
+        ps->last_us = (uint16_t)us;
+        if (ps->last_us > ps->max_us) ps->max_us = ps->last_us;
+        if (st != I2C_OK)
+        {
+            ps->err_cnt++;
+            ps->last_err = st;
+        }
+    }
+
+    return st;
+}
+
+i2c_status_t i2c_write_reg(uint8_t slave_addr, uint8_t reg_addr, uint8_t data)
+{
+    return xfer(slave_addr, reg_addr, &data, NULL, 1);
+}
+
+i2c_status_t i2c_read_regs(uint8_t slave_addr, uint8_t reg_addr, uint8_t *buf, uint8_t len)
+{
+    if (buf == NULL || len == 0)
+        return I2C_ERR_PARAM;
+
+    i2c_status_t st = xfer(slave_addr, reg_addr, NULL, buf, len);
+    if (st != I2C_OK)
+        memset(buf, 0, len);
+    return st;
+}
+
+void i2c_write(uint8_t slave_addr, uint8_t reg_addr, uint8_t data)
+{
+    (void)i2c_write_reg(slave_addr, reg_addr, data);
 }
 
 uint8_t i2c_read(uint8_t slave_addr, uint8_t reg_addr)
 {
     uint8_t data = 0;
+    (void)i2c_read_regs(slave_addr, reg_addr, &data, 1);
+    return data;
+}
 
-    // 준비: STOP/ERR 플래그 클리어
-    I2C1->ICR = I2C_ICR_STOPCF | I2C_ICR_NACKCF | I2C_ICR_BERRCF;
-
-    // 1) Write phase: sub-address(레지스터) 전송 (AUTOEND 없이 START만)
-    uint32_t cr2_w =
-        ((uint32_t)(slave_addr << 1) << I2C_CR2_SADD_Pos) |
-        (1U << I2C_CR2_NBYTES_Pos) |
-        I2C_CR2_START; // RD_WRN=0
-    I2C1->CR2 = cr2_w;
-
-    if (!i2c_wait_flag(&I2C1->ISR, I2C_ISR_TXIS, true)) goto done;
-    I2C1->TXDR = reg_addr;
-
-    // 전송 완료(TC) 대기
-    if (!i2c_wait_flag(&I2C1->ISR, I2C_ISR_TC, true)) goto done;
-
-    // 2) Read phase: 1바이트 읽기 (AUTOEND로 자동 STOP)
-    uint32_t cr2_r =
-        ((uint32_t)(slave_addr << 1) << I2C_CR2_SADD_Pos) |
-        (1U << I2C_CR2_NBYTES_Pos) |
-        I2C_CR2_RD_WRN |
-        I2C_CR2_START |
-        I2C_CR2_AUTOEND;
-    I2C1->CR2 = cr2_r;
-
-    if (!i2c_wait_flag(&I2C1->ISR, I2C_ISR_RXNE, true)) goto done;
-    data = (uint8_t)I2C1->RXDR;
-
-    if (!i2c_wait_flag(&I2C1->ISR, I2C_ISR_STOPF, true)) goto done;
-    I2C1->ICR = I2C_ICR_STOPCF;
+const i2c_stats_t* i2c_get_stats(uint8_t slave_addr)
+{
+    for (uint32_t i = 0; i < I2C_STATS_MAX_DEV; i++)
+    {
+        if (s_stats[i].addr == slave_addr)
+            return &s_stats[i].st;
+    }
+    return NULL;
+}
 
-done:
-    return data;
+void i2c_clear_stats(void)
+{
+    for (uint32_t i = 0; i < I2C_STATS_MAX_DEV; i++)
+    {
+        memset(&s_stats[i].st, 0, sizeof(s_stats[i].st));
+    }
+}
+
+const char* i2c_status_str(i2c_status_t st)
+{
+    switch (st)
+    {
+        case I2C_OK:          return "OK";
+        case I2C_ERR_NACK:    return "NACK";
+        case I2C_ERR_TIMEOUT: return "TIMEOUT";
+        case I2C_ERR_BUS:     return "BUS";
+        case I2C_ERR_BUSY:    return "BUSY";
+        default:              return "PARAM";
+    }
 }
@@ -14,9 +14,58 @@
 #include "def.h"
 
 
+// 1 = 실제 I2C1 대신 BH1749 레지스터 모델(i2c_emul.c)로 트랜잭션 처리
+#ifndef _USE_I2C_EMUL
+#define _USE_I2C_EMUL           0
+#endif
+
+// 플래그 1개당 대기 한계(us). 100 kHz에서 1바이트 ≈ 90us
+#define I2C_FLAG_TIMEOUT_US     200U
+// NACK/락업 후 재시도 횟수 (0이면 재시도 없음)
+#define I2C_RETRY_MAX           1U
+// 통계 슬롯(디바이스 주소별)
+#define I2C_STATS_MAX_DEV       4U
+
+
+typedef enum
+{
+    I2C_OK = 0,
+    I2C_ERR_NACK,       // 주소/데이터 NACK
+    I2C_ERR_TIMEOUT,    // 플래그 대기 초과(클럭 스트레칭/락업)
+    I2C_ERR_BUS,        // BERR/ARLO
+    I2C_ERR_BUSY,       // 시작 전 버스 점유(SDA stuck)
+    I2C_ERR_PARAM
+} i2c_status_t;
+
+typedef struct
+{
+    uint32_t     xfer_cnt;      // 트랜잭션 시도 횟수
+    uint32_t     err_cnt;       // 최종 실패 횟수(재시도 후)
+    uint32_t     nack_cnt;
+    uint32_t     timeout_cnt;
+    uint32_t     bus_err_cnt;
+    uint32_t     retry_cnt;
+    uint32_t     recover_cnt;   // 9클럭 복구 + 페리페럴 리셋 횟수
+    uint16_t     last_us;       // 마지막 트랜잭션 소요(us, 재시도 포함)
+    uint16_t     max_us;
+    i2c_status_t last_err;
+} i2c_stats_t;
+
+
 void i2c_init(void);
 void i2c_write(uint8_t slave_addr, uint8_t reg_addr, uint8_t data);
 uint8_t i2c_read(uint8_t slave_addr, uint8_t reg_addr);
 
+// 상태 코드를 돌려주는 API (신규 코드는 이쪽 사용)
+i2c_status_t i2c_write_reg(uint8_t slave_addr, uint8_t reg_addr, uint8_t data);
+i2c_status_t i2c_read_regs(uint8_t slave_addr, uint8_t reg_addr, uint8_t *buf, uint8_t len);
+
+// SCL 9클럭 + STOP 후 I2C1 리셋/재설정
+void i2c_bus_recover(void);
+
+const i2c_stats_t* i2c_get_stats(uint8_t slave_addr);   // 없으면 NULL
+void               i2c_clear_stats(void);
+const char*        i2c_status_str(i2c_status_t st);
+
 
 #endif /* BSP_I2C_I2C_H_ */
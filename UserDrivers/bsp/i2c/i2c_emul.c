@@ -0,0 +1,391 @@
+/*
+ * i2c_emul.c
+ *
+ *  I2C1 + BH1749NUC 레지스터 모델
+ *   - 0x40..0x5B 레지스터 파일, 주소 자동증가
+ *   - SYSTEM_CONTROL: PART ID(0x0D), SW_RESET
+ *   - MODE_CONTROL1: RGB/IR 게인(x1/x32), 측정시간(35/120/240 ms)
+ *   - MODE_CONTROL2: RGB_EN, VALID(변환 완료 시 Set, 읽으면 Clear)
+ *   - 변환 완료 시점에 장면(또는 CSV 리플레이 행)을 게인/시간에 맞게 스케일해서 래치
+ */
+
+#include "i2c_emul.h"
+
+#if (_USE_I2C_EMUL == 1)
+
+#define EMUL_REG_FIRST          0x40U
+#define EMUL_REG_LAST           0x5BU
+#define EMUL_REG_COUNT          (EMUL_REG_LAST - EMUL_REG_FIRST + 1U)
+
+#define EMUL_PART_ID            0x0DU
+
+// 보드의 BH1749 두 개 (color.h와 동일 값, bsp 계층이라 여기서 따로 정의)
+#define BH1749_EMUL_ADDR_LEFT   0x38U
+#define BH1749_EMUL_ADDR_RIGHT  0x39U
+#define BH1749_EMUL_REG_SYSCTL  0x40U
+#define BH1749_EMUL_REG_MODE1   0x41U
+#define BH1749_EMUL_REG_MODE2   0x42U
+#define BH1749_EMUL_RGB_EN      (1U << 4)
+#define BH1749_EMUL_VALID       (1U << 7)
+#define EMUL_BIT_US             10U     // 100 kHz
+
+typedef struct
+{
+    uint8_t          addr;          // 0 = 미사용
+    uint8_t          regs[EMUL_REG_COUNT];
+    uint32_t         t_start;       // RGB_EN 시각(ms)
+    uint32_t         conv_done;     // t_start 이후 완료된 변환 수
+    uint32_t         conv_total;
+    i2c_emul_scene_t scene;
+    uint16_t         trace_pos;     // 리플레이 탐색 위치(단조 증가)
+    i2c_status_t     fault_st;
+    uint16_t         fault_n;
+} emul_dev_t;
+
+typedef struct
+{
+    uint32_t         t_ms;
+    uint8_t          dev_addr;
+    i2c_emul_scene_t sc;
+} emul_row_t;
+
+static emul_dev_t s_dev[I2C_EMUL_MAX_DEV];
+static emul_row_t s_trace[I2C_EMUL_TRACE_MAX];
+static uint16_t   s_trace_len = 0;
+static uint32_t   s_trace_end = 0;      // 마지막 행 시각(ms)
+static bool       s_replay    = false;
+static bool       s_loop      = false;
+static uint32_t   s_replay_t0 = 0;
+
+
+static emul_dev_t* dev_find(uint8_t addr)
+{
+    for (uint32_t i = 0; i < I2C_EMUL_MAX_DEV; i++)
+    {
+        if (s_dev[i].addr == addr)
+            return &s_dev[i];
+    }
+    return NULL;
+}
+
+static inline uint8_t* reg_ptr(emul_dev_t *d, uint8_t reg)
+{
+    return &d->regs[reg - EMUL_REG_FIRST];
+}
+
+static void dev_reset(emul_dev_t *d)
+{
+    memset(d->regs, 0, sizeof(d->regs));
+    *reg_ptr(d, BH1749_EMUL_REG_SYSCTL) = EMUL_PART_ID;
+    d->t_start   = 0;
+    d->conv_done = 0;
+}
+
+// MODE_CONTROL1 디코드 (데이터시트: [6:5] IR_GAIN, [4:3] RGB_GAIN, [2:0] MEAS_MODE)
+static uint32_t gain_of(uint8_t code)
+{
+    return (code == 0x03U) ? 32U : 1U;     // 01 = x1, 11 = x32, 예약값은 x1로 취급
+}
+
+static uint32_t meas_ms_of(uint8_t mode1)
+{
+    switch (mode1 & 0x07U)
+    {
+        case 0x02U: return 120U;
+        case 0x03U: return 240U;
+        case 0x05U: return 35U;
+        default:    return 0U;             // 금지 값 → 측정 안 함
+    }
+}
+
+static inline void put_u16(emul_dev_t *d, uint8_t lsb_reg, uint32_t v)
+{
+    if (v > 0xFFFFU) v = 0xFFFFU;          // ADC 포화
+    *reg_ptr(d, lsb_reg)     = (uint8_t)(v & 0xFFU);
+    *reg_ptr(d, lsb_reg + 1) = (uint8_t)(v >> 8);
+}
+
+static i2c_emul_scene_t scene_at(emul_dev_t *d, uint32_t t_ms)
+{
+    if (!s_replay || s_trace_len == 0)
+        return d->scene;
+
+    uint32_t rel = (uint32_t)(t_ms - s_replay_t0);
+    if (s_loop)
+    {
+        rel %= (s_trace_end + 1U);
+        if (rel < s_trace[d->trace_pos].t_ms)
+            d->trace_pos = 0;              // 한 바퀴 돌았으면 처음부터 다시 탐색
+    }
+
+    // 이 디바이스의 행 중 t_ms <= rel 인 마지막 행
+    uint16_t pos = d->trace_pos;
+    for (uint16_t i = pos; i < s_trace_len && s_trace[i].t_ms <= rel; i++)
+    {
+        if (s_trace[i].dev_addr == d->addr)
+            pos = i;
+    }
+    d->trace_pos = pos;
+
+    if (s_trace[pos].dev_addr == d->addr && s_trace[pos].t_ms <= rel)
+        d->scene = s_trace[pos].sc;
+    return d->scene;
+}
+
+// 경과 시간만큼 변환을 진행시키고 마지막 변환 결과를 래치
+static void dev_update(emul_dev_t *d)
+{
+    uint8_t  mode1 = *reg_ptr(d, BH1749_EMUL_REG_MODE1);
+    uint8_t  mode2 = *reg_ptr(d, BH1749_EMUL_REG_MODE2);
+    uint32_t meas  = meas_ms_of(mode1);
+
+    if ((mode2 & BH1749_EMUL_RGB_EN) == 0 || meas == 0)
+        return;
+
+    uint32_t n = (uint32_t)(millis() - d->t_start) / meas;
+    if (n <= d->conv_done)
+        return;
+
+    d->conv_total += n - d->conv_done;
+    d->conv_done   = n;
+
+    i2c_emul_scene_t sc = scene_at(d, d->t_start + n * meas);
+    uint32_t g_rgb = gain_of((mode1 >> 3) & 0x03U);
+    uint32_t g_ir  = gain_of((mode1 >> 5) & 0x03U);
+
+    put_u16(d, 0x50, (uint32_t)sc.r  * g_rgb * meas / 35U);
+    put_u16(d, 0x52, (uint32_t)sc.g  * g_rgb * meas / 35U);
+    put_u16(d, 0x54, (uint32_t)sc.b  * g_rgb * meas / 35U);
+    put_u16(d, 0x58, (uint32_t)sc.ir * g_ir  * meas / 35U);
+    put_u16(d, 0x5A, (uint32_t)sc.g  * g_rgb * meas / 35U);
+
+    *reg_ptr(d, BH1749_EMUL_REG_MODE2) |= BH1749_EMUL_VALID;
+}
+
+static void reg_write(emul_dev_t *d, uint8_t reg, uint8_t v)
+{
+    if (reg < EMUL_REG_FIRST || reg > EMUL_REG_LAST)
+        return;
+
+    switch (reg)
+    {
+        case BH1749_EMUL_REG_SYSCTL:
+            if (v & 0x80U)
+                dev_reset(d);              // SW_RESET
+            break;
+
+        case BH1749_EMUL_REG_MODE1:
+            *reg_ptr(d, reg) = v & 0x7FU;
+            d->t_start   = millis();       // 설정 변경 → 측정 재시작
+            d->conv_done = 0;
+            break;
+
+        case BH1749_EMUL_REG_MODE2:
+        {
+            uint8_t old = *reg_ptr(d, reg);
+            *reg_ptr(d, reg) = (uint8_t)((old & BH1749_EMUL_VALID) | (v & BH1749_EMUL_RGB_EN));
+            if ((v & BH1749_EMUL_RGB_EN) && !(old & BH1749_EMUL_RGB_EN))
+            {
+                d->t_start   = millis();
+                d->conv_done = 0;
+            }
+            break;
+        }
+
+        default:
+            if (reg < 0x50U)               // 데이터 레지스터는 읽기 전용
+                *reg_ptr(d, reg) = v;
+            break;
+    }
+}
+
+static uint8_t reg_read(emul_dev_t *d, uint8_t reg)
+{
+    if (reg < EMUL_REG_FIRST || reg > EMUL_REG_LAST)
+        return 0;
+
+    uint8_t v = *reg_ptr(d, reg);
+    if (reg == BH1749_EMUL_REG_MODE2)
+        *reg_ptr(d, reg) &= (uint8_t)~BH1749_EMUL_VALID;   // 읽으면 VALID Clear
+    return v;
+}
+
+static void bus_time(uint32_t frames)
+{
+#if (I2C_EMUL_REALTIME == 1)
+    // 프레임당 9비트 + START/STOP 여유
+    uint32_t us = (frames * 9U + 3U) * EMUL_BIT_US;
+    uint32_t t0 = micros();
+    while ((uint32_t)(micros() - t0) < us) { }
+#else
+    (void)frames;
+#endif
+}
+
+/* ---------------- 공개 API ---------------- */
+
+void i2c_emul_init(void)
+{
+    memset(s_dev, 0, sizeof(s_dev));
+    s_trace_len = 0;
+    s_trace_end = 0;
+    s_replay    = false;
+
+    i2c_emul_attach(BH1749_EMUL_ADDR_LEFT);
+    i2c_emul_attach(BH1749_EMUL_ADDR_RIGHT);
+}
+
+void i2c_emul_attach(uint8_t dev_addr)
+{
+    if (dev_find(dev_addr))
+        return;
+
+    emul_dev_t *d = dev_find(0);
+    if (d == NULL)
+        return;
+
+    memset(d, 0, sizeof(*d));
+    d->addr = dev_addr;
+    dev_reset(d);
+}
+
+i2c_status_t i2c_emul_xfer(uint8_t dev_addr, uint8_t reg_addr,
+                           const uint8_t *wr, uint8_t *rd, uint8_t len)
+{
+    emul_dev_t *d = dev_find(dev_addr);
+
+    if (d == NULL)
+    {
+        bus_time(1);                       // 주소 바이트에서 NACK
+        return I2C_ERR_NACK;
+    }
+
+    if (d->fault_n)
+    {
+        d->fault_n--;
+        bus_time(1);
+        return d->fault_st;
+    }
+
+    if (wr)
+    {
+        bus_time(2U + len);
+        for (uint8_t i = 0; i < len; i++)
+            reg_write(d, (uint8_t)(reg_addr + i), wr[i]);
+    }
+    else
+    {
+        bus_time(3U + len);
+        dev_update(d);
+        for (uint8_t i = 0; i < len; i++)
+            rd[i] = reg_read(d, (uint8_t)(reg_addr + i));
+    }
+
+    return I2C_OK;
+}
+
+void i2c_emul_set_scene(uint8_t dev_addr, i2c_emul_scene_t sc)
+{
+    emul_dev_t *d = dev_find(dev_addr);
+    if (d)
+        d->scene = sc;
+}
+
+static const char* skip_line(const char *p)
+{
+    while (*p && *p != '\n') p++;
+    return (*p == '\n') ? p + 1 : p;
+}
+
+uint16_t i2c_emul_load_csv(const char *text)
+{
+    s_trace_len = 0;
+    s_trace_end = 0;
+
+    const char *p = text;
+    while (p && *p && s_trace_len < I2C_EMUL_TRACE_MAX)
+    {
+        // 헤더/주석/빈 줄은 숫자로 시작하지 않음
+        if (*p < '0' || *p > '9')
+        {
+            p = skip_line(p);
+            continue;
+        }
+
+        char *e;
+        emul_row_t row;
+        row.t_ms = (uint32_t)strtoul(p, &e, 10);
+        if (*e != ',') { p = skip_line(e); continue; }
+        p = e + 1;
+
+        if (*p == 'L' || *p == 'l')       { row.dev_addr = BH1749_EMUL_ADDR_LEFT;  p++; }
+        else if (*p == 'R' || *p == 'r')  { row.dev_addr = BH1749_EMUL_ADDR_RIGHT; p++; }
+        else
+        {
+            uint32_t v = (uint32_t)strtoul(p, &e, 0);
+            row.dev_addr = (v == 0) ? BH1749_EMUL_ADDR_LEFT
+                         : (v == 1) ? BH1749_EMUL_ADDR_RIGHT : (uint8_t)v;
+            p = e;
+        }
+
+        uint16_t *dst[4] = { &row.sc.r, &row.sc.g, &row.sc.b, &row.sc.ir };
+        bool ok = true;
+        for (int i = 0; i < 4; i++)
+        {
+            if (*p != ',') { ok = false; break; }
+            uint32_t v = (uint32_t)strtoul(p + 1, &e, 10);
+            *dst[i] = (uint16_t)((v > 0xFFFFU) ? 0xFFFFU : v);
+            p = e;
+        }
+
+        if (ok)
+        {
+            s_trace[s_trace_len++] = row;
+            if (row.t_ms > s_trace_end) s_trace_end = row.t_ms;
+        }
+        p = skip_line(p);
+    }
+
+    return s_trace_len;
+}
+
+void i2c_emul_replay_start(bool loop)
+{
+    s_replay    = (s_trace_len > 0);
+    s_loop      = loop;
+    s_replay_t0 = millis();
+    for (uint32_t i = 0; i < I2C_EMUL_MAX_DEV; i++)
+        s_dev[i].trace_pos = 0;
+}
+
+void i2c_emul_replay_stop(void)
+{
+    s_replay = false;
+}
+
+bool i2c_emul_replay_done(void)
+{
+    if (!s_replay)
+        return true;
+    if (s_loop)
+        return false;
+    return (uint32_t)(millis() - s_replay_t0) > s_trace_end;
+}
+
+void i2c_emul_inject_fault(uint8_t dev_addr, i2c_status_t st, uint16_t n)
+{
+    emul_dev_t *d = dev_find(dev_addr);
+    if (d)
+    {
+        d->fault_st = st;
+        d->fault_n  = n;
+    }
+}
+
+uint32_t i2c_emul_conversions(uint8_t dev_addr)
+{
+    emul_dev_t *d = dev_find(dev_addr);
+    return d ? d->conv_total : 0;
+}
+
+#endif /* _USE_I2C_EMUL */
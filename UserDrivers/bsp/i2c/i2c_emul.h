@@ -0,0 +1,60 @@
+/*
+ * i2c_emul.h
+ *
+ *  I2C1 + BH1749NUC 레지스터 모델 (센서/카드 없이 색 파이프라인 검증용)
+ *
+ *  _USE_I2C_EMUL = 1 로 빌드하면 i2c.c의 트랜잭션이 실제 I2C1 대신 이 모델로 간다.
+ *  모델은 millis()/micros()만 사용하므로 호스트 빌드에서도 그대로 링크 가능.
+ */
+
+#ifndef BSP_I2C_I2C_EMUL_H_
+#define BSP_I2C_I2C_EMUL_H_
+
+
+#include "def.h"
+#include "i2c.h"
+
+
+#define I2C_EMUL_MAX_DEV        2U
+#define I2C_EMUL_TRACE_MAX      512U    // 리플레이 행 수(양쪽 합계)
+
+// 1 = 트랜잭션마다 100 kHz 버스 시간만큼 실제로 대기 (루프 타이밍 재현)
+#ifndef I2C_EMUL_REALTIME
+#define I2C_EMUL_REALTIME       1
+#endif
+
+
+// 장면 값: x1 게인 / 35 ms 기준 카운트. 게인/적분시간은 모델이 스케일한다
+typedef struct
+{
+    uint16_t r;
+    uint16_t g;
+    uint16_t b;
+    uint16_t ir;
+} i2c_emul_scene_t;
+
+
+void     i2c_emul_init(void);
+void     i2c_emul_attach(uint8_t dev_addr);         // BH1749 한 개 등록 (0x38/0x39)
+
+// I2C 트랜잭션 (i2c.c에서 호출). wr != NULL이면 쓰기, 아니면 rd로 len바이트 읽기
+i2c_status_t i2c_emul_xfer(uint8_t dev_addr, uint8_t reg_addr,
+                           const uint8_t *wr, uint8_t *rd, uint8_t len);
+
+// 정적 장면 지정 (리플레이 중이 아니면 이 값이 다음 변환에 래치됨)
+void     i2c_emul_set_scene(uint8_t dev_addr, i2c_emul_scene_t sc);
+
+// CSV 리플레이: "t_ms,side,r,g,b,ir" (side = L/R 또는 0x38/0x39), '#' 주석/헤더 행 무시
+// 반환: 읽어들인 행 수
+uint16_t i2c_emul_load_csv(const char *text);
+void     i2c_emul_replay_start(bool loop);
+void     i2c_emul_replay_stop(void);
+bool     i2c_emul_replay_done(void);
+
+// 결함 주입: 다음 n번의 트랜잭션을 st로 실패시킴
+void     i2c_emul_inject_fault(uint8_t dev_addr, i2c_status_t st, uint16_t n);
+
+uint32_t i2c_emul_conversions(uint8_t dev_addr);   // 완료된 변환 횟수
+
+
+#endif /* BSP_I2C_I2C_EMUL_H_ */
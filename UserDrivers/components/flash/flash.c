@@ -9,35 +9,6 @@
 #include "flash.h"
 
 
-void flash_write_color_reference(uint8_t sensor_side, uint8_t color_index, reference_entry_t entry)
-{
-    uint32_t base_addr = (sensor_side == BH1749_ADDR_LEFT) ? FLASH_COLOR_TABLE_ADDR_LEFT : FLASH_COLOR_TABLE_ADDR_RIGHT;
-    uint32_t addr = base_addr + color_index * FLASH_COLOR_ENTRY_SIZE;
-
-    HAL_FLASH_Unlock();
-
-    // entry의 RAM 주소를 8바이트씩 건네준다 (포인터)
-    for (size_t i = 0; i < sizeof(entry) / 8; i++)
-    {
-        uint32_t src_ptr = (uint32_t)(uintptr_t)((uint8_t*)&entry + i * 8);  // ✅ 포인터 전달
-        HAL_StatusTypeDef st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr + i * 8, src_ptr);
-        if (st != HAL_OK) break;
-    }
-
-    HAL_FLASH_Lock();
-}
-
-reference_entry_t flash_read_color_reference(uint8_t sensor_side, uint8_t color_index)
-{
-    uint32_t base_addr = (sensor_side == BH1749_ADDR_LEFT) ? FLASH_COLOR_TABLE_ADDR_LEFT : FLASH_COLOR_TABLE_ADDR_RIGHT;
-    uint32_t addr = base_addr + color_index * FLASH_COLOR_ENTRY_SIZE;
-
-    reference_entry_t entry;
-    memcpy(&entry, (void*)addr, FLASH_COLOR_ENTRY_SIZE);
-
-    return entry;
-}
-
 static inline void u375_get_bank_page(uint32_t addr, uint32_t *bank, uint32_t *page)
 {
     const uint32_t SPLIT = 0x08080000UL;      // U375 고정 분기
@@ -50,14 +21,10 @@ static inline void u375_get_bank_page(uint32_t addr, uint32_t *bank, uint32_t *p
     }
 }
 
-void flash_erase_color_table(uint8_t sensor_side)
+bool flash_erase_pages(uint32_t addr, uint32_t nb_pages)
 {
-    uint32_t base = (sensor_side == BH1749_ADDR_LEFT)
-                  ? FLASH_COLOR_TABLE_ADDR_LEFT
-                  : FLASH_COLOR_TABLE_ADDR_RIGHT;
-
     uint32_t bank, page;
-    u375_get_bank_page(base, &bank, &page);
+    u375_get_bank_page(addr, &bank, &page);
 
     FLASH_EraseInitTypeDef ei = {0};
     uint32_t page_error;
@@ -65,10 +32,57 @@ void flash_erase_color_table(uint8_t sensor_side)
     ei.TypeErase = FLASH_TYPEERASE_PAGES;
     ei.Banks     = bank;     // ★ 반드시 지정
     ei.Page      = page;     // ★ 해당 뱅크 기준 페이지
-    ei.NbPages   = 1;
+    ei.NbPages   = nb_pages;
 
     HAL_FLASH_Unlock();
     __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
-    HAL_FLASHEx_Erase(&ei, &page_error);
+    HAL_StatusTypeDef st = HAL_FLASHEx_Erase(&ei, &page_error);
+    HAL_FLASH_Lock();
+
+    return (st == HAL_OK);
+}
+
+bool flash_program(uint32_t addr, const void *src, uint32_t len)
+{
+    if ((addr & 7u) != 0 || (len & 7u) != 0)
+        return false;
+
+    HAL_StatusTypeDef st = HAL_OK;
+
+    HAL_FLASH_Unlock();
+    for (uint32_t i = 0; i < len; i += 8)
+    {
+        st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr + i,
+                               (uint32_t)(uintptr_t)((const uint8_t*)src + i));
+        if (st != HAL_OK) break;
+    }
     HAL_FLASH_Lock();
+
+    return (st == HAL_OK);
+}
+
+uint32_t flash_crc32(uint32_t crc, const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t*)data;
+
+    __HAL_RCC_CRC_CLK_ENABLE();
+    CRC->POL  = 0x04C11DB7UL;
+    CRC->INIT = __RBIT(~crc);                       // 반사 출력/반전의 역 → 이전 상태에서 이어감
+    CRC->CR   = CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1 | CRC_CR_REV_OUT | CRC_CR_RESET;  // 32비트 단위 비트 반전 입력
+
+    while (len >= 4u)
+    {
+        uint32_t w;
+        memcpy(&w, p, 4);
+        CRC->DR = w;
+        p   += 4;
+        len -= 4u;
+    }
+    if (len)
+    {
+        CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT;   // 나머지는 바이트 단위
+        while (len--)
+            *(__IO uint8_t*)&CRC->DR = *p++;
+    }
+    return ~CRC->DR;
 }
@@ -12,13 +12,12 @@
 #include "color.h"
 
 
-#define FLASH_COLOR_TABLE_ADDR_LEFT   ((uint32_t)0x0807F800)               // Page 255
-#define FLASH_COLOR_TABLE_ADDR_RIGHT  ((uint32_t)0x0807F000)               // Page 254 (하나 위)
-#define FLASH_COLOR_ENTRY_SIZE        (sizeof(reference_entry_t))
 
+// 범용: addr이 속한 페이지부터 nb_pages 삭제 / 8바이트 단위 프로그램 (len은 8의 배수)
+bool flash_erase_pages(uint32_t addr, uint32_t nb_pages);
+bool flash_program(uint32_t addr, const void *src, uint32_t len);
 
-void flash_write_color_reference(uint8_t sensor_side, uint8_t color_index, reference_entry_t entry);
-reference_entry_t flash_read_color_reference(uint8_t sensor_side, uint8_t color_index);
-void flash_erase_color_table(uint8_t sensor_side);
+// CRC-32 (zlib crc32()와 같은 값, 하드웨어 CRC 유닛). crc = 이전 결과 (처음엔 0) → 이어서 계산 가능
+uint32_t flash_crc32(uint32_t crc, const void *data, uint32_t len);
 
 #endif /* COMPONENTS_FLASH_FLASH_H_ */
@@ -0,0 +1,341 @@
+/*
+ * flash_kv.c
+ *
+ *  플래시 로그 구조 키-값 저장소
+ */
+
+
+#include "flash_kv.h"
+#include "flash.h"
+#include "uart.h"
+
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t page_seq;      // 활성 페이지가 될 때마다 +1 → 가장 큰 것이 현재 페이지
+    uint32_t _rsv[2];
+} kv_page_hdr_t;
+
+typedef struct
+{
+    uint16_t key;           // 0xFFFF = 빈 곳 (페이지 끝)
+    uint16_t len;           // 0 = 삭제 표시
+    uint32_t seq;
+    uint32_t crc;           // CRC32(key, len, seq + 값)
+    uint32_t _rsv;
+} kv_rec_hdr_t;
+
+typedef struct
+{
+    uint32_t addr;          // 0 = 없음
+    uint32_t seq;
+} kv_slot_t;
+
+#define PAGE_HDR        ((uint32_t)sizeof(kv_page_hdr_t))
+#define REC_HDR         ((uint32_t)sizeof(kv_rec_hdr_t))
+#define ALIGN8(n)       (((uint32_t)(n) + 7u) & ~7u)
+#define REC_SIZE(len)   (REC_HDR + ALIGN8(len))
+
+// 살아있는 레코드 합이 이 이하면 가장 오래된 페이지를 정리할 때 새 페이지 하나에 다 들어간다
+#define LIVE_MAX        (FLASH_PAGE_SIZE - PAGE_HDR - REC_SIZE(KV_VAL_MAX))
+
+static kv_slot_t s_idx[KV_KEY_COUNT];
+static uint32_t  s_seq      = 0;        // 마지막 레코드 seq
+static uint32_t  s_page_seq = 0;
+static uint8_t   s_active   = 0;
+static uint32_t  s_wp       = 0;        // 활성 페이지 쓰기 위치 (절대 주소)
+static uint32_t  s_live     = 0;        // 인덱스가 가리키는 레코드 크기 합
+static bool      s_ready    = false;
+
+static uint8_t   s_buf[REC_HDR + KV_VAL_MAX] __attribute__((aligned(8)));
+
+
+static inline uint32_t page_addr(uint8_t p)
+{
+    return KV_ADDR + (uint32_t)p * FLASH_PAGE_SIZE;
+}
+
+static inline uint32_t page_end(uint8_t p)
+{
+    return page_addr(p) + FLASH_PAGE_SIZE;
+}
+
+static inline const kv_rec_hdr_t* rec_at(uint32_t addr)
+{
+    return (const kv_rec_hdr_t*)(uintptr_t)addr;
+}
+
+static inline uint8_t page_of(uint32_t addr)
+{
+    return (uint8_t)((addr - KV_ADDR) / FLASH_PAGE_SIZE);
+}
+
+static uint32_t rec_crc(const kv_rec_hdr_t *h, const void *val)
+{
+    return flash_crc32(flash_crc32(0, h, 8), val, h->len);     // key, len, seq + 값
+}
+
+static bool page_blank(uint8_t p)
+{
+    const uint32_t *w = (const uint32_t*)(uintptr_t)page_addr(p);
+
+    for (uint32_t i = 0; i < FLASH_PAGE_SIZE / 4u; i++)
+    {
+        if (w[i] != 0xFFFFFFFFUL)
+            return false;
+    }
+    return true;
+}
+
+// 페이지 레코드 → 인덱스. 반환 = 이 페이지의 다음 쓰기 위치 (깨진 레코드면 페이지 끝)
+static uint32_t scan_page(uint8_t p)
+{
+    uint32_t a   = page_addr(p) + PAGE_HDR;
+    uint32_t end = page_end(p);
+
+    while (a + REC_HDR <= end)
+    {
+        const kv_rec_hdr_t *h = rec_at(a);
+
+        if (h->key == 0xFFFFu)
+            return a;
+
+        if (h->key == KV_KEY_NONE || h->key >= KV_KEY_COUNT || h->len > KV_VAL_MAX ||
+            a + REC_SIZE(h->len) > end || rec_crc(h, h + 1) != h->crc)
+        {
+            return end;                             // 쓰다 끊긴 레코드 → 이 페이지는 닫는다
+        }
+
+        kv_slot_t *s = &s_idx[h->key];
+        if (s->addr == 0 || h->seq > s->seq)
+        {
+            s->addr = a;
+            s->seq  = h->seq;
+        }
+        if (h->seq > s_seq)
+            s_seq = h->seq;
+
+        a += REC_SIZE(h->len);
+    }
+    return end;
+}
+
+static bool format_page(uint8_t p)
+{
+    kv_page_hdr_t ph;
+
+    memset(&ph, 0xFF, sizeof(ph));
+    ph.magic    = KV_PAGE_MAGIC;
+    ph.page_seq = s_page_seq + 1u;
+
+    if (!flash_program(page_addr(p), &ph, sizeof(ph)))
+        return false;
+
+    s_page_seq = ph.page_seq;
+    s_active   = p;
+    s_wp       = page_addr(p) + PAGE_HDR;
+    return true;
+}
+
+// 활성 페이지 끝에 레코드 1개
+static bool append(kv_key_t key, const void *val, uint16_t len)
+{
+    uint32_t      need = REC_SIZE(len);
+    kv_rec_hdr_t *h    = (kv_rec_hdr_t*)s_buf;
+
+    if (s_wp + need > page_end(s_active))
+        return false;
+
+    memset(s_buf, 0xFF, need);
+    h->key = (uint16_t)key;
+    h->len = len;
+    h->seq = s_seq + 1u;
+    memcpy(s_buf + REC_HDR, val, len);
+    h->crc = rec_crc(h, val);
+
+    if (!flash_program(s_wp, s_buf, need))
+    {
+        s_wp = page_end(s_active);                  // 일부 기록됐을 수 있음 → 닫음
+        return false;
+    }
+
+    kv_slot_t *s = &s_idx[key];
+    if (s->addr)
+        s_live -= REC_SIZE(rec_at(s->addr)->len);
+    s_live += need;
+
+    s->addr = s_wp;
+    s->seq  = h->seq;
+    s_seq   = h->seq;
+    s_wp   += need;
+    return true;
+}
+
+// 페이지 p의 살아있는 레코드를 활성 페이지로 옮기고 삭제
+static bool gc_page(uint8_t p)
+{
+    for (uint16_t k = KV_KEY_NONE + 1u; k < KV_KEY_COUNT; k++)
+    {
+        kv_slot_t *s = &s_idx[k];
+        if (s->addr == 0 || page_of(s->addr) != p)
+            continue;
+
+        const kv_rec_hdr_t *h = rec_at(s->addr);
+        if (h->len == 0)
+        {
+            // 삭제 표시: 더 오래된 값은 이 페이지에만 있었으므로 같이 버린다
+            s_live -= REC_SIZE(0);
+            s->addr = 0;
+            s->seq  = 0;
+            continue;
+        }
+        if (!append((kv_key_t)k, h + 1, h->len))
+            return false;
+    }
+    return flash_erase_pages(page_addr(p), 1);
+}
+
+// 다음(빈) 페이지로 넘어가고 그 다음(가장 오래된) 페이지 정리 → 빈 페이지 하나 유지
+static bool switch_page(void)
+{
+    uint8_t next = (uint8_t)((s_active + 1u) % KV_PAGES);
+
+    if (!format_page(next))
+        return false;
+    return gc_page((uint8_t)((next + 1u) % KV_PAGES));
+}
+
+bool kv_init(void)
+{
+    bool    valid[KV_PAGES];
+    int     act = -1;
+
+    memset(s_idx, 0, sizeof(s_idx));
+    s_seq = 0;
+    s_page_seq = 0;
+    s_live = 0;
+    s_ready = false;
+
+    for (uint8_t p = 0; p < KV_PAGES; p++)
+    {
+        const kv_page_hdr_t *ph = (const kv_page_hdr_t*)(uintptr_t)page_addr(p);
+
+        valid[p] = (ph->magic == KV_PAGE_MAGIC);
+        if (valid[p])
+        {
+            if (act < 0 || ph->page_seq > s_page_seq)
+            {
+                act        = p;
+                s_page_seq = ph->page_seq;
+            }
+        }
+        else if (!page_blank(p))
+        {
+            flash_erase_pages(page_addr(p), 1);     // 머리 쓰다 끊김 / 다른 데이터
+        }
+    }
+
+    if (act < 0)
+    {
+        if (!format_page(0))
+            return false;
+    }
+    else
+    {
+        for (uint8_t p = 0; p < KV_PAGES; p++)
+        {
+            if (!valid[p])
+                continue;
+            uint32_t wp = scan_page(p);
+            if (p == (uint8_t)act)
+                s_wp = wp;
+        }
+        s_active = (uint8_t)act;
+
+        for (uint16_t k = KV_KEY_NONE + 1u; k < KV_KEY_COUNT; k++)
+        {
+            if (s_idx[k].addr)
+                s_live += REC_SIZE(rec_at(s_idx[k].addr)->len);
+        }
+
+        // 정리 도중 끊겼으면 (활성 다음 페이지가 비어 있지 않음) 마저 정리
+        uint8_t next = (uint8_t)((s_active + 1u) % KV_PAGES);
+        if (valid[next] && next != s_active && !gc_page(next))
+            return false;
+    }
+
+    s_ready = true;
+    return true;
+}
+
+const void* kv_peek(kv_key_t key, uint16_t *out_len)
+{
+    if (!s_ready || key == KV_KEY_NONE || key >= KV_KEY_COUNT || s_idx[key].addr == 0)
+        return NULL;
+
+    const kv_rec_hdr_t *h = rec_at(s_idx[key].addr);
+    if (h->len == 0)
+        return NULL;
+
+    if (out_len) *out_len = h->len;
+    return h + 1;
+}
+
+bool kv_get(kv_key_t key, void *buf, uint16_t size, uint16_t *out_len)
+{
+    uint16_t    len;
+    const void *v = kv_peek(key, &len);
+
+    if (v == NULL)
+        return false;
+
+    memcpy(buf, v, (len < size) ? len : size);
+    if (out_len) *out_len = len;
+    return true;
+}
+
+bool kv_put(kv_key_t key, const void *val, uint16_t len)
+{
+    if (!s_ready || key == KV_KEY_NONE || key >= KV_KEY_COUNT || len > KV_VAL_MAX)
+        return false;
+
+    uint16_t    cur_len = 0;
+    const void *cur = kv_peek(key, &cur_len);
+    if (len != 0 && cur && cur_len == len && memcmp(cur, val, len) == 0)
+        return true;                                // 같은 값 → 쓰기 생략
+
+    uint32_t old  = s_idx[key].addr ? REC_SIZE(rec_at(s_idx[key].addr)->len) : 0u;
+    uint32_t need = REC_SIZE(len);
+    if (s_live - old + need > LIVE_MAX)
+    {
+        uart_printf("[KV] full (live=%lu)\r\n", (unsigned long)s_live);
+        return false;
+    }
+
+    if (s_wp + need > page_end(s_active) && !switch_page())
+        return false;
+
+    return append(key, val, len);
+}
+
+bool kv_delete(kv_key_t key)
+{
+    if (!s_ready || key == KV_KEY_NONE || key >= KV_KEY_COUNT)
+        return false;
+    if (kv_peek(key, NULL) == NULL)
+        return true;
+    return kv_put(key, NULL, 0);
+}
+
+void kv_debug_print(void)
+{
+    uint32_t n = 0;
+    for (uint16_t k = KV_KEY_NONE + 1u; k < KV_KEY_COUNT; k++)
+        n += (kv_peek((kv_key_t)k, NULL) != NULL);
+
+    uart_printf("=== KV (%s) page %u/%u seq=%lu used=%lu/%u live=%lu keys=%lu ===\r\n",
+                s_ready ? "ok" : "not ready", (unsigned)s_active, (unsigned)KV_PAGES,
+                (unsigned long)s_seq, (unsigned long)(s_wp - page_addr(s_active)),
+                (unsigned)FLASH_PAGE_SIZE, (unsigned long)s_live, (unsigned long)n);
+}
@@ -0,0 +1,61 @@
+/*
+ * flash_kv.h
+ *
+ *  플래시 로그 구조 키-값 저장소 (마모 평준화)
+ *
+ *  KV_PAGES개 페이지 링에 레코드를 이어 쓰기만 한다 (제자리 수정/저장마다 삭제 없음).
+ *  - 레코드 = 헤더(key, len, seq, CRC32) + 값. 같은 key는 seq가 가장 큰 것이 유효
+ *  - 부팅 시 한 번 훑어 RAM 인덱스(key → 플래시 주소) 구성 → 조회 O(1), 복사 없이 포인터로도 읽음
+ *  - 활성 페이지가 차면 다음(빈) 페이지로 넘어가고, 그 다음(가장 오래된) 페이지의
+ *    살아있는 레코드만 옮긴 뒤 삭제 → 항상 빈 페이지 하나 유지, 삭제는 링을 돌며 고르게
+ *  - 쓰다 전원이 끊기면 CRC가 안 맞는 레코드에서 그 페이지 읽기를 멈춘다 (이전 값 유지)
+ *  ISR에서 호출 금지 (플래시 프로그램/삭제 중 CPU 정지).
+ */
+
+#ifndef COMPONENTS_FLASH_FLASH_KV_H_
+#define COMPONENTS_FLASH_FLASH_KV_H_
+
+
+#include "def.h"
+#include "color.h"
+
+
+#define KV_ADDR             ((uint32_t)0x080D8000)      // 프로필별 통계 페이지 위, 캘리 A/B 아래
+#define KV_PAGES            4U
+#define KV_PAGE_MAGIC       0x3150564BUL                // "KVP1"
+#define KV_VAL_MAX          1024U                       // 값 최대 길이 (옮기기 여유 확보)
+
+
+// 키 목록 (한 곳에서 관리해 충돌 방지). 값 형식은 각 사용처가 정한다
+typedef enum
+{
+    KV_KEY_NONE = 0,
+
+    KV_KEY_REF_BASE,                                    // 색 reference: rgb_raw_t, [side][color] (이전 형식, 읽기만)
+    KV_KEY_REF_END = KV_KEY_REF_BASE + 2 * COLOR_COUNT,
+
+    KV_KEY_LT_GAINS = KV_KEY_REF_END,                   // 라인트레이싱 자동튜닝 게인
+
+    KV_KEY_COUNT
+} kv_key_t;
+
+#define KV_KEY_REF(side, c)     ((kv_key_t)(KV_KEY_REF_BASE + \
+                                 ((side) == BH1749_ADDR_LEFT ? 0 : COLOR_COUNT) + (c)))
+
+
+// 링 스캔 + 인덱스 구성 (페이지 머리가 깨졌거나 정리 중 끊겼으면 여기서 복구)
+bool        kv_init(void);
+
+// 최신 값 복사. 없으면 false. *out_len = 실제 길이 (buf가 작으면 잘림)
+bool        kv_get(kv_key_t key, void *buf, uint16_t size, uint16_t *out_len);
+// 복사 없이 플래시 주소 반환 (다음 kv_put 전까지 유효), 없으면 NULL
+const void* kv_peek(kv_key_t key, uint16_t *out_len);
+
+// 값이 같으면 쓰지 않는다
+bool        kv_put(kv_key_t key, const void *val, uint16_t len);
+bool        kv_delete(kv_key_t key);
+
+void        kv_debug_print(void);
+
+
+#endif /* COMPONENTS_FLASH_FLASH_KV_H_ */